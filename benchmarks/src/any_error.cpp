@@ -0,0 +1,143 @@
+#include "result/any_error.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 10'000;
+
+struct plugin_error : std::exception {
+  explicit plugin_error(std::int64_t c) : code(c) {}
+  const char *what() const noexcept override { return "plugin_error"; }
+  std::int64_t code;
+};
+
+struct other_error : std::exception {
+  const char *what() const noexcept override { return "other_error"; }
+};
+} // namespace
+
+TEST_CASE("any_error vs exception_ptr vs unique_ptr<exception>",
+          "[benchmark][any_error]") {
+  BENCHMARK("construct any_error") {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      result::any_error e = plugin_error(static_cast<std::int64_t>(i));
+      sum += e.has_value();
+    }
+    return sum;
+  };
+
+  BENCHMARK("construct exception_ptr") {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto e = std::make_exception_ptr(plugin_error(static_cast<std::int64_t>(i)));
+      sum += e != nullptr;
+    }
+    return sum;
+  };
+
+  BENCHMARK("construct unique_ptr<exception>") {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      std::unique_ptr<std::exception> e =
+          std::make_unique<plugin_error>(static_cast<std::int64_t>(i));
+      sum += e != nullptr;
+    }
+    return sum;
+  };
+
+  BENCHMARK_ADVANCED("move any_error")(Catch::Benchmark::Chronometer meter) {
+    std::vector<result::any_error> v(count, plugin_error(1));
+    std::vector<result::any_error> out(count);
+    meter.measure([&] {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = std::move(v[i]);
+        v[i] = std::move(out[i]);
+      }
+      return v.size();
+    });
+  };
+
+  BENCHMARK_ADVANCED("move exception_ptr")(Catch::Benchmark::Chronometer meter) {
+    std::vector<std::exception_ptr> v(count,
+                                      std::make_exception_ptr(plugin_error(1)));
+    std::vector<std::exception_ptr> out(count);
+    meter.measure([&] {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = std::move(v[i]);
+        v[i] = std::move(out[i]);
+      }
+      return v.size();
+    });
+  };
+
+  BENCHMARK_ADVANCED("move unique_ptr<exception>")
+  (Catch::Benchmark::Chronometer meter) {
+    std::vector<std::unique_ptr<std::exception>> v;
+    for (std::size_t i = 0; i < count; ++i) {
+      v.push_back(std::make_unique<plugin_error>(1));
+    }
+    std::vector<std::unique_ptr<std::exception>> out(count);
+    meter.measure([&] {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = std::move(v[i]);
+        v[i] = std::move(out[i]);
+      }
+      return v.size();
+    });
+  };
+
+  std::vector<result::any_error> any_errors;
+  std::vector<std::exception_ptr> exception_ptrs;
+  std::vector<std::unique_ptr<std::exception>> unique_ptrs;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto code = static_cast<std::int64_t>(i);
+    if (i % 2 == 0) {
+      any_errors.emplace_back(plugin_error(code));
+      exception_ptrs.push_back(std::make_exception_ptr(plugin_error(code)));
+      unique_ptrs.push_back(std::make_unique<plugin_error>(code));
+    } else {
+      any_errors.emplace_back(other_error());
+      exception_ptrs.push_back(std::make_exception_ptr(other_error()));
+      unique_ptrs.push_back(std::make_unique<other_error>());
+    }
+  }
+
+  BENCHMARK("downcast any_error::get_if") {
+    std::int64_t sum = 0;
+    for (const auto &e : any_errors) {
+      if (const auto *p = e.get_if<plugin_error>()) {
+        sum += p->code;
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK("downcast exception_ptr rethrow") {
+    std::int64_t sum = 0;
+    for (const auto &e : exception_ptrs) {
+      try {
+        std::rethrow_exception(e);
+      } catch (const plugin_error &p) {
+        sum += p.code;
+      } catch (...) {
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK("downcast unique_ptr<exception> dynamic_cast") {
+    std::int64_t sum = 0;
+    for (const auto &e : unique_ptrs) {
+      if (const auto *p = dynamic_cast<const plugin_error *>(e.get())) {
+        sum += p->code;
+      }
+    }
+    return sum;
+  };
+}
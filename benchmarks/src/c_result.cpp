@@ -0,0 +1,68 @@
+#include "result/c_result.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 1'000'000;
+
+using int64_result = result::result<std::int64_t, std::int32_t>;
+using c_int64_result = result::c_result<std::int64_t, std::int32_t>;
+
+constexpr std::int32_t overflow = 75;
+
+// The marshaling c_result replaces: the value through an out-parameter and
+// the error code as the return value.
+[[gnu::noipa]] std::int32_t multiply_out(std::int64_t a, std::int64_t b,
+                                         std::int64_t *out) {
+  if (__builtin_mul_overflow(a, b, out)) {
+    return overflow;
+  }
+  return 0;
+}
+
+// Returned in rax:rdx.
+[[gnu::noipa]] c_int64_result multiply_c(std::int64_t a, std::int64_t b) {
+  std::int64_t product;
+  if (__builtin_mul_overflow(a, b, &product)) {
+    return result::to_c_result(int64_result(result::err_tag, overflow));
+  }
+  return result::to_c_result(int64_result(result::ok_tag, product));
+}
+
+// One factor in a hundred overflows.
+std::vector<std::int64_t> make_factors() {
+  std::vector<std::int64_t> v(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    v[i] = i % 100 == 99 ? INT64_MAX : static_cast<std::int64_t>(i % 100);
+  }
+  return v;
+}
+} // namespace
+
+TEST_CASE("return a result across a C boundary", "[benchmark][c_result]") {
+  const auto factors = make_factors();
+
+  BENCHMARK("out-parameter and error code") {
+    std::int64_t sum = 0;
+    for (const auto f : factors) {
+      std::int64_t value;
+      const std::int32_t error = multiply_out(3, f, &value);
+      const int64_result r = error == 0
+                                 ? int64_result(result::ok_tag, value)
+                                 : int64_result(result::err_tag, error);
+      sum += r.is_ok() ? r.ok_unchecked() : r.err_unchecked();
+    }
+    return sum;
+  };
+
+  BENCHMARK("c_result in registers") {
+    std::int64_t sum = 0;
+    for (const auto f : factors) {
+      const int64_result r = result::from_c_result(multiply_c(3, f));
+      sum += r.is_ok() ? r.ok_unchecked() : r.err_unchecked();
+    }
+    return sum;
+  };
+}
@@ -0,0 +1,239 @@
+#include "result/channel.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::size_t items = 100'000;
+constexpr std::size_t capacity = 1024;
+constexpr std::size_t batch = 64;
+
+struct record {
+  std::uint64_t id;
+  double value;
+};
+
+enum class parse_error : std::uint8_t { bad_field };
+
+using record_result = result::result<record, parse_error>;
+
+// One record in a hundred fails to parse.
+record_result parse(std::size_t i) {
+  if (i % 100 == 99) {
+    return record_result(result::err_tag, parse_error::bad_field);
+  }
+  return record_result(result::ok_tag, record{i, 0.5});
+}
+
+// The queue channel replaces: a deque behind a mutex, one lock per result.
+class locked_deque {
+public:
+  std::size_t try_push_n(std::span<record_result> rs) {
+    for (auto &r : rs) {
+      const std::lock_guard lock(m_mutex);
+      m_results.push_back(std::move(r));
+    }
+    return rs.size();
+  }
+
+  template <typename O> std::size_t try_pop_n(O out, std::size_t n) {
+    std::size_t popped = 0;
+    for (; popped < n; ++popped) {
+      const std::lock_guard lock(m_mutex);
+      if (m_results.empty()) {
+        break;
+      }
+      *out = std::move(m_results.front());
+      ++out;
+      m_results.pop_front();
+    }
+    return popped;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::deque<record_result> m_results;
+};
+
+template <typename Queue>
+void produce(Queue &q, std::size_t push_batch) {
+  std::vector<record_result> rs;
+  rs.reserve(push_batch);
+  for (std::size_t i = 0; i < items;) {
+    rs.clear();
+    for (; i < items && rs.size() < push_batch; ++i) {
+      rs.push_back(parse(i));
+    }
+    std::span<record_result> pending(rs);
+    while (!pending.empty()) {
+      const std::size_t pushed = q.try_push_n(pending);
+      pending = pending.subspan(pushed);
+      if (pushed == 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+// Pop results until all items are consumed, testing each result.
+template <typename Queue>
+std::uint64_t consume(Queue &q, std::size_t pop_batch,
+                      std::atomic<std::size_t> &consumed) {
+  std::uint64_t sum = 0;
+  std::vector<record_result> rs;
+  rs.reserve(pop_batch);
+  while (consumed.load(std::memory_order_relaxed) < items) {
+    rs.clear();
+    const std::size_t n = q.try_pop_n(std::back_inserter(rs), pop_batch);
+    if (n == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (const auto &r : rs) {
+      sum += r.is_ok() ? r.ok_unchecked().id : 1;
+    }
+    consumed.fetch_add(n, std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+// Drain the ok lane in a loop over plain records, and the error lane only
+// when no ok is ready.
+template <typename Channel>
+std::uint64_t consume_lanes(Channel &ch, std::size_t pop_batch,
+                            std::atomic<std::size_t> &consumed) {
+  std::uint64_t sum = 0;
+  std::array<record, batch> values;
+  std::array<parse_error, batch> errors;
+  while (consumed.load(std::memory_order_relaxed) < items) {
+    std::size_t n = ch.try_pop_ok_n(values.begin(), pop_batch);
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += values[i].id;
+    }
+    if (n == 0) {
+      n = ch.try_pop_err_n(errors.begin(), pop_batch);
+      sum += n;
+    }
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+    consumed.fetch_add(n, std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+// Move items results from the calling thread to consumers threads.
+template <typename Queue, typename Consume>
+std::uint64_t transfer(Queue &q, int consumers, std::size_t n,
+                       Consume consume_n) {
+  std::atomic<std::size_t> consumed = 0;
+  std::atomic<std::uint64_t> sum = 0;
+  {
+    std::vector<std::jthread> threads;
+    for (int c = 0; c < consumers; ++c) {
+      threads.emplace_back([&] { sum += consume_n(q, n, consumed); });
+    }
+    produce(q, n);
+  }
+  return sum;
+}
+
+template <result::channel_mode Mode,
+          result::error_lane Lane = result::error_lane::shared>
+using record_channel = result::channel<record, parse_error, Mode, Lane>;
+
+constexpr auto consume_results = [](auto &q, std::size_t n,
+                                    std::atomic<std::size_t> &consumed) {
+  return consume(q, n, consumed);
+};
+
+constexpr auto consume_by_lane = [](auto &ch, std::size_t n,
+                                    std::atomic<std::size_t> &consumed) {
+  return consume_lanes(ch, n, consumed);
+};
+
+template <result::channel_mode Mode> void throughput(int consumers) {
+  BENCHMARK("mutex and deque") {
+    locked_deque q;
+    return transfer(q, consumers, batch, consume_results);
+  };
+  BENCHMARK("channel, one result at a time") {
+    record_channel<Mode> ch(capacity);
+    return transfer(ch, consumers, 1, consume_results);
+  };
+  BENCHMARK("channel, batches") {
+    record_channel<Mode> ch(capacity);
+    return transfer(ch, consumers, batch, consume_results);
+  };
+  BENCHMARK("channel, batches, separate error lane") {
+    record_channel<Mode, result::error_lane::separate> ch(capacity);
+    return transfer(ch, consumers, batch, consume_by_lane);
+  };
+}
+
+// Send one result to an echo thread and wait for it to come back, rounds
+// times.
+template <typename Queue> std::uint64_t ping_pong(std::size_t rounds) {
+  Queue ping(capacity);
+  Queue pong(capacity);
+  std::jthread echo([&] {
+    std::vector<record_result> rs;
+    for (std::size_t i = 0; i < rounds;) {
+      rs.clear();
+      if (ping.try_pop_n(std::back_inserter(rs), 1) == 0) {
+        std::this_thread::yield();
+        continue;
+      }
+      while (pong.try_push_n(rs) == 0) {
+      }
+      ++i;
+    }
+  });
+  std::uint64_t sum = 0;
+  std::vector<record_result> rs;
+  for (std::size_t i = 0; i < rounds; ++i) {
+    rs.assign(1, parse(i));
+    while (ping.try_push_n(rs) == 0) {
+    }
+    rs.clear();
+    while (pong.try_pop_n(std::back_inserter(rs), 1) == 0) {
+      std::this_thread::yield();
+    }
+    sum += rs.front().is_ok() ? rs.front().ok_unchecked().id : 1;
+  }
+  return sum;
+}
+
+struct sized_locked_deque : locked_deque {
+  explicit sized_locked_deque(std::size_t) {}
+};
+} // namespace
+
+TEST_CASE("channel throughput, 1 producer 1 consumer",
+          "[benchmark][channel]") {
+  throughput<result::channel_mode::spsc>(1);
+}
+
+TEST_CASE("channel throughput, 1 producer 3 consumers",
+          "[benchmark][channel]") {
+  throughput<result::channel_mode::mpmc>(3);
+}
+
+TEST_CASE("channel round trip latency, 1000 rounds",
+          "[benchmark][channel]") {
+  BENCHMARK("mutex and deque") {
+    return ping_pong<sized_locked_deque>(1000);
+  };
+  BENCHMARK("spsc channel") {
+    return ping_pong<record_channel<result::channel_mode::spsc>>(1000);
+  };
+}
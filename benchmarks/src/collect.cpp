@@ -0,0 +1,75 @@
+#include "result/collect.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr std::size_t rows = 1'000'000;
+
+struct reading {
+  std::uint64_t sensor;
+  double value;
+};
+
+enum class field_error : std::uint8_t { missing_sensor, out_of_range };
+
+using row_result = result::result<reading, field_error>;
+
+// Validated rows, with one row in error_every failing validation.
+std::vector<row_result> make_rows(std::size_t error_every) {
+  std::mt19937_64 rng(7);
+  std::vector<row_result> v;
+  v.reserve(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    if (error_every != 0 && rng() % error_every == 0) {
+      v.emplace_back(result::err_tag, field_error::out_of_range);
+    } else {
+      v.emplace_back(result::ok_tag, reading{i, static_cast<double>(i)});
+    }
+  }
+  return v;
+}
+
+// The short-circuiting loop collect_all replaces: stops at the first error
+// and reports only that one.
+result::result<std::vector<reading>, field_error>
+first_error(const std::vector<row_result> &input) {
+  std::vector<reading> values;
+  values.reserve(input.size());
+  for (const auto &r : input) {
+    if (r.is_err()) {
+      return result::result<std::vector<reading>, field_error>(
+          result::err_tag, r.err_unchecked());
+    }
+    values.push_back(r.ok_unchecked());
+  }
+  return result::result<std::vector<reading>, field_error>(result::ok_tag,
+                                                           std::move(values));
+}
+} // namespace
+
+TEST_CASE("validate 1M rows, all valid", "[benchmark][collect]") {
+  const auto input = make_rows(0);
+
+  BENCHMARK("stop at the first error") { return first_error(input); };
+
+  BENCHMARK("collect_all") { return result::collect_all(input); };
+
+  BENCHMARK("collect_all_parallel") {
+    return result::collect_all_parallel(input);
+  };
+}
+
+TEST_CASE("validate 1M rows, 1% invalid", "[benchmark][collect]") {
+  const auto input = make_rows(100);
+
+  BENCHMARK("stop at the first error") { return first_error(input); };
+
+  BENCHMARK("collect_all") { return result::collect_all(input); };
+
+  BENCHMARK("collect_all_parallel") {
+    return result::collect_all_parallel(input);
+  };
+}
@@ -0,0 +1,140 @@
+#include "result/result.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 100'000;
+
+struct parse_error {
+  std::uint32_t offset;
+};
+
+struct io_error {
+  std::int32_t code;
+};
+
+struct auth_error {
+  std::uint16_t user;
+};
+
+// The same pipeline with a class hierarchy, the error is allocated and
+// dispatched through virtual calls.
+struct base_error {
+  virtual ~base_error() = default;
+  virtual std::uint64_t code() const = 0;
+};
+
+struct parse_error_v final : base_error {
+  explicit parse_error_v(std::uint32_t o) : offset(o) {}
+  std::uint64_t code() const override { return offset; }
+  std::uint32_t offset;
+};
+
+struct io_error_v final : base_error {
+  explicit io_error_v(std::int32_t c) : code_(c) {}
+  std::uint64_t code() const override {
+    return static_cast<std::uint64_t>(code_) << 8;
+  }
+  std::int32_t code_;
+};
+
+struct auth_error_v final : base_error {
+  explicit auth_error_v(std::uint16_t u) : user(u) {}
+  std::uint64_t code() const override {
+    return static_cast<std::uint64_t>(user) << 16;
+  }
+  std::uint16_t user;
+};
+
+using poly_result = result::result<std::uint64_t, std::unique_ptr<base_error>>;
+
+result::result<std::uint64_t, parse_error> parse(std::uint64_t x) {
+  if (x % 7 == 0) {
+    return result::err(parse_error{static_cast<std::uint32_t>(x)});
+  }
+  return result::ok(x >> 3);
+}
+
+result::result<std::uint64_t, io_error> load(std::uint64_t x) {
+  if (x % 11 == 0) {
+    return result::err(io_error{static_cast<std::int32_t>(x & 0xff)});
+  }
+  return result::ok(x * 3);
+}
+
+result::result<std::uint64_t, auth_error> authorize(std::uint64_t x) {
+  if (x % 13 == 0) {
+    return result::err(auth_error{static_cast<std::uint16_t>(x)});
+  }
+  return result::ok(x + 1);
+}
+
+poly_result parse_v(std::uint64_t x) {
+  if (x % 7 == 0) {
+    return result::err(std::unique_ptr<base_error>(
+        std::make_unique<parse_error_v>(static_cast<std::uint32_t>(x))));
+  }
+  return result::ok(x >> 3);
+}
+
+poly_result load_v(std::uint64_t x) {
+  if (x % 11 == 0) {
+    return result::err(std::unique_ptr<base_error>(
+        std::make_unique<io_error_v>(static_cast<std::int32_t>(x & 0xff))));
+  }
+  return result::ok(x * 3);
+}
+
+poly_result authorize_v(std::uint64_t x) {
+  if (x % 13 == 0) {
+    return result::err(std::unique_ptr<base_error>(
+        std::make_unique<auth_error_v>(static_cast<std::uint16_t>(x))));
+  }
+  return result::ok(x + 1);
+}
+
+struct error_code {
+  std::uint64_t operator()(const parse_error &e) const { return e.offset; }
+  std::uint64_t operator()(const io_error &e) const {
+    return static_cast<std::uint64_t>(e.code) << 8;
+  }
+  std::uint64_t operator()(const auth_error &e) const {
+    return static_cast<std::uint64_t>(e.user) << 16;
+  }
+};
+
+std::vector<std::uint64_t> make_inputs() {
+  std::mt19937_64 rng(42);
+  std::vector<std::uint64_t> v(count);
+  for (auto &x : v) {
+    x = rng() >> 8;
+  }
+  return v;
+}
+} // namespace
+
+TEST_CASE("error_set vs unique_ptr<base_error>", "[benchmark][error_set]") {
+  const auto inputs = make_inputs();
+
+  BENCHMARK("error_set, and_then + visit") {
+    std::uint64_t sum = 0;
+    for (auto x : inputs) {
+      auto r = parse(x).and_then(load).and_then(authorize);
+      sum += r.is_ok() ? r.ok_unchecked() : r.err_unchecked().visit(error_code{});
+    }
+    return sum;
+  };
+
+  BENCHMARK("unique_ptr<base_error>, and_then + virtual call") {
+    std::uint64_t sum = 0;
+    for (auto x : inputs) {
+      auto r = parse_v(x).and_then(load_v).and_then(authorize_v);
+      sum += r.is_ok() ? r.ok_unchecked() : r.err_unchecked()->code();
+    }
+    return sum;
+  };
+}
@@ -0,0 +1,79 @@
+#include "result/exception.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 100'000;
+
+// Out of line, like a call into a third-party library.
+[[gnu::noinline]] std::int64_t may_throw(std::int64_t v) {
+  if (v < 0) {
+    throw std::invalid_argument("negative");
+  }
+  return v + 1;
+}
+
+[[gnu::noinline]] result::result<std::int64_t, std::error_code>
+may_fail(std::int64_t v) {
+  if (v < 0) {
+    return result::err(std::make_error_code(std::errc::invalid_argument));
+  }
+  return result::ok(v + 1);
+}
+} // namespace
+
+TEST_CASE("exception adapters on the ok path", "[benchmark][exception]") {
+  std::vector<std::int64_t> inputs(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    inputs[i] = static_cast<std::int64_t>(i);
+  }
+
+  BENCHMARK("bare call") {
+    std::int64_t sum = 0;
+    for (auto v : inputs) {
+      sum += may_throw(v);
+    }
+    return sum;
+  };
+
+  BENCHMARK("hand written try/catch") {
+    std::int64_t sum = 0;
+    for (auto v : inputs) {
+      try {
+        sum += may_throw(v);
+      } catch (const std::invalid_argument &) {
+        sum -= 1;
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK("catch_as<std::invalid_argument>") {
+    std::int64_t sum = 0;
+    for (auto v : inputs) {
+      auto r = result::catch_as<std::invalid_argument>(may_throw, v);
+      sum += r.is_ok() ? r.ok_unchecked() : -1;
+    }
+    return sum;
+  };
+
+  BENCHMARK("result without throw_if_err") {
+    std::int64_t sum = 0;
+    for (auto v : inputs) {
+      auto r = may_fail(v);
+      sum += r.is_ok() ? r.ok_unchecked() : -1;
+    }
+    return sum;
+  };
+
+  BENCHMARK("throw_if_err") {
+    std::int64_t sum = 0;
+    for (auto v : inputs) {
+      sum += result::throw_if_err(may_fail(v));
+    }
+    return sum;
+  };
+}
@@ -0,0 +1,52 @@
+#include "fallible_kernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Built without exceptions, like the kernels, so this program doesn't use
+// Catch2: every kernel is run repeatedly and the fastest run is reported.
+
+namespace {
+volatile std::uint64_t sink;
+
+template <typename F> void measure(const std::string &name, F kernel) {
+  using clock = std::chrono::steady_clock;
+  constexpr int runs = 100;
+  auto best = clock::duration::max();
+  for (int i = 0; i < runs; ++i) {
+    const auto start = clock::now();
+    sink = kernel();
+    best = std::min(best, clock::now() - start);
+  }
+  const auto ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(best).count();
+  std::printf("%-40s %12lld ns\n", name.c_str(), static_cast<long long>(ns));
+}
+} // namespace
+
+int main() {
+  std::printf("fill a vector without exceptions\n");
+  for (const std::size_t n : {1'000, 1'000'000}) {
+    const std::string size = std::to_string(n);
+    measure("std::vector, " + size,
+            [n] { return fallible_bench::fill_std_vector(n, false); });
+    measure("try_vector, " + size,
+            [n] { return fallible_bench::fill_try_vector(n, false); });
+    measure("std::vector, reserved, " + size,
+            [n] { return fallible_bench::fill_std_vector(n, true); });
+    measure("try_vector, reserved, " + size,
+            [n] { return fallible_bench::fill_try_vector(n, true); });
+  }
+
+  std::printf("build a string without exceptions\n");
+  for (const std::size_t n : {10, 10'000}) {
+    const std::string size = std::to_string(n);
+    measure("std::string, " + size + " fields",
+            [n] { return fallible_bench::build_std_string(n); });
+    measure("try_string, " + size + " fields",
+            [n] { return fallible_bench::build_try_string(n); });
+  }
+  return 0;
+}
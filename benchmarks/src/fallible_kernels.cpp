@@ -0,0 +1,60 @@
+#include "fallible_kernels.hpp"
+#include "result/fallible.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compiled with -fno-exceptions: std::vector and std::string terminate
+// when an allocation fails, try_vector and try_string return an error.
+
+namespace {
+constexpr std::string_view fields[] = {"GET", "/index.html", "200", "1532",
+                                       "0.004"};
+
+std::string_view field(std::size_t i) noexcept { return fields[i % 5]; }
+} // namespace
+
+namespace fallible_bench {
+std::uint64_t fill_std_vector(std::size_t n, bool reserve) {
+  std::vector<std::uint32_t> v;
+  if (reserve) {
+    v.reserve(n);
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(static_cast<std::uint32_t>(i));
+  }
+  return v.size() + v.back();
+}
+
+std::uint64_t fill_try_vector(std::size_t n, bool reserve) {
+  result::try_vector<std::uint32_t> v;
+  if (reserve && v.try_reserve(n).is_err()) {
+    return 0;
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    if (v.try_push_back(static_cast<std::uint32_t>(i)).is_err()) {
+      return 0;
+    }
+  }
+  return v.size() + v.back();
+}
+
+std::uint64_t build_std_string(std::size_t n) {
+  std::string s;
+  for (std::size_t i = 0; i < n; ++i) {
+    s.append(field(i));
+    s.push_back(' ');
+  }
+  return s.size() + static_cast<unsigned char>(s[n / 2]);
+}
+
+std::uint64_t build_try_string(std::size_t n) {
+  result::try_string s;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (s.try_append(field(i)).is_err() || s.try_push_back(' ').is_err()) {
+      return 0;
+    }
+  }
+  return s.size() + static_cast<unsigned char>(s[n / 2]);
+}
+} // namespace fallible_bench
@@ -0,0 +1,19 @@
+#ifndef RESULT_BENCH_FALLIBLE_KERNELS_HPP
+#define RESULT_BENCH_FALLIBLE_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Loops filling containers, compiled without exceptions in
+// fallible_kernels.cpp. Each returns a checksum of what it built, 0 if an
+// allocation failed.
+namespace fallible_bench {
+std::uint64_t fill_std_vector(std::size_t n, bool reserve);
+std::uint64_t fill_try_vector(std::size_t n, bool reserve);
+
+// Append n fields of a log line, separated by spaces.
+std::uint64_t build_std_string(std::size_t n);
+std::uint64_t build_try_string(std::size_t n);
+} // namespace fallible_bench
+
+#endif // RESULT_BENCH_FALLIBLE_KERNELS_HPP
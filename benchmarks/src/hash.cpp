@@ -0,0 +1,131 @@
+#include "result/result.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+using int_result = result::result<std::int64_t, std::int64_t>;
+using string_result = result::result<std::string, int>;
+
+constexpr std::size_t count = 1'000'000;
+
+// The combination used by std::hash<result<T, E>> before hash_state.
+template <typename T, typename E> struct legacy_hash {
+  std::size_t operator()(const result::result<T, E> &r) const noexcept {
+    std::size_t h1 = r.is_ok() ? 1 : 0;
+    std::size_t h2 = r.is_ok() ? std::hash<T>{}(r.ok_unchecked())
+                               : std::hash<E>{}(r.err_unchecked());
+    return h1 ^ (h2 << 1);
+  }
+};
+
+// Results with keys that are multiples of 4096, ok and err interleaved.
+std::vector<int_result> make_aligned_results() {
+  std::vector<int_result> v;
+  v.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto key = static_cast<std::int64_t>(i / 2) * 4096;
+    if (i % 2 == 0) {
+      v.emplace_back(result::ok_tag, key);
+    } else {
+      v.emplace_back(result::err_tag, key);
+    }
+  }
+  return v;
+}
+
+// Number of values that land in an already occupied bucket of a power of
+// two table with one bucket per value.
+template <typename H>
+std::size_t bucket_collisions(const std::vector<int_result> &v, H hasher) {
+  std::size_t buckets = std::bit_ceil(v.size());
+  std::vector<bool> used(buckets, false);
+  std::size_t collisions = 0;
+  for (const auto &r : v) {
+    const auto b = hasher(r) & (buckets - 1);
+    collisions += used[b] ? 1 : 0;
+    used[b] = true;
+  }
+  return collisions;
+}
+} // namespace
+
+TEST_CASE("hash collision rate", "[benchmark][hash]") {
+  const auto values = make_aligned_results();
+  const auto legacy = bucket_collisions(values, legacy_hash<std::int64_t, std::int64_t>{});
+  const auto mixed = bucket_collisions(values, std::hash<int_result>{});
+  std::cout << "power of two table collisions for " << values.size()
+            << " aligned keys: legacy " << legacy << ", hash_state " << mixed
+            << std::endl;
+  CHECK(mixed < legacy);
+}
+
+TEST_CASE("hash throughput", "[benchmark][hash]") {
+  const auto values = make_aligned_results();
+  std::vector<std::size_t> out(values.size());
+
+  BENCHMARK("legacy std::hash loop") {
+    legacy_hash<std::int64_t, std::int64_t> h;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      out[i] = h(values[i]);
+    }
+    return out.back();
+  };
+
+  BENCHMARK("std::hash loop") {
+    std::hash<int_result> h;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      out[i] = h(values[i]);
+    }
+    return out.back();
+  };
+
+  BENCHMARK("hash_many") {
+    result::hash_many(values, out);
+    return out.back();
+  };
+
+  BENCHMARK("unordered_set insert, legacy hash") {
+    std::unordered_set<int_result, legacy_hash<std::int64_t, std::int64_t>> set;
+    set.reserve(values.size());
+    for (const auto &r : values) {
+      set.insert(r);
+    }
+    return set.size();
+  };
+
+  BENCHMARK("unordered_set insert, std::hash") {
+    std::unordered_set<int_result> set;
+    set.reserve(values.size());
+    for (const auto &r : values) {
+      set.insert(r);
+    }
+    return set.size();
+  };
+}
+
+TEST_CASE("hash throughput, string payload", "[benchmark][hash]") {
+  std::vector<string_result> values;
+  values.reserve(count / 10);
+  for (std::size_t i = 0; i < count / 10; ++i) {
+    values.emplace_back(result::ok_tag, "key_" + std::to_string(i));
+  }
+  std::vector<std::size_t> out(values.size());
+
+  BENCHMARK("legacy std::hash loop") {
+    legacy_hash<std::string, int> h;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      out[i] = h(values[i]);
+    }
+    return out.back();
+  };
+
+  BENCHMARK("hash_many") {
+    result::hash_many(values, out);
+    return out.back();
+  };
+}
@@ -0,0 +1,118 @@
+#include "result/interop.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 10'000;
+
+// A payload whose move is a copy of 256 bytes.
+struct record {
+  std::array<std::uint64_t, 32> words;
+};
+
+record make_record(std::size_t i) {
+  record r{};
+  r.words[0] = i;
+  return r;
+}
+
+using record_result = result::result<record, result::empty_tag_t>;
+
+// Older module, returns results. noipa keeps the calls opaque to the
+// optimizer, as calls into another library would be.
+[[gnu::noipa]] record_result legacy_load(std::size_t i) {
+  if (i % 16 == 0) {
+    return record_result(result::err_tag);
+  }
+  return record_result(result::ok_tag, make_record(i));
+}
+
+// Newer module, returns std::optional.
+[[gnu::noipa]] std::optional<record> modern_load(std::size_t i) {
+  if (i % 16 == 0) {
+    return std::nullopt;
+  }
+  return make_record(i);
+}
+
+#if defined(__cpp_lib_expected)
+using record_expected = std::expected<record, int>;
+
+[[gnu::noipa]] record_expected modern_fetch(std::size_t i) {
+  if (i % 16 == 0) {
+    return std::unexpected(static_cast<int>(i));
+  }
+  return make_record(i);
+}
+#endif
+} // namespace
+
+TEST_CASE("result <-> std::optional", "[benchmark][interop]") {
+  BENCHMARK("optional -> result through ok() wrapper") {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto o = modern_load(i);
+      record_result r = o ? record_result(result::ok(std::move(*o)))
+                          : record_result(result::err(result::empty_tag_t{}));
+      sum += r.is_ok() ? r.ok_unchecked().words[0] : 0;
+    }
+    return sum;
+  };
+
+  BENCHMARK("optional -> result with from_optional") {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto r = result::from_optional(modern_load(i));
+      sum += r.is_ok() ? r.ok_unchecked().words[0] : 0;
+    }
+    return sum;
+  };
+
+  BENCHMARK("result -> optional with to_optional") {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto o = result::to_optional(legacy_load(i));
+      sum += o ? o->words[0] : 0;
+    }
+    return sum;
+  };
+}
+
+#if defined(__cpp_lib_expected)
+TEST_CASE("result <-> std::expected", "[benchmark][interop]") {
+  using int_result = result::result<record, int>;
+
+  BENCHMARK("expected -> result through ok()/err() wrappers") {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto e = modern_fetch(i);
+      int_result r = e ? int_result(result::ok(std::move(*e)))
+                       : int_result(result::err(e.error()));
+      sum += r.is_ok() ? r.ok_unchecked().words[0] : 0;
+    }
+    return sum;
+  };
+
+  BENCHMARK("expected -> result with from_expected") {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto r = result::from_expected(modern_fetch(i));
+      sum += r.is_ok() ? r.ok_unchecked().words[0] : 0;
+    }
+    return sum;
+  };
+
+  BENCHMARK("expected -> result -> expected round trip") {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto e = result::to_expected(result::from_expected(modern_fetch(i)));
+      sum += e ? e->words[0] : 0;
+    }
+    return sum;
+  };
+}
+#endif
@@ -0,0 +1,70 @@
+#include "result/io.hpp"
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::size_t lines = 500'000;
+
+std::string temp_path(const std::string &name) {
+  return (std::filesystem::temp_directory_path() /
+          ("result_bench_" + name + ".txt"))
+      .string();
+}
+
+// A CSV like file of about 16 MiB.
+void write_lines(const std::string &path) {
+  std::ofstream out(path, std::ios::binary);
+  for (std::size_t i = 0; i < lines; ++i) {
+    out << i << ',' << i * 7919 % 100000 << ",some text field\n";
+  }
+}
+
+std::size_t count_lines(const std::byte *first, const std::byte *last) {
+  return static_cast<std::size_t>(std::count(first, last, std::byte('\n')));
+}
+} // namespace
+
+TEST_CASE("scan a 16 MiB file", "[benchmark][io]") {
+  const auto path = temp_path("scan");
+  write_lines(path);
+
+  BENCHMARK("std::ifstream getline") {
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    std::size_t n = 0;
+    while (std::getline(in, line)) {
+      ++n;
+    }
+    return n;
+  };
+
+  BENCHMARK("std::ifstream read 64 KiB blocks") {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> block(64 * 1024);
+    std::size_t n = 0;
+    while (in.read(block.data(), static_cast<std::streamsize>(block.size())) ||
+           in.gcount() > 0) {
+      n += static_cast<std::size_t>(
+          std::count(block.data(), block.data() + in.gcount(), '\n'));
+    }
+    return n;
+  };
+
+  BENCHMARK("result::read_all") {
+    const auto bytes = result::read_all(path.c_str()).unwrap();
+    return count_lines(bytes.data(), bytes.data() + bytes.size());
+  };
+
+  BENCHMARK("result::map_file") {
+    const auto file = result::map_file(path.c_str()).unwrap();
+    return count_lines(file.data(), file.data() + file.size());
+  };
+
+  std::filesystem::remove(path);
+}
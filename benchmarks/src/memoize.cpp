@@ -0,0 +1,112 @@
+#include "result/memoize.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::uint32_t keys = 10'000;
+constexpr std::size_t lookups = 20'000;
+
+enum class lookup_error : std::uint8_t { unknown_host };
+
+using address_result = result::result<std::uint64_t, lookup_error>;
+
+// Stands in for a table lookup worth caching: a couple of microseconds of
+// work, and one key in ten is unknown.
+[[gnu::noipa]] address_result resolve(const std::uint32_t &key) {
+  result::hash_state h(key);
+  for (std::uint64_t i = 0; i < 1024; ++i) {
+    h.append(i);
+  }
+  if (key % 10 == 9) {
+    return address_result(result::err_tag, lookup_error::unknown_host);
+  }
+  return address_result(result::ok_tag, h.finish());
+}
+
+// Keys skewed towards the small ones, as the requests for popular names.
+std::vector<std::uint32_t> make_keys(std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<std::uint32_t> v(lookups);
+  for (auto &k : v) {
+    const double x = u(rng);
+    k = static_cast<std::uint32_t>(x * x * x * keys);
+  }
+  return v;
+}
+
+template <typename F>
+std::uint64_t resolve_all(F &f, const std::vector<std::uint32_t> &input) {
+  std::uint64_t sum = 0;
+  for (const auto key : input) {
+    const auto r = f(key);
+    sum += r.is_ok() ? r.ok_unchecked() : 1;
+  }
+  return sum;
+}
+
+using cached_resolve = result::memoize<decltype(&resolve), std::uint32_t>;
+
+double hit_rate(const cached_resolve &cached) {
+  const auto s = cached.stats();
+  return static_cast<double>(s.hits + s.error_hits + s.shared) /
+         static_cast<double>(s.hits + s.error_hits + s.shared + s.misses);
+}
+} // namespace
+
+TEST_CASE("memoize hit rate", "[benchmark][memoize]") {
+  const auto input = make_keys(1);
+
+  BENCHMARK("no cache") { return resolve_all(resolve, input); };
+
+  for (const std::size_t capacity : {100, 1'000, 10'000}) {
+    result::memoize_options options;
+    options.capacity = capacity;
+    cached_resolve oks_only(&resolve, options);
+    options.error_capacity = capacity / 10;
+    options.error_ttl = std::chrono::hours(1);
+    cached_resolve with_errors(&resolve, options);
+
+    const std::string n = std::to_string(capacity);
+    BENCHMARK("memoize, capacity " + n) {
+      return resolve_all(oks_only, input);
+    };
+    BENCHMARK("memoize, capacity " + n + ", errors cached") {
+      return resolve_all(with_errors, input);
+    };
+    std::cout << "capacity " << capacity << ": hit rate "
+              << hit_rate(oks_only) << ", with errors cached "
+              << hit_rate(with_errors) << std::endl;
+  }
+}
+
+TEST_CASE("memoize contention, 4 threads", "[benchmark][memoize]") {
+  constexpr int threads = 4;
+  std::vector<std::vector<std::uint32_t>> inputs;
+  for (int t = 0; t < threads; ++t) {
+    inputs.push_back(make_keys(static_cast<std::uint64_t>(t)));
+  }
+
+  for (const std::size_t shards : {1, 16}) {
+    result::memoize_options options;
+    options.capacity = keys;
+    options.error_capacity = keys;
+    options.error_ttl = std::chrono::hours(1);
+    options.shards = shards;
+    cached_resolve cached(&resolve, options);
+    resolve_all(cached, inputs.front());
+
+    BENCHMARK("memoize, " + std::to_string(shards) + " shards") {
+      std::vector<std::jthread> workers;
+      for (const auto &input : inputs) {
+        workers.emplace_back([&cached, &input] { resolve_all(cached, input); });
+      }
+    };
+  }
+}
@@ -0,0 +1,92 @@
+#include "result/parse.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 10'000;
+
+// Texts of a column: short counters, epoch milliseconds, 64 bit ids and
+// prices.
+std::vector<std::string> make_texts(int kind) {
+  std::mt19937_64 random(kind);
+  std::vector<std::string> texts;
+  texts.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint64_t word = random();
+    switch (kind) {
+    case 0:
+      texts.push_back(std::to_string(static_cast<std::int64_t>(word % 20000) -
+                                     10000));
+      break;
+    case 1:
+      texts.push_back(std::to_string(1'700'000'000'000 + word % 100'000'000));
+      break;
+    case 2:
+      texts.push_back(std::to_string(word | (1ULL << 63)));
+      break;
+    default:
+      texts.push_back(std::to_string(word % 1'000'000) + "." +
+                      std::to_string(10 + word % 90));
+      break;
+    }
+  }
+  return texts;
+}
+
+// Checked like result::parse: the whole text must be the number.
+template <typename T> T from_chars(const std::string &text) {
+  T value{};
+  const char *last = text.data() + text.size();
+  const auto [end, ec] = std::from_chars(text.data(), last, value);
+  return ec == std::errc() && end == last ? value : T{};
+}
+
+template <typename T> void run(const char *column, int kind) {
+  const auto texts = make_texts(kind);
+  const std::string name(column);
+
+  BENCHMARK(name + ": strto*") {
+    T sum{};
+    for (const auto &text : texts) {
+      if constexpr (std::is_floating_point_v<T>) {
+        sum += std::strtod(text.c_str(), nullptr);
+      } else if constexpr (std::is_signed_v<T>) {
+        sum += std::strtoll(text.c_str(), nullptr, 10);
+      } else {
+        sum += std::strtoull(text.c_str(), nullptr, 10);
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK(name + ": std::from_chars") {
+    T sum{};
+    for (const auto &text : texts) {
+      sum += from_chars<T>(text);
+    }
+    return sum;
+  };
+
+  BENCHMARK(name + ": result::parse") {
+    T sum{};
+    for (const auto &text : texts) {
+      sum += result::parse<T>(text).unwrap_or(T{});
+    }
+    return sum;
+  };
+}
+} // namespace
+
+TEST_CASE("parse 10k numbers", "[benchmark][parse]") {
+  run<std::int64_t>("short int64", 0);
+  run<std::int64_t>("epoch ms int64", 1);
+  run<std::uint64_t>("19 and 20 digit uint64", 2);
+  run<double>("price double", 3);
+}
@@ -0,0 +1,84 @@
+#include "result/pmr.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::size_t batches = 64;
+constexpr std::size_t rows_per_batch = 16;
+
+struct row {
+  std::uint64_t id;
+  double value;
+};
+
+enum class query_error { timeout };
+
+// One request: query a number of batches of rows, keep every batch result
+// and copy the successful ones into the response. Every allocation comes
+// from the allocator of the outer vector.
+template <template <typename> class Vector, typename Alloc>
+std::size_t handle_request(const Alloc &alloc) {
+  using batch_result = result::result<Vector<row>, query_error>;
+  Vector<batch_result> batches_read(alloc);
+  batches_read.reserve(batches);
+  for (std::size_t b = 0; b < batches; ++b) {
+    if (b % 8 == 7) {
+      batches_read.emplace_back(result::err_tag, query_error::timeout);
+      continue;
+    }
+    auto &batch = batches_read.emplace_back(result::ok_tag).ok_unchecked();
+    batch.reserve(rows_per_batch);
+    for (std::size_t i = 0; i < rows_per_batch; ++i) {
+      batch.push_back(row{b * rows_per_batch + i, static_cast<double>(i)});
+    }
+  }
+  Vector<batch_result> response(alloc);
+  response.reserve(batches);
+  for (const auto &batch : batches_read) {
+    if (batch.is_ok()) {
+      response.push_back(batch);
+    }
+  }
+  return response.size();
+}
+
+template <typename T> using std_vector = std::vector<T>;
+
+template <typename T> using pmr_vector = std::pmr::vector<T>;
+
+// Large enough for one request; requests never reach the upstream.
+struct request_arena {
+  alignas(std::max_align_t) std::array<std::byte, 128 * 1024> buffer;
+};
+
+std::size_t handle_request_in(request_arena &arena) {
+  std::pmr::monotonic_buffer_resource resource(
+      arena.buffer.data(), arena.buffer.size(),
+      std::pmr::null_memory_resource());
+  return handle_request<pmr_vector>(
+      std::pmr::polymorphic_allocator<>(&resource));
+}
+} // namespace
+
+TEST_CASE("request with a monotonic resource", "[benchmark][pmr]") {
+  static request_arena arena;
+
+  // Neither the arena nor the default resource may fall back to the heap:
+  // a payload copied with the default resource would throw bad_alloc.
+  auto *previous =
+      std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  REQUIRE(handle_request_in(arena) == batches - batches / 8);
+  std::pmr::set_default_resource(previous);
+
+  BENCHMARK("global heap") {
+    return handle_request<std_vector>(std::allocator<void>());
+  };
+
+  BENCHMARK("monotonic arena") { return handle_request_in(arena); };
+}
@@ -0,0 +1,79 @@
+#include "result/result.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+enum class lookup_error : std::uint8_t { not_found };
+
+struct schema {
+  std::string name;
+  std::vector<std::string> columns;
+};
+
+class schema_cache {
+public:
+  schema_cache() {
+    for (int i = 0; i < 1000; ++i) {
+      schema s{"table_" + std::to_string(i), {}};
+      for (int c = 0; c < 16; ++c) {
+        s.columns.push_back("column_with_a_long_name_" + std::to_string(c));
+      }
+      m_schemas.emplace(s.name, std::move(s));
+    }
+  }
+
+  result::result<schema, lookup_error> find_copy(const std::string &key) const {
+    auto it = m_schemas.find(key);
+    if (it == m_schemas.end()) {
+      return result::result<schema, lookup_error>(result::err_tag,
+                                                  lookup_error::not_found);
+    }
+    return result::result<schema, lookup_error>(result::ok_tag, it->second);
+  }
+
+  result::result<const schema &, lookup_error>
+  find_ref(const std::string &key) const {
+    auto it = m_schemas.find(key);
+    if (it == m_schemas.end()) {
+      return result::result<const schema &, lookup_error>(
+          result::err_tag, lookup_error::not_found);
+    }
+    return result::result<const schema &, lookup_error>(result::ok_tag,
+                                                        it->second);
+  }
+
+private:
+  std::unordered_map<std::string, schema> m_schemas;
+};
+} // namespace
+
+TEST_CASE("lookup returning a copy or a reference",
+          "[benchmark][reference]") {
+  const schema_cache cache;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 10000; ++i) {
+    keys.push_back("table_" + std::to_string((i * 7) % 1100));
+  }
+
+  BENCHMARK("result<schema, E>") {
+    std::size_t columns = 0;
+    for (const auto &key : keys) {
+      auto r = cache.find_copy(key);
+      columns += r.is_ok() ? r.ok_unchecked().columns.size() : 0;
+    }
+    return columns;
+  };
+
+  BENCHMARK("result<const schema &, E>") {
+    std::size_t columns = 0;
+    for (const auto &key : keys) {
+      auto r = cache.find_ref(key);
+      columns += r.is_ok() ? r.ok_unchecked().columns.size() : 0;
+    }
+    return columns;
+  };
+}
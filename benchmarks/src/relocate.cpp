@@ -0,0 +1,130 @@
+#include "result/relocate.hpp"
+#include "result/result.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::size_t count = 100'000;
+
+// A hand written payload: noexcept move constructor, potentially throwing
+// assignments. The copy allocates.
+struct record {
+  explicit record(std::size_t i) : name(64, static_cast<char>('a' + i % 26)) {}
+  record(const record &) = default;
+  record(record &&other) noexcept : name(std::move(other.name)) {}
+  record &operator=(const record &) = default;
+  record &operator=(record &&other) {
+    name = std::move(other.name);
+    return *this;
+  }
+
+  std::string name;
+};
+
+// The same payload as seen through the previous exception specification of
+// result, which derived the move constructor from the move assignment.
+struct record_throwing_move : record {
+  using record::record;
+  record_throwing_move(const record_throwing_move &) = default;
+  record_throwing_move(record_throwing_move &&other) noexcept(false)
+      : record(std::move(other)) {}
+  record_throwing_move &operator=(const record_throwing_move &) = default;
+  record_throwing_move &operator=(record_throwing_move &&) = default;
+};
+
+template <typename T> std::uint64_t grow_vector() {
+  std::vector<result::result<T, int>> v;
+  for (std::size_t i = 0; i < count; ++i) {
+    v.emplace_back(result::ok_tag, i);
+  }
+  return v.size();
+}
+
+// Owns its payload through a pointer: trivially relocatable.
+class handle {
+public:
+  explicit handle(std::size_t v) : m_value(new std::uint64_t(v)) {}
+  handle(handle &&other) noexcept : m_value(other.m_value) {
+    other.m_value = nullptr;
+  }
+  ~handle() { delete m_value; }
+
+  std::uint64_t value() const { return *m_value; }
+
+private:
+  std::uint64_t *m_value;
+};
+
+using handle_result = result::result<handle, int>;
+
+// Minimal growable array that relocates its elements with relocate_n.
+template <typename T> class relocating_array {
+public:
+  relocating_array() = default;
+  relocating_array(const relocating_array &) = delete;
+  relocating_array &operator=(const relocating_array &) = delete;
+  ~relocating_array() {
+    std::destroy_n(m_data, m_size);
+    ::operator delete(m_data);
+  }
+
+  template <typename... Args> void emplace_back(Args &&...args) {
+    if (m_size == m_capacity) {
+      const std::size_t capacity = m_capacity == 0 ? 1 : 2 * m_capacity;
+      T *data = static_cast<T *>(::operator new(capacity * sizeof(T)));
+      result::relocate_n(m_data, m_size, data);
+      ::operator delete(m_data);
+      m_data = data;
+      m_capacity = capacity;
+    }
+    std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+    ++m_size;
+  }
+
+  std::size_t size() const { return m_size; }
+
+private:
+  T *m_data = nullptr;
+  std::size_t m_size = 0;
+  std::size_t m_capacity = 0;
+};
+} // namespace
+
+template <>
+struct result::is_trivially_relocatable<handle> : std::true_type {};
+
+static_assert(std::is_nothrow_move_constructible_v<result::result<record, int>>);
+static_assert(result::is_trivially_relocatable_v<handle_result>);
+
+TEST_CASE("vector<result> growth", "[benchmark][relocate]") {
+  BENCHMARK("noexcept move: vector moves on reallocation") {
+    return grow_vector<record>();
+  };
+
+  BENCHMARK("throwing move: vector copies on reallocation") {
+    return grow_vector<record_throwing_move>();
+  };
+}
+
+TEST_CASE("relocation on growth", "[benchmark][relocate]") {
+  BENCHMARK("std::vector, move and destroy each element") {
+    std::vector<handle_result> v;
+    for (std::size_t i = 0; i < count; ++i) {
+      v.emplace_back(result::ok_tag, i);
+    }
+    return v.size();
+  };
+
+  BENCHMARK("relocate_n, memcpy") {
+    relocating_array<handle_result> v;
+    for (std::size_t i = 0; i < count; ++i) {
+      v.emplace_back(result::ok_tag, i);
+    }
+    return v.size();
+  };
+}
@@ -0,0 +1,112 @@
+#include "result/serialize.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+using result_type = result::result<std::int64_t, std::int32_t>;
+
+constexpr std::size_t count = 1'000'000;
+
+std::string temp_path(const std::string &name) {
+  return (std::filesystem::temp_directory_path() /
+          ("result_bench_" + name + ".bin"))
+      .string();
+}
+
+std::vector<result_type> make_results() {
+  std::vector<result_type> v;
+  v.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i % 16 == 0) {
+      v.emplace_back(result::err_tag, static_cast<std::int32_t>(i));
+    } else {
+      v.emplace_back(result::ok_tag, static_cast<std::int64_t>(i));
+    }
+  }
+  return v;
+}
+
+// Field by field serialization, the way it is done without packed_result.
+void write_per_element(const std::string &path,
+                       const std::vector<result_type> &v) {
+  std::FILE *f = std::fopen(path.c_str(), "wb");
+  for (const auto &r : v) {
+    const std::uint8_t type = r.is_ok() ? 1 : 0;
+    std::fwrite(&type, sizeof(type), 1, f);
+    if (r.is_ok()) {
+      std::fwrite(&r.ok_unchecked(), sizeof(std::int64_t), 1, f);
+    } else {
+      std::fwrite(&r.err_unchecked(), sizeof(std::int32_t), 1, f);
+    }
+  }
+  std::fclose(f);
+}
+
+std::int64_t read_per_element(const std::string &path) {
+  std::FILE *f = std::fopen(path.c_str(), "rb");
+  std::int64_t sum = 0;
+  std::uint8_t type = 0;
+  while (std::fread(&type, sizeof(type), 1, f) == 1) {
+    if (type) {
+      std::int64_t value = 0;
+      std::fread(&value, sizeof(value), 1, f);
+      result_type r(result::ok_tag, value);
+      sum += r.ok_unchecked();
+    } else {
+      std::int32_t value = 0;
+      std::fread(&value, sizeof(value), 1, f);
+      result_type r(result::err_tag, value);
+      sum -= r.err_unchecked();
+    }
+  }
+  std::fclose(f);
+  return sum;
+}
+} // namespace
+
+TEST_CASE("serialize 1M results", "[benchmark][serialize]") {
+  const auto input = make_results();
+  const auto per_element_path = temp_path("per_element");
+  const auto packed_path = temp_path("packed");
+
+  BENCHMARK("per element fwrite") {
+    write_per_element(per_element_path, input);
+  };
+
+  BENCHMARK("result_writer batched") {
+    auto writer = result::result_writer<std::int64_t, std::int32_t>::create(
+                      packed_path.c_str())
+                      .unwrap();
+    writer.write(input);
+    return writer.close().is_ok();
+  };
+
+  write_per_element(per_element_path, input);
+  {
+    auto writer = result::result_writer<std::int64_t, std::int32_t>::create(
+                      packed_path.c_str())
+                      .unwrap();
+    writer.write(input);
+  }
+
+  BENCHMARK("per element fread") { return read_per_element(per_element_path); };
+
+  BENCHMARK("mapped_result_array in place") {
+    auto array = result::mapped_result_array<std::int64_t, std::int32_t>::open(
+                     packed_path.c_str())
+                     .unwrap();
+    std::int64_t sum = 0;
+    for (const auto &p : array) {
+      sum += p.is_ok() ? p.ok_unchecked() : -p.err_unchecked();
+    }
+    return sum;
+  };
+
+  std::filesystem::remove(per_element_path);
+  std::filesystem::remove(packed_path);
+}
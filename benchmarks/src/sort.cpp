@@ -0,0 +1,72 @@
+#include "result/algorithm.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+using int_result = result::result<std::int64_t, std::int32_t>;
+
+constexpr std::size_t count = 1'000'000;
+
+// operator<=> before it read the storage directly: it went through ok() and
+// re-checked the state of both results.
+std::strong_ordering legacy_compare(const int_result &lhs,
+                                    const int_result &rhs) {
+  auto lok = lhs.is_ok() ? 1 : 0;
+  auto rok = rhs.is_ok() ? 1 : 0;
+  if (auto c = lok <=> rok; c != 0)
+    return c;
+  auto lopt = lhs.ok();
+  auto ropt = rhs.ok();
+  lok = lopt.has_value() ? 1 : 0;
+  rok = ropt.has_value() ? 1 : 0;
+  if (lok == rok && lok) {
+    return lopt.value().get() <=> ropt.value().get();
+  }
+  return lok <=> rok;
+}
+
+std::vector<int_result> make_results() {
+  std::mt19937_64 rng(42);
+  std::vector<int_result> v;
+  v.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto x = rng();
+    if (x % 10 == 0) {
+      v.emplace_back(result::err_tag, static_cast<std::int32_t>(x >> 40));
+    } else {
+      v.emplace_back(result::ok_tag, static_cast<std::int64_t>(x >> 1));
+    }
+  }
+  return v;
+}
+} // namespace
+
+TEST_CASE("sort 1M results", "[benchmark][sort]") {
+  const auto input = make_results();
+
+  BENCHMARK_ADVANCED("std::sort, legacy operator<=>")
+  (Catch::Benchmark::Chronometer meter) {
+    auto v = input;
+    meter.measure([&v] {
+      std::sort(v.begin(), v.end(), [](const auto &lhs, const auto &rhs) {
+        return legacy_compare(lhs, rhs) < 0;
+      });
+    });
+  };
+
+  BENCHMARK_ADVANCED("std::sort, operator<=>")
+  (Catch::Benchmark::Chronometer meter) {
+    auto v = input;
+    meter.measure([&v] { std::sort(v.begin(), v.end()); });
+  };
+
+  BENCHMARK_ADVANCED("result::sort_results")
+  (Catch::Benchmark::Chronometer meter) {
+    auto v = input;
+    meter.measure([&v] { result::sort_results(v); });
+  };
+}
@@ -0,0 +1,59 @@
+#include "result/zip.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace {
+using string_result = result::result<std::string, int>;
+
+// Fits the small string buffer: moving it copies the characters, as moving
+// most small payloads does.
+[[gnu::noipa]] string_result field(std::size_t i) {
+  return string_result(result::ok_tag, "field number " + std::to_string(i));
+}
+
+// The combination zip replaces: one and_then per result, each level moving
+// the values collected so far into a larger tuple.
+template <typename Tuple>
+result::result<Tuple, int> nested_and_then(Tuple &&values) {
+  return result::result<Tuple, int>(result::ok_tag, std::move(values));
+}
+
+template <typename Tuple, typename R, typename... Rs>
+auto nested_and_then(Tuple &&values, R &&r, Rs &&...rs) {
+  return std::move(r).and_then([&](std::string &&s) {
+    return nested_and_then(
+        std::tuple_cat(std::move(values), std::tuple(std::move(s))),
+        std::move(rs)...);
+  });
+}
+
+template <std::size_t... I> auto zip_fields(std::index_sequence<I...>) {
+  return result::zip(field(I)...);
+}
+
+template <std::size_t... I>
+auto nested_and_then_fields(std::index_sequence<I...>) {
+  return nested_and_then(std::tuple<>(), field(I)...);
+}
+
+template <std::size_t N> void combine() {
+  const std::string n = std::to_string(N);
+  BENCHMARK("zip, N = " + n) {
+    return zip_fields(std::make_index_sequence<N>());
+  };
+  BENCHMARK("nested and_then, N = " + n) {
+    return nested_and_then_fields(std::make_index_sequence<N>());
+  };
+}
+} // namespace
+
+TEST_CASE("combine N string results", "[benchmark][zip]") {
+  combine<2>();
+  combine<4>();
+  combine<6>();
+  combine<8>();
+}
@@ -0,0 +1,49 @@
+#ifndef RESULT_ALGORITHM_HPP
+#define RESULT_ALGORITHM_HPP
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <ranges>
+
+namespace result {
+
+/// Sort a range of results in the order defined by operator<=>: all err
+/// results first, followed by the ok results ordered by their values.
+///
+/// The range is first partitioned by state, after which only the ok values
+/// are sorted, so the state of each result is read once per element instead
+/// of once per comparison. Err results compare equal to each other and are
+/// left in an unspecified order.
+///
+/// Not named sort, so that an unqualified sort(first, last) on results
+/// after using std::sort still finds std::sort alone.
+/// \param first first element of the range
+/// \param last one past the last element of the range
+/// \param comp strict weak ordering of the ok values
+/// \return iterator to the first ok result
+template <std::random_access_iterator It, typename Compare = std::less<>>
+  requires is_result<std::iter_value_t<It>>::value
+It sort_results(It first, It last, Compare comp = {}) {
+  It mid = std::partition(
+      first, last, [](const std::iter_value_t<It> &r) { return r.is_err(); });
+  std::sort(mid, last, [&comp](const auto &lhs, const auto &rhs) {
+    return comp(lhs.ok_unchecked(), rhs.ok_unchecked());
+  });
+  return mid;
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::less<>>
+  requires is_result<std::ranges::range_value_t<R>>::value
+std::ranges::borrowed_iterator_t<R> sort_results(R &&range,
+                                                 Compare comp = {}) {
+  auto first = std::ranges::begin(range);
+  return ::result::sort_results(
+      first, std::ranges::next(first, std::ranges::end(range)), std::move(comp));
+}
+
+} // namespace result
+
+#endif // RESULT_ALGORITHM_HPP
@@ -0,0 +1,280 @@
+#ifndef RESULT_ANY_ERROR_HPP
+#define RESULT_ANY_ERROR_HPP
+
+#include "result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace result {
+
+namespace details {
+template <typename T> constexpr std::string_view type_signature() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return __FUNCSIG__;
+#else
+  return __PRETTY_FUNCTION__;
+#endif
+}
+
+/// Name of T extracted from the signature of type_signature<T>().
+template <typename T> constexpr std::string_view type_name() noexcept {
+  constexpr std::string_view sig = type_signature<T>();
+#if defined(_MSC_VER) && !defined(__clang__)
+  constexpr std::string_view prefix = "type_signature<";
+  constexpr std::string_view suffix = ">(void) noexcept";
+#else
+  // GCC: "... [with T = int; std::string_view = ...]", Clang: "... [T = int]"
+  constexpr std::string_view prefix = "T = ";
+#endif
+  constexpr auto first = sig.find(prefix) + prefix.size();
+#if defined(_MSC_VER) && !defined(__clang__)
+  constexpr auto last = sig.rfind(suffix);
+#else
+  constexpr auto last =
+      sig.find(';', first) != std::string_view::npos ? sig.find(';', first)
+                                                       : sig.rfind(']');
+#endif
+  return sig.substr(first, last - first);
+}
+
+/// Whether the name of T identifies it across translation units. Types in
+/// an anonymous namespace, local classes and lambdas have no linkage: two
+/// of them can print the same name, so they are only compared by address.
+template <typename T> constexpr bool has_unique_name() noexcept {
+  constexpr std::string_view name = type_name<T>();
+  for (const std::string_view token :
+       {std::string_view("{anonymous}"), std::string_view("(anonymous"),
+        std::string_view("`anonymous"), std::string_view("lambda"),
+        std::string_view(")::")}) {
+    if (name.find(token) != std::string_view::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// FNV-1a hash of the name of T. Unlike the address of a static variable
+/// the value is the same in every shared library.
+template <typename T> constexpr std::uint64_t type_hash() noexcept {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (const char c : type_name<T>()) {
+    h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+  }
+  return h;
+}
+} // namespace details
+
+/// Type-erased error of any copyable type.
+///
+/// Errors up to inline_size bytes with a nothrow move constructor are
+/// stored in place, larger ones are allocated on the heap. Operations go
+/// through a static table of function pointers, so neither RTTI nor
+/// exceptions are required.
+///
+/// Downcasts compare the address of that table. A copy of the table in
+/// another shared library still matches when the type name, size and
+/// alignment are equal, which requires a type with external linkage:
+/// errors in an anonymous namespace, local classes and lambdas only match
+/// the table of the library that stored them.
+class any_error {
+public:
+  static constexpr std::size_t inline_size = 48;
+  static constexpr std::size_t inline_align = alignof(std::max_align_t);
+
+  /// Whether an E is stored in place instead of on the heap.
+  template <typename E>
+  static constexpr bool stored_inline_v =
+      sizeof(E) <= inline_size && alignof(E) <= inline_align &&
+      std::is_nothrow_move_constructible_v<E>;
+
+  /// Construct an empty any_error.
+  constexpr any_error() noexcept = default;
+
+  template <typename E>
+    requires(!std::is_same_v<std::remove_cvref_t<E>, any_error> &&
+             std::is_copy_constructible_v<std::remove_cvref_t<E>>)
+  any_error(E &&e) {
+    emplace<std::remove_cvref_t<E>>(std::forward<E>(e));
+  }
+
+  template <typename E, typename... Args>
+    requires std::is_copy_constructible_v<E>
+  explicit any_error(std::in_place_type_t<E>, Args &&...args) {
+    emplace<E>(std::forward<Args>(args)...);
+  }
+
+  any_error(const any_error &other) {
+    if (other.m_vtable != nullptr) {
+      other.m_vtable->copy(m_data, other.m_data);
+      m_vtable = other.m_vtable;
+    }
+  }
+
+  any_error(any_error &&other) noexcept { take(other); }
+
+  any_error &operator=(const any_error &rhs) {
+    if (this != &rhs) {
+      any_error copy(rhs);
+      reset();
+      take(copy);
+    }
+    return *this;
+  }
+
+  any_error &operator=(any_error &&rhs) noexcept {
+    if (this != &rhs) {
+      reset();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  ~any_error() { reset(); }
+
+  /// Replace the stored error with an E constructed from args.
+  template <typename E, typename... Args> E &emplace(Args &&...args) {
+    reset();
+    if constexpr (stored_inline_v<E>) {
+      new (m_data) E(std::forward<Args>(args)...);
+    } else {
+      *reinterpret_cast<E **>(m_data) = new E(std::forward<Args>(args)...);
+    }
+    m_vtable = &vtable_for<E>;
+    return *get_if<E>();
+  }
+
+  /// Destroy the stored error.
+  void reset() noexcept {
+    if (m_vtable != nullptr) {
+      m_vtable->destroy(m_data);
+      m_vtable = nullptr;
+    }
+  }
+
+  bool has_value() const noexcept { return m_vtable != nullptr; }
+
+  /// Whether the stored error lives in the inline buffer.
+  bool stored_inline() const noexcept {
+    return m_vtable != nullptr && m_vtable->stored_inline;
+  }
+
+  /// Hash of the name of the stored error type, 0 if empty.
+  std::uint64_t type_id() const noexcept {
+    return m_vtable != nullptr ? m_vtable->id : 0;
+  }
+
+  /// Name of the stored error type, empty if empty.
+  std::string_view type_name() const noexcept {
+    return m_vtable != nullptr ? m_vtable->name : std::string_view();
+  }
+
+  template <typename E> bool is() const noexcept {
+    if (m_vtable == &vtable_for<E>) {
+      return true;
+    }
+    // Copies of the vtable living in other shared libraries. The hash only
+    // rejects quickly, a match is decided by the full name.
+    if constexpr (details::has_unique_name<E>()) {
+      return m_vtable != nullptr && m_vtable->id == details::type_hash<E>() &&
+             m_vtable->size == sizeof(E) && m_vtable->align == alignof(E) &&
+             m_vtable->stored_inline == stored_inline_v<E> &&
+             m_vtable->name == details::type_name<E>();
+    } else {
+      return false;
+    }
+  }
+
+  /// Pointer to the stored error if it is an E, nullptr otherwise.
+  template <typename E> E *get_if() noexcept {
+    return is<E>() ? address<E>() : nullptr;
+  }
+
+  template <typename E> const E *get_if() const noexcept {
+    return is<E>() ? const_cast<any_error *>(this)->address<E>() : nullptr;
+  }
+
+private:
+  struct vtable {
+    std::uint64_t id;
+    std::string_view name;
+    std::size_t size;
+    std::size_t align;
+    bool stored_inline;
+    void (*copy)(unsigned char *dst, const unsigned char *src);
+    // nullptr if the buffer can be relocated with memcpy.
+    void (*relocate)(unsigned char *dst, unsigned char *src) noexcept;
+    void (*destroy)(unsigned char *data) noexcept;
+  };
+
+  template <typename E> static constexpr vtable make_vtable() noexcept {
+    if constexpr (stored_inline_v<E> && std::is_trivially_copyable_v<E>) {
+      return {details::type_hash<E>(), details::type_name<E>(), sizeof(E),
+              alignof(E), true,
+              [](unsigned char *dst, const unsigned char *src) {
+                std::memcpy(dst, src, sizeof(E));
+              },
+              nullptr, [](unsigned char *) noexcept {}};
+    } else if constexpr (stored_inline_v<E>) {
+      return {details::type_hash<E>(), details::type_name<E>(), sizeof(E),
+              alignof(E), true,
+              [](unsigned char *dst, const unsigned char *src) {
+                new (dst) E(*std::launder(reinterpret_cast<const E *>(src)));
+              },
+              [](unsigned char *dst, unsigned char *src) noexcept {
+                E *e = std::launder(reinterpret_cast<E *>(src));
+                new (dst) E(std::move(*e));
+                e->~E();
+              },
+              [](unsigned char *data) noexcept {
+                std::launder(reinterpret_cast<E *>(data))->~E();
+              }};
+    } else {
+      return {details::type_hash<E>(), details::type_name<E>(), sizeof(E),
+              alignof(E), false,
+              [](unsigned char *dst, const unsigned char *src) {
+                *reinterpret_cast<E **>(dst) =
+                    new E(**reinterpret_cast<E *const *>(src));
+              },
+              nullptr,
+              [](unsigned char *data) noexcept {
+                delete *reinterpret_cast<E **>(data);
+              }};
+    }
+  }
+
+  template <typename E>
+  static constexpr vtable vtable_for = make_vtable<E>();
+
+  template <typename E> E *address() noexcept {
+    if constexpr (stored_inline_v<E>) {
+      return std::launder(reinterpret_cast<E *>(m_data));
+    } else {
+      return *reinterpret_cast<E **>(m_data);
+    }
+  }
+
+  void take(any_error &other) noexcept {
+    if (other.m_vtable != nullptr) {
+      if (other.m_vtable->relocate == nullptr) {
+        std::memcpy(m_data, other.m_data, inline_size);
+      } else {
+        other.m_vtable->relocate(m_data, other.m_data);
+      }
+      m_vtable = std::exchange(other.m_vtable, nullptr);
+    }
+  }
+
+  const vtable *m_vtable = nullptr;
+  alignas(inline_align) unsigned char m_data[inline_size];
+};
+
+} // namespace result
+
+#endif // RESULT_ANY_ERROR_HPP
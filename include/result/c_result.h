@@ -0,0 +1,56 @@
+/*
+ * Results shared between C and C++, see result::c_result in c_result.hpp.
+ *
+ * RESULT_C_DECLARE(name, ok_type, err_type) declares the result type name:
+ * in C, a struct holding a tag followed by a union of ok_type and err_type,
+ * in C++, result::c_result<ok_type, err_type>, which has the same layout.
+ * A header using it can declare extern "C" functions for both languages:
+ *
+ *   RESULT_C_DECLARE(int64_result, int64_t, int32_t);
+ *   RESULT_C_EXTERN int64_result parse_int64(const char *text);
+ *
+ * C++ callers convert with result::from_c_result and result::to_c_result.
+ */
+#ifndef RESULT_C_RESULT_H
+#define RESULT_C_RESULT_H
+
+#include <stdint.h>
+
+#define RESULT_C_OK 0
+#define RESULT_C_ERR 1
+
+#define RESULT_C_IS_OK(r) ((r).tag == RESULT_C_OK)
+#define RESULT_C_IS_ERR(r) ((r).tag != RESULT_C_OK)
+
+#ifdef __cplusplus
+
+#include "c_result.hpp"
+
+#define RESULT_C_EXTERN extern "C"
+
+#define RESULT_C_DECLARE(name, ok_type, err_type)                             \
+  typedef ::result::c_result<ok_type, err_type> name
+
+#else
+
+#define RESULT_C_EXTERN extern
+
+#define RESULT_C_DECLARE(name, ok_type, err_type)                             \
+  typedef struct name {                                                       \
+    uint8_t tag;                                                              \
+    union {                                                                   \
+      ok_type ok;                                                             \
+      err_type err;                                                           \
+    } value;                                                                  \
+  } name
+
+/* Values of a type declared by RESULT_C_DECLARE, e.g.
+ * return RESULT_C_MAKE_OK(int64_result, 42); */
+#define RESULT_C_MAKE_OK(name, v)                                             \
+  ((name){.tag = RESULT_C_OK, .value = {.ok = (v)}})
+#define RESULT_C_MAKE_ERR(name, e)                                            \
+  ((name){.tag = RESULT_C_ERR, .value = {.err = (e)}})
+
+#endif
+
+#endif /* RESULT_C_RESULT_H */
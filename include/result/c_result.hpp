@@ -0,0 +1,94 @@
+#ifndef RESULT_C_RESULT_HPP
+#define RESULT_C_RESULT_HPP
+
+#include "result.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace result {
+
+/// Result with a layout C code can use, to return results from (or to)
+/// extern "C" functions without converting them to out-parameters.
+///
+/// The layout is that of the C struct
+/// \code
+/// struct {
+///   uint8_t tag; // RESULT_C_OK or RESULT_C_ERR
+///   union {
+///     T ok;
+///     E err;
+///   } value;
+/// };
+/// \endcode
+/// which RESULT_C_DECLARE of result/c_result.h declares in C. In C++ the
+/// same macro names the c_result, so that a header of extern "C" functions
+/// can be shared between both languages.
+///
+/// c_result is an aggregate without constructors: it is as trivial as the
+/// C struct, and small ones such as c_result<std::int64_t, std::int32_t>
+/// are returned in registers (rax:rdx on x86-64 SysV).
+/// \tparam T ok type, trivially copyable and standard layout
+/// \tparam E err type, trivially copyable and standard layout
+template <typename T, typename E> struct c_result {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                    std::is_standard_layout_v<T>,
+                "c_result<T, E> requires a C compatible T");
+  static_assert(std::is_trivially_copyable_v<E> &&
+                    std::is_standard_layout_v<E>,
+                "c_result<T, E> requires a C compatible E");
+
+  using value_type = T;
+  using error_type = E;
+
+  /// Value of tag for an ok result, RESULT_C_OK in C.
+  static constexpr std::uint8_t tag_ok = 0;
+  /// Value of tag for an err result, RESULT_C_ERR in C.
+  static constexpr std::uint8_t tag_err = 1;
+
+  std::uint8_t tag;
+  union {
+    T ok;
+    E err;
+  } value;
+
+  constexpr bool is_ok() const noexcept { return tag == tag_ok; }
+  constexpr bool is_err() const noexcept { return tag != tag_ok; }
+};
+
+static_assert(c_result<int, int>::tag_ok ==
+              static_cast<std::uint8_t>(result_type::ok));
+static_assert(c_result<int, int>::tag_err ==
+              static_cast<std::uint8_t>(result_type::err));
+
+/// Convert a result to a c_result in the same state, with the same value.
+template <typename T, typename E>
+constexpr c_result<T, E> to_c_result(const result<T, E> &r) noexcept {
+  if (r.is_ok()) {
+    return {c_result<T, E>::tag_ok, {.ok = r.ok_unchecked()}};
+  }
+  return {c_result<T, E>::tag_err, {.err = r.err_unchecked()}};
+}
+
+/// Convert a c_result to a result in the same state, with the same value.
+/// A tag other than tag_ok is taken as tag_err.
+template <typename T, typename E>
+constexpr result<T, E> from_c_result(const c_result<T, E> &r) noexcept {
+  if (r.is_ok()) {
+    return result<T, E>(ok_tag, r.value.ok);
+  }
+  return result<T, E>(err_tag, r.value.err);
+}
+
+/// A c_result equals a result in the same state with an equal value.
+template <typename T, typename E>
+constexpr bool operator==(const c_result<T, E> &lhs, const result<T, E> &rhs) {
+  if (lhs.is_ok()) {
+    return rhs.is_ok() && lhs.value.ok == rhs.ok_unchecked();
+  }
+  return rhs.is_err() && lhs.value.err == rhs.err_unchecked();
+}
+
+} // namespace result
+
+#endif // RESULT_C_RESULT_HPP
@@ -0,0 +1,432 @@
+#ifndef RESULT_CHANNEL_HPP
+#define RESULT_CHANNEL_HPP
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace result {
+
+/// Which threads may use a channel at the same time.
+enum class channel_mode : std::uint8_t {
+  /// One producer thread and one consumer thread.
+  spsc,
+  /// Any number of producer and consumer threads, which includes one
+  /// producer with several consumers and the reverse.
+  mpmc,
+};
+
+/// Where a channel keeps its err results.
+enum class error_lane : std::uint8_t {
+  /// In the same ring as the ok results: results are popped in push order.
+  shared,
+  /// In a ring of their own, popped only once no ok value is ready. The
+  /// order of the oks and of the errs is kept, but not their relative order.
+  separate,
+};
+
+namespace details {
+// Uninitialized storage for one element of a ring.
+template <typename T> struct ring_storage {
+  T &get() noexcept { return *std::launder(reinterpret_cast<T *>(bytes)); }
+
+  template <typename U> void construct(U &&u) noexcept {
+    std::construct_at(reinterpret_cast<T *>(bytes), std::forward<U>(u));
+  }
+
+  void destroy() noexcept { std::destroy_at(&get()); }
+
+  alignas(T) unsigned char bytes[sizeof(T)];
+};
+
+inline std::size_t ring_capacity(std::size_t capacity) noexcept {
+  return std::bit_ceil(std::max<std::size_t>(capacity, 2));
+}
+
+// Bounded ring for one producer and one consumer thread. Each side keeps
+// a copy of the other side's index, and only reloads it when the copy
+// says the ring is full (or empty): in the steady state, neither side
+// reads the cache line the other one writes.
+//
+// push_n(n, source) moves the elements source(0), ..., source(k - 1) into
+// the ring, pop_n(n, sink) passes the oldest k elements to sink; both
+// return k, at most n, and publish the whole batch with a single store.
+template <typename T> class spsc_ring {
+  static_assert(std::is_nothrow_move_constructible_v<T>);
+
+public:
+  explicit spsc_ring(std::size_t capacity)
+      : m_mask(ring_capacity(capacity) - 1),
+        m_slots(std::make_unique<ring_storage<T>[]>(m_mask + 1)) {}
+
+  spsc_ring(const spsc_ring &) = delete;
+  spsc_ring &operator=(const spsc_ring &) = delete;
+
+  ~spsc_ring() {
+    auto discard = [](T &&) noexcept {};
+    pop_n(m_mask + 1, discard);
+  }
+
+  std::size_t capacity() const noexcept { return m_mask + 1; }
+
+  template <typename F>
+  std::size_t push_n(std::size_t n, F &&source) noexcept {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (capacity() - (tail - m_head_cache) < n) {
+      m_head_cache = m_head.load(std::memory_order_acquire);
+    }
+    n = std::min(n, capacity() - (tail - m_head_cache));
+    for (std::size_t i = 0; i < n; ++i) {
+      m_slots[(tail + i) & m_mask].construct(source(i));
+    }
+    m_tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // If sink throws, the rest of the batch is destroyed.
+  template <typename F> std::size_t pop_n(std::size_t n, F &&sink) {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (m_tail_cache - head < n) {
+      m_tail_cache = m_tail.load(std::memory_order_acquire);
+    }
+    n = std::min(n, m_tail_cache - head);
+    std::size_t i = 0;
+    struct publish_guard {
+      spsc_ring &ring;
+      std::size_t head, n;
+      std::size_t &i;
+      ~publish_guard() {
+        for (; i < n; ++i) {
+          ring.m_slots[(head + i) & ring.m_mask].destroy();
+        }
+        ring.m_head.store(head + n, std::memory_order_release);
+      }
+    } guard{*this, head, n, i};
+    for (; i < n; ++i) {
+      ring_storage<T> &slot = m_slots[(head + i) & m_mask];
+      sink(std::move(slot.get()));
+      slot.destroy();
+    }
+    return n;
+  }
+
+private:
+  const std::size_t m_mask;
+  const std::unique_ptr<ring_storage<T>[]> m_slots;
+  // Written by the consumer.
+  alignas(cache_line) std::atomic<std::size_t> m_head{0};
+  std::size_t m_tail_cache = 0;
+  // Written by the producer.
+  alignas(cache_line) std::atomic<std::size_t> m_tail{0};
+  std::size_t m_head_cache = 0;
+};
+
+// Bounded ring for any number of producer and consumer threads, after
+// Dmitry Vyukov's bounded MPMC queue: the sequence number of each cell
+// says whether it is free or full for a given lap, and producers (or
+// consumers) claim positions with a compare-and-swap of the tail (or
+// head). A batch claims the run of ready cells after the current position
+// with a single compare-and-swap. Same interface as spsc_ring.
+template <typename T> class mpmc_ring {
+  static_assert(std::is_nothrow_move_constructible_v<T>);
+
+  struct cell {
+    std::atomic<std::size_t> sequence;
+    ring_storage<T> storage;
+  };
+
+public:
+  explicit mpmc_ring(std::size_t capacity)
+      : m_mask(ring_capacity(capacity) - 1),
+        m_cells(std::make_unique<cell[]>(m_mask + 1)) {
+    for (std::size_t i = 0; i <= m_mask; ++i) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpmc_ring(const mpmc_ring &) = delete;
+  mpmc_ring &operator=(const mpmc_ring &) = delete;
+
+  ~mpmc_ring() {
+    auto discard = [](T &&) noexcept {};
+    pop_n(m_mask + 1, discard);
+  }
+
+  std::size_t capacity() const noexcept { return m_mask + 1; }
+
+  template <typename F>
+  std::size_t push_n(std::size_t n, F &&source) noexcept {
+    const auto [position, k] = claim(m_tail, 0, n);
+    for (std::size_t i = 0; i < k; ++i) {
+      cell &c = m_cells[(position + i) & m_mask];
+      c.storage.construct(source(i));
+      c.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    return k;
+  }
+
+  // If sink throws, the rest of the batch is destroyed.
+  template <typename F> std::size_t pop_n(std::size_t n, F &&sink) {
+    const auto [position, k] = claim(m_head, 1, n);
+    std::size_t i = 0;
+    struct release_guard {
+      mpmc_ring &ring;
+      std::size_t position, k;
+      std::size_t &i;
+      ~release_guard() {
+        for (; i < k; ++i) {
+          ring.release(position + i);
+        }
+      }
+    } guard{*this, position, k, i};
+    for (; i < k; ++i) {
+      sink(std::move(m_cells[(position + i) & m_mask].storage.get()));
+      release(position + i);
+    }
+    return k;
+  }
+
+private:
+  struct claimed {
+    std::size_t position;
+    std::size_t count;
+  };
+
+  // Claim up to n consecutive positions from index: the cells are ready
+  // when their sequence is position + lag. If index still holds the
+  // position the scan started from, no other thread claimed these cells,
+  // and only the claiming thread changes their sequence.
+  claimed claim(std::atomic<std::size_t> &index, std::size_t lag,
+                std::size_t n) noexcept {
+    std::size_t position = index.load(std::memory_order_relaxed);
+    for (;;) {
+      std::size_t k = 0;
+      while (k < n && sequence(position + k) == position + k + lag) {
+        ++k;
+      }
+      if (k == 0) {
+        const auto behind = static_cast<std::ptrdiff_t>(
+            sequence(position) - (position + lag));
+        if (behind < 0 || n == 0) {
+          return {position, 0};
+        }
+        position = index.load(std::memory_order_relaxed);
+      } else if (index.compare_exchange_weak(position, position + k,
+                                             std::memory_order_relaxed)) {
+        return {position, k};
+      }
+    }
+  }
+
+  std::size_t sequence(std::size_t position) const noexcept {
+    return m_cells[position & m_mask].sequence.load(std::memory_order_acquire);
+  }
+
+  // Destroy the element of position and free its cell for the next lap.
+  void release(std::size_t position) noexcept {
+    cell &c = m_cells[position & m_mask];
+    c.storage.destroy();
+    c.sequence.store(position + m_mask + 1, std::memory_order_release);
+  }
+
+  const std::size_t m_mask;
+  const std::unique_ptr<cell[]> m_cells;
+  alignas(cache_line) std::atomic<std::size_t> m_head{0};
+  alignas(cache_line) std::atomic<std::size_t> m_tail{0};
+};
+
+template <typename T, channel_mode Mode>
+using ring = std::conditional_t<Mode == channel_mode::spsc, spsc_ring<T>,
+                                mpmc_ring<T>>;
+
+// Error lane of a channel with error_lane::shared.
+struct no_lane {
+  explicit no_lane(std::size_t) noexcept {}
+};
+} // namespace details
+
+/// Bounded, lock-free channel of result<T, E> between threads.
+///
+/// The results are stored in a ring of capacity slots, allocated once, and
+/// the producer and consumer indices live on separate cache lines. The
+/// batch operations try_push_n and try_pop_n move many results for the
+/// cost of a single synchronization.
+///
+/// With error_lane::separate, err results go to a second ring: try_pop
+/// and try_pop_n return the ready ok results first, and try_pop_ok_n lets
+/// consumers drain the oks in a loop that doesn't test any state.
+///
+/// None of the operations blocks: when the channel is full (or empty),
+/// they return without pushing (or popping) anything.
+/// \code
+/// result::channel<record, parse_error> ch(1024);
+/// // producer
+/// ch.try_push(parse(line));
+/// // consumer
+/// std::vector<result::result<record, parse_error>> batch;
+/// ch.try_pop_n(std::back_inserter(batch), 64);
+/// \endcode
+/// \tparam Mode which threads may push and pop concurrently
+/// \tparam Lane where the err results are stored
+template <typename T, typename E, channel_mode Mode = channel_mode::mpmc,
+          error_lane Lane = error_lane::shared>
+class channel {
+  static constexpr bool separate = Lane == error_lane::separate;
+
+  static_assert(!separate || (std::is_object_v<T> && std::is_object_v<E>),
+                "error_lane::separate requires object payloads");
+
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = result<T, E>;
+
+  /// \param capacity number of results the channel can hold, rounded up to
+  /// a power of two. With error_lane::separate, the capacity of each lane.
+  explicit channel(std::size_t capacity)
+      : m_values(capacity), m_errors(capacity) {}
+
+  /// \param capacity number of ok results the channel can hold
+  /// \param error_capacity number of err results the channel can hold
+  channel(std::size_t capacity, std::size_t error_capacity)
+    requires separate
+      : m_values(capacity), m_errors(error_capacity) {}
+
+  channel(const channel &) = delete;
+  channel &operator=(const channel &) = delete;
+
+  /// Number of results the channel can hold, or of ok results with
+  /// error_lane::separate.
+  std::size_t capacity() const noexcept { return m_values.capacity(); }
+
+  /// Number of err results the channel can hold.
+  std::size_t error_capacity() const noexcept
+    requires separate
+  {
+    return m_errors.capacity();
+  }
+
+  /// Move r into the channel.
+  /// \returns whether r was pushed; if the channel is full, r is left as is
+  bool try_push(result_type &&r) noexcept {
+    return try_push_n(std::span<result_type>(&r, 1)) == 1;
+  }
+
+  /// Move as many results from the front of rs into the channel as it can
+  /// hold, publishing them at once.
+  /// \returns the number of results moved from
+  std::size_t try_push_n(std::span<result_type> rs) noexcept {
+    if constexpr (separate) {
+      // One batch per run of results in the same state.
+      std::size_t pushed = 0;
+      while (pushed < rs.size()) {
+        const auto first = rs.begin() + static_cast<std::ptrdiff_t>(pushed);
+        const bool ok = first->is_ok();
+        const auto run = static_cast<std::size_t>(
+            std::find_if(first, rs.end(),
+                         [ok](const result_type &r) {
+                           return r.is_ok() != ok;
+                         }) -
+            first);
+        const std::size_t n =
+            ok ? m_values.push_n(run,
+                                 [first](std::size_t i) -> T && {
+                                   return std::move(first[i]).ok_unchecked();
+                                 })
+               : m_errors.push_n(run, [first](std::size_t i) -> E && {
+                   return std::move(first[i]).err_unchecked();
+                 });
+        pushed += n;
+        if (n < run) {
+          break;
+        }
+      }
+      return pushed;
+    } else {
+      return m_values.push_n(rs.size(),
+                             [&rs](std::size_t i) -> result_type && {
+                               return std::move(rs[i]);
+                             });
+    }
+  }
+
+  /// Pop the oldest result, or with error_lane::separate, the oldest ok
+  /// result if there is one.
+  /// \returns the result, or std::nullopt if the channel is empty
+  std::optional<result_type> try_pop() {
+    std::optional<result_type> r;
+    try_pop_n(&r, 1);
+    return r;
+  }
+
+  /// Pop up to n results, oldest first, and assign them to *out++. With
+  /// error_lane::separate, the ready ok results come before the errs. If
+  /// an assignment throws, the results popped but not yet assigned are
+  /// lost.
+  /// \returns the number of results popped
+  template <typename O>
+    requires std::output_iterator<O, result_type>
+  std::size_t try_pop_n(O out, std::size_t n) {
+    if constexpr (separate) {
+      const std::size_t oks = m_values.pop_n(n, [&out](T &&t) {
+        *out = result_type(ok_tag, std::move(t));
+        ++out;
+      });
+      return oks + m_errors.pop_n(n - oks, [&out](E &&e) {
+        *out = result_type(err_tag, std::move(e));
+        ++out;
+      });
+    } else {
+      return m_values.pop_n(n, [&out](result_type &&r) {
+        *out = std::move(r);
+        ++out;
+      });
+    }
+  }
+
+  /// Pop up to n ok values, oldest first, and assign them to *out++.
+  /// \returns the number of values popped
+  template <typename O>
+    requires(separate && std::output_iterator<O, T>)
+  std::size_t try_pop_ok_n(O out, std::size_t n) {
+    return m_values.pop_n(n, [&out](T &&t) {
+      *out = std::move(t);
+      ++out;
+    });
+  }
+
+  /// Pop up to n errors, oldest first, and assign them to *out++.
+  /// \returns the number of errors popped
+  template <typename O>
+    requires(separate && std::output_iterator<O, E>)
+  std::size_t try_pop_err_n(O out, std::size_t n) {
+    return m_errors.pop_n(n, [&out](E &&e) {
+      *out = std::move(e);
+      ++out;
+    });
+  }
+
+private:
+  using values_type = std::conditional_t<separate, details::ring<T, Mode>,
+                                         details::ring<result_type, Mode>>;
+  using errors_type = std::conditional_t<separate, details::ring<E, Mode>,
+                                         details::no_lane>;
+
+  values_type m_values;
+  [[no_unique_address]] errors_type m_errors;
+};
+
+} // namespace result
+
+#endif // RESULT_CHANNEL_HPP
@@ -0,0 +1,232 @@
+#ifndef RESULT_COLLECT_HPP
+#define RESULT_COLLECT_HPP
+
+#include "result.hpp"
+#include "small_vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace result {
+
+/// An error together with the position of the result it came from.
+template <typename E> struct indexed_error {
+  template <typename... Args>
+  constexpr indexed_error(std::size_t i, Args &&...args)
+      : index(i), error(std::forward<Args>(args)...) {}
+
+  std::size_t index;
+  E error;
+
+  friend bool operator==(const indexed_error &,
+                         const indexed_error &) = default;
+};
+
+/// Errors reported by collect_all and validate, in index order. The first
+/// few are stored inline: validating input that is mostly valid doesn't
+/// allocate for its errors.
+template <typename E>
+using error_list = small_vector<indexed_error<E>, 4>;
+
+namespace details {
+// Whether the elements of R can be moved from: its elements are temporaries
+// or rvalues, as in a transform or as_rvalue view, or R is an rvalue range
+// that owns its elements. A view or borrowed range may refer to the
+// elements of a container of the caller, even when it is an rvalue.
+template <typename R>
+inline constexpr bool move_elements_v =
+    !std::is_lvalue_reference_v<std::ranges::range_reference_t<R>> ||
+    (!std::is_lvalue_reference_v<R> &&
+     !std::ranges::view<std::remove_cvref_t<R>> &&
+     !std::ranges::borrowed_range<R>);
+
+template <typename R, typename X> constexpr decltype(auto) element(X &x) {
+  if constexpr (move_elements_v<R>) {
+    return std::move(x);
+  } else {
+    return std::as_const(x);
+  }
+}
+
+// Collect the results of [first, last), numbered from index, into values
+// until the first error, and every error into errors. Two loops, so that
+// the loop over valid input only tests the state of each result.
+template <typename R, typename It, typename S, typename T, typename E>
+void collect_into(It first, S last, std::size_t index, std::vector<T> &values,
+                  error_list<E> &errors) {
+  for (; first != last; ++first, ++index) {
+    auto &&r = *first;
+    if (r.is_err()) {
+      break;
+    }
+    values.push_back(element<R>(r).ok_unchecked());
+  }
+  for (; first != last; ++first, ++index) {
+    auto &&r = *first;
+    if (r.is_err()) {
+      errors.emplace_back(index, element<R>(r).err_unchecked());
+    }
+  }
+}
+
+template <typename R>
+using collected_t = result<
+    std::vector<typename std::ranges::range_value_t<R>::value_type>,
+    error_list<typename std::ranges::range_value_t<R>::error_type>>;
+
+/// Below this many results per thread, collect_all_parallel doesn't start
+/// more threads.
+inline constexpr std::size_t min_parallel_chunk = 16 * 1024;
+} // namespace details
+
+/// Collect a range of results into all of their ok values, or into all of
+/// their errors.
+///
+/// Unlike and_then, collect_all doesn't stop at the first error: every
+/// result is checked and every error reported with its position, which is
+/// what input validation needs. Once an error is found no more values are
+/// copied. Results are moved from if range is an rvalue that owns them, or
+/// if its elements are rvalues; never through a view of an lvalue.
+/// \returns the ok values in order, or the errors in index order
+template <std::ranges::input_range R>
+  requires is_result<std::ranges::range_value_t<R>>::value
+details::collected_t<R> collect_all(R &&range) {
+  using value_type = typename std::ranges::range_value_t<R>::value_type;
+  using error_type = typename std::ranges::range_value_t<R>::error_type;
+  static_assert(!std::is_reference_v<value_type>,
+                "collect_all() requires results of non-reference types");
+
+  std::vector<value_type> values;
+  error_list<error_type> errors;
+  if constexpr (std::ranges::sized_range<R>) {
+    values.reserve(std::ranges::size(range));
+  }
+  details::collect_into<R>(std::ranges::begin(range), std::ranges::end(range),
+                           0, values, errors);
+  if (!errors.empty()) {
+    return details::collected_t<R>(err_tag, std::move(errors));
+  }
+  return details::collected_t<R>(ok_tag, std::move(values));
+}
+
+/// collect_all for large inputs: the range is split into one chunk per
+/// thread, each thread collects its chunk into its own buffers and the
+/// buffers are merged in chunk order, so values and errors keep the order
+/// of the range.
+/// \param threads maximum number of threads, including the calling one;
+///                chunks are at least 16k results long
+template <std::ranges::random_access_range R>
+  requires std::ranges::sized_range<R> &&
+           is_result<std::ranges::range_value_t<R>>::value
+details::collected_t<R> collect_all_parallel(
+    R &&range, std::size_t threads = std::thread::hardware_concurrency()) {
+  using value_type = typename std::ranges::range_value_t<R>::value_type;
+  using error_type = typename std::ranges::range_value_t<R>::error_type;
+
+  const std::size_t n = std::ranges::size(range);
+  const std::size_t chunks = std::clamp<std::size_t>(
+      n / details::min_parallel_chunk, 1, std::max<std::size_t>(threads, 1));
+  if (chunks == 1) {
+    return collect_all(std::forward<R>(range));
+  }
+
+  struct chunk {
+    std::vector<value_type> values;
+    error_list<error_type> errors;
+    std::exception_ptr exception;
+  };
+  std::vector<chunk> parts(chunks);
+  auto collect_chunk = [&range, &parts, n, chunks](std::size_t c) {
+    const std::size_t first = n * c / chunks;
+    const std::size_t last = n * (c + 1) / chunks;
+    const auto begin = std::ranges::begin(range);
+    try {
+      parts[c].values.reserve(last - first);
+      details::collect_into<R>(begin + first, begin + last, first,
+                               parts[c].values, parts[c].errors);
+    } catch (...) {
+      parts[c].exception = std::current_exception();
+    }
+  };
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(chunks - 1);
+    for (std::size_t c = 1; c < chunks; ++c) {
+      workers.emplace_back(collect_chunk, c);
+    }
+    collect_chunk(0);
+  }
+
+  for (auto &part : parts) {
+    if (part.exception) {
+      std::rethrow_exception(part.exception);
+    }
+  }
+  error_list<error_type> errors;
+  for (auto &part : parts) {
+    for (auto &e : part.errors) {
+      errors.push_back(std::move(e));
+    }
+  }
+  if (!errors.empty()) {
+    return details::collected_t<R>(err_tag, std::move(errors));
+  }
+  std::vector<value_type> values = std::move(parts[0].values);
+  values.reserve(n);
+  for (std::size_t c = 1; c < chunks; ++c) {
+    std::move(parts[c].values.begin(), parts[c].values.end(),
+              std::back_inserter(values));
+  }
+  return details::collected_t<R>(ok_tag, std::move(values));
+}
+
+/// Check several results at once. If all of them are ok, returns a tuple of
+/// their values. Otherwise returns the errors of all failed results, each
+/// with the position of its argument.
+/// \code
+/// auto user = result::validate(parse_name(form), parse_age(form),
+///                              parse_email(form));
+/// \endcode
+template <typename R, typename... Rs>
+  requires(is_result<std::remove_cvref_t<R>>::value &&
+           (is_result<std::remove_cvref_t<Rs>>::value && ...))
+auto validate(R &&r, Rs &&...rs) {
+  using error_type = typename std::remove_cvref_t<R>::error_type;
+  static_assert(
+      (std::is_same_v<error_type,
+                      typename std::remove_cvref_t<Rs>::error_type> &&
+       ...),
+      "validate() requires results with the same error type");
+  using tuple_type =
+      std::tuple<typename std::remove_cvref_t<R>::value_type,
+                 typename std::remove_cvref_t<Rs>::value_type...>;
+  using result_type = result<tuple_type, error_list<error_type>>;
+
+  if (r.is_ok() && (rs.is_ok() && ...)) {
+    return result_type(ok_tag, std::forward<R>(r).ok_unchecked(),
+                       std::forward<Rs>(rs).ok_unchecked()...);
+  }
+  error_list<error_type> errors;
+  std::size_t i = 0;
+  auto add = [&errors, &i](auto &&x) {
+    if (x.is_err()) {
+      errors.emplace_back(i, std::forward<decltype(x)>(x).err_unchecked());
+    }
+    ++i;
+  };
+  add(std::forward<R>(r));
+  (add(std::forward<Rs>(rs)), ...);
+  return result_type(err_tag, std::move(errors));
+}
+
+} // namespace result
+
+#endif // RESULT_COLLECT_HPP
@@ -0,0 +1,375 @@
+#ifndef RESULT_ERROR_SET_HPP
+#define RESULT_ERROR_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "relocate.hpp"
+
+namespace result {
+
+template <typename... Es> class error_set;
+
+template <typename T> struct [[maybe_unused]] is_error_set : std::false_type {};
+
+template <typename... Es>
+struct [[maybe_unused]] is_error_set<error_set<Es...>> : std::true_type {};
+
+namespace details {
+[[noreturn]] inline void unreachable() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  __assume(false);
+#else
+  __builtin_unreachable();
+#endif
+}
+
+template <typename... Ts> struct type_list {};
+
+template <typename T, typename... Ts>
+inline constexpr bool contains_v = (std::is_same_v<T, Ts> || ...);
+
+template <typename T, typename... Ts> constexpr std::size_t index_of() {
+  std::size_t i = 0;
+  static_cast<void>(((std::is_same_v<T, Ts> ? false : (++i, true)) && ...));
+  return i;
+}
+
+template <typename... Ts> constexpr bool unique_types() {
+  return []<std::size_t... I>(std::index_sequence<I...>) {
+    return ((index_of<Ts, Ts...>() == I) && ...);
+  }(std::index_sequence_for<Ts...>{});
+}
+
+template <typename L, typename T> struct append_unique;
+
+template <typename... Ts, typename T>
+struct append_unique<type_list<Ts...>, T> {
+  using type = std::conditional_t<contains_v<T, Ts...>, type_list<Ts...>,
+                                  type_list<Ts..., T>>;
+};
+
+template <typename L, typename R> struct merge_unique {
+  using type = L;
+};
+
+template <typename L, typename T, typename... Ts>
+struct merge_unique<L, type_list<T, Ts...>>
+    : merge_unique<typename append_unique<L, T>::type, type_list<Ts...>> {};
+
+template <typename E> struct error_types {
+  using type = type_list<E>;
+};
+
+template <typename... Es> struct error_types<error_set<Es...>> {
+  using type = type_list<Es...>;
+};
+
+template <typename L> struct to_error_type;
+
+template <typename T> struct to_error_type<type_list<T>> {
+  using type = T;
+};
+
+template <typename T1, typename T2, typename... Ts>
+struct to_error_type<type_list<T1, T2, Ts...>> {
+  using type = error_set<T1, T2, Ts...>;
+};
+
+template <std::size_t I, typename R, typename F, typename S>
+constexpr R visit_case(F &&fun, S &&set) {
+  if constexpr (I < std::remove_cvref_t<S>::size) {
+    return std::invoke(std::forward<F>(fun),
+                       std::forward<S>(set).template get<I>());
+  } else {
+    unreachable();
+  }
+}
+
+/// Dispatch on the discriminant with a switch of 8 cases per level, which
+/// compilers lower to a jump table.
+template <std::size_t Base, typename R, typename F, typename S>
+constexpr R visit_at(std::size_t index, F &&fun, S &&set) {
+  switch (index - Base) {
+  case 0:
+    return visit_case<Base + 0, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 1:
+    return visit_case<Base + 1, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 2:
+    return visit_case<Base + 2, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 3:
+    return visit_case<Base + 3, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 4:
+    return visit_case<Base + 4, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 5:
+    return visit_case<Base + 5, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 6:
+    return visit_case<Base + 6, R>(std::forward<F>(fun), std::forward<S>(set));
+  case 7:
+    return visit_case<Base + 7, R>(std::forward<F>(fun), std::forward<S>(set));
+  default:
+    if constexpr (Base + 8 < std::remove_cvref_t<S>::size) {
+      return visit_at<Base + 8, R>(index, std::forward<F>(fun),
+                                   std::forward<S>(set));
+    } else {
+      unreachable();
+    }
+  }
+}
+} // namespace details
+
+/// Error type combining the error types E1 and E2.
+///
+/// Error sets are flattened and duplicates removed, in order of first
+/// appearance: error_union_t<A, A> is A, error_union_t<A, B> is
+/// error_set<A, B> and error_union_t<error_set<A, B>, error_set<B, C>> is
+/// error_set<A, B, C>.
+template <typename E1, typename E2>
+using error_union_t = typename details::to_error_type<
+    typename details::merge_unique<typename details::error_types<E1>::type,
+                                   typename details::error_types<E2>::type>::
+        type>::type;
+
+/// Closed set of error types stored as a tagged union with a one byte
+/// discriminant.
+///
+/// An error_set is implicitly constructible from each of its error types
+/// and from any error_set of a subset of its error types, so errors widen
+/// without an explicit conversion. result<T, E>::and_then() uses this to
+/// combine the error types of the chained functions.
+/// \tparam Es distinct error types
+template <typename... Es> class error_set {
+  static_assert(sizeof...(Es) > 0, "error_set requires at least one type");
+  static_assert(sizeof...(Es) < 256, "error_set supports up to 255 types");
+  static_assert(details::unique_types<Es...>(),
+                "error_set<Es...> requires distinct error types");
+  static_assert(!(is_error_set<Es>::value || ...),
+                "error_set<Es...> can't be nested, use error_union_t");
+  static_assert((std::is_same_v<std::remove_cvref_t<Es>, Es> && ...),
+                "error_set<Es...> requires non-reference, non-cv types");
+
+public:
+  static constexpr std::size_t size = sizeof...(Es);
+
+  template <typename E>
+    requires details::contains_v<std::remove_cvref_t<E>, Es...>
+  error_set(E &&e) noexcept(
+      std::is_nothrow_constructible_v<std::remove_cvref_t<E>, E &&>) {
+    construct<std::remove_cvref_t<E>>(std::forward<E>(e));
+  }
+
+  template <typename E, typename... Args>
+    requires details::contains_v<E, Es...>
+  explicit error_set(std::in_place_type_t<E>, Args &&...args) {
+    construct<E>(std::forward<Args>(args)...);
+  }
+
+  template <typename... Os>
+    requires(!std::is_same_v<error_set<Os...>, error_set<Es...>> &&
+             (details::contains_v<Os, Es...> && ...))
+  error_set(const error_set<Os...> &other) {
+    other.visit([this](const auto &e) {
+      construct<std::remove_cvref_t<decltype(e)>>(e);
+    });
+  }
+
+  template <typename... Os>
+    requires(!std::is_same_v<error_set<Os...>, error_set<Es...>> &&
+             (details::contains_v<Os, Es...> && ...))
+  error_set(error_set<Os...> &&other) {
+    std::move(other).visit([this](auto &&e) {
+      construct<std::remove_cvref_t<decltype(e)>>(std::move(e));
+    });
+  }
+
+  error_set(const error_set &other) noexcept(
+      (std::is_nothrow_copy_constructible_v<Es> && ...)) {
+    other.visit([this](const auto &e) {
+      construct<std::remove_cvref_t<decltype(e)>>(e);
+    });
+  }
+
+  error_set(error_set &&other) noexcept(
+      (std::is_nothrow_move_constructible_v<Es> && ...)) {
+    std::move(other).visit([this](auto &&e) {
+      construct<std::remove_cvref_t<decltype(e)>>(std::move(e));
+    });
+  }
+
+  error_set &operator=(const error_set &rhs) noexcept(
+      (std::is_nothrow_copy_constructible_v<Es> && ...) &&
+      (std::is_nothrow_copy_assignable_v<Es> && ...)) {
+    if (this != &rhs) {
+      rhs.visit([this](const auto &e) { assign(e); });
+    }
+    return *this;
+  }
+
+  error_set &operator=(error_set &&rhs) noexcept(
+      (std::is_nothrow_move_constructible_v<Es> && ...) &&
+      (std::is_nothrow_move_assignable_v<Es> && ...)) {
+    if (this != &rhs) {
+      std::move(rhs).visit([this](auto &&e) { assign(std::move(e)); });
+    }
+    return *this;
+  }
+
+  ~error_set() { destroy(); }
+
+  /// Position of the stored error type in Es.
+  constexpr std::size_t index() const noexcept { return m_index; }
+
+  template <typename E> constexpr bool holds() const noexcept {
+    static_assert(details::contains_v<E, Es...>,
+                  "E is not a member of error_set<Es...>");
+    return m_index == details::index_of<E, Es...>();
+  }
+
+  /// Access the stored error by position, without checking index().
+  template <std::size_t I> auto &get() & noexcept {
+    using E = std::tuple_element_t<I, std::tuple<Es...>>;
+    return *std::launder(reinterpret_cast<E *>(m_data));
+  }
+
+  template <std::size_t I> const auto &get() const & noexcept {
+    using E = std::tuple_element_t<I, std::tuple<Es...>>;
+    return *std::launder(reinterpret_cast<const E *>(m_data));
+  }
+
+  template <std::size_t I> auto &&get() && noexcept {
+    return std::move(get<I>());
+  }
+
+  /// Access the stored error by type, without checking holds<E>().
+  template <typename E> E &get() & noexcept {
+    return get<details::index_of<E, Es...>()>();
+  }
+
+  template <typename E> const E &get() const & noexcept {
+    return get<details::index_of<E, Es...>()>();
+  }
+
+  template <typename E> E &&get() && noexcept {
+    return std::move(get<details::index_of<E, Es...>()>());
+  }
+
+  /// Pointer to the stored error if it is an E, nullptr otherwise.
+  template <typename E> E *get_if() noexcept {
+    return holds<E>() ? std::addressof(get<E>()) : nullptr;
+  }
+
+  template <typename E> const E *get_if() const noexcept {
+    return holds<E>() ? std::addressof(get<E>()) : nullptr;
+  }
+
+  /// Call fun with the stored error. fun must return the same type for
+  /// every error type.
+  template <typename F> decltype(auto) visit(F &&fun) & {
+    using R = std::invoke_result_t<F, first_type &>;
+    return details::visit_at<0, R>(m_index, std::forward<F>(fun), *this);
+  }
+
+  template <typename F> decltype(auto) visit(F &&fun) const & {
+    using R = std::invoke_result_t<F, const first_type &>;
+    return details::visit_at<0, R>(m_index, std::forward<F>(fun), *this);
+  }
+
+  template <typename F> decltype(auto) visit(F &&fun) && {
+    using R = std::invoke_result_t<F, first_type &&>;
+    return details::visit_at<0, R>(m_index, std::forward<F>(fun),
+                                   std::move(*this));
+  }
+
+  friend bool operator==(const error_set &lhs, const error_set &rhs) {
+    if (lhs.m_index != rhs.m_index) {
+      return false;
+    }
+    return lhs.visit([&rhs](const auto &e) {
+      return e == rhs.template get<std::remove_cvref_t<decltype(e)>>();
+    });
+  }
+
+  template <typename E>
+    requires details::contains_v<E, Es...>
+  friend bool operator==(const error_set &lhs, const E &rhs) {
+    return lhs.template holds<E>() && lhs.template get<E>() == rhs;
+  }
+
+private:
+  using first_type = std::tuple_element_t<0, std::tuple<Es...>>;
+
+  template <typename E, typename... Args> void construct(Args &&...args) {
+    new (m_data) E(std::forward<Args>(args)...);
+    m_index = static_cast<std::uint8_t>(details::index_of<E, Es...>());
+  }
+
+  // Assign e, replacing the stored error if it isn't a U. If constructing
+  // the U throws, the stored error is kept, so that m_index never refers to
+  // a destroyed error.
+  template <typename E> void assign(E &&e) {
+    using U = std::remove_cvref_t<E>;
+    if (holds<U>()) {
+      get<U>() = std::forward<E>(e);
+    } else if constexpr (std::is_nothrow_constructible_v<U, E &&>) {
+      destroy();
+      construct<U>(std::forward<E>(e));
+    } else if constexpr (std::is_nothrow_move_constructible_v<U>) {
+      U tmp(std::forward<E>(e));
+      destroy();
+      construct<U>(std::move(tmp));
+    } else {
+      // Set the stored error aside and put it back if constructing the U
+      // throws. An exception thrown while putting it back terminates the
+      // program.
+      error_set backup(std::move(*this));
+      destroy();
+      struct restore_guard {
+        error_set &set;
+        error_set *backup;
+        ~restore_guard() {
+          if (backup != nullptr) {
+            std::move(*backup).visit([this](auto &&old) {
+              set.template construct<std::remove_cvref_t<decltype(old)>>(
+                  std::move(old));
+            });
+          }
+        }
+      } guard{*this, &backup};
+      construct<U>(std::forward<E>(e));
+      guard.backup = nullptr;
+    }
+  }
+
+  void destroy() noexcept {
+    visit([](auto &e) {
+      using U = std::remove_cvref_t<decltype(e)>;
+      e.~U();
+    });
+  }
+
+  alignas(Es...) unsigned char m_data[std::max({sizeof(Es)...})];
+  std::uint8_t m_index;
+};
+
+/// The bytes of an error_set are those of the stored error plus its index.
+template <typename... Es>
+struct is_trivially_relocatable<error_set<Es...>>
+    : std::bool_constant<(is_trivially_relocatable_v<Es> && ...)> {};
+
+/// Call fun with the error stored in set.
+template <typename F, typename S>
+  requires is_error_set<std::remove_cvref_t<S>>::value
+decltype(auto) visit(F &&fun, S &&set) {
+  return std::forward<S>(set).visit(std::forward<F>(fun));
+}
+
+} // namespace result
+
+#endif // RESULT_ERROR_SET_HPP
@@ -0,0 +1,229 @@
+#ifndef RESULT_EXCEPTION_HPP
+#define RESULT_EXCEPTION_HPP
+
+#include "result.hpp"
+#include "status.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace result {
+
+/// How an error type E is caught from and thrown as an exception.
+///
+/// By default E is itself the exception type: it is caught by reference,
+/// moved into the result and thrown as is. Specialize the trait to catch
+/// another exception type and convert it:
+/// \code
+/// template <> struct result::exception_traits<parse_error> {
+///   using exception_type = lib::parse_exception;
+///   static parse_error convert(lib::parse_exception &e) {
+///     return parse_error{e.line()};
+///   }
+///   [[noreturn]] static void raise(parse_error e) {
+///     throw lib::parse_exception(e.line);
+///   }
+/// };
+/// \endcode
+template <typename E> struct exception_traits {
+  using exception_type = E;
+
+  static E convert(E &e) noexcept(std::is_nothrow_move_constructible_v<E>) {
+    return std::move(e);
+  }
+
+  template <typename U> [[noreturn]] static void raise(U &&e) {
+    throw std::forward<U>(e);
+  }
+};
+
+/// std::error_code is caught from and thrown as std::system_error.
+template <> struct exception_traits<std::error_code> {
+  using exception_type = std::system_error;
+
+  static std::error_code convert(std::system_error &e) noexcept {
+    return e.code();
+  }
+
+  [[noreturn]] static void raise(const std::error_code &e) {
+    throw std::system_error(e);
+  }
+};
+
+/// status is caught from and thrown as std::system_error.
+template <> struct exception_traits<status> {
+  using exception_type = std::system_error;
+
+  static status convert(std::system_error &e) noexcept { return e.code(); }
+
+  [[noreturn]] static void raise(const status &e) {
+    throw std::system_error(e.to_error_code());
+  }
+};
+
+/// The errors of an error_set are thrown through the traits of the stored
+/// error type.
+template <typename... Es> struct exception_traits<error_set<Es...>> {
+  template <typename U> [[noreturn]] static void raise(U &&e) {
+    std::forward<U>(e).visit([](auto &&v) {
+      exception_traits<std::remove_cvref_t<decltype(v)>>::raise(
+          std::forward<decltype(v)>(v));
+    });
+    details::unreachable();
+  }
+};
+
+namespace details {
+template <typename R>
+using catch_value_t = std::conditional_t<std::is_void_v<R>, empty_tag_t, R>;
+
+template <typename... Es> struct catch_error {
+  using type = error_set<Es...>;
+};
+
+template <typename E> struct catch_error<E> {
+  using type = E;
+};
+
+template <typename Res, typename F, typename... Args>
+Res invoke_ok(F &&fun, Args &&...args) {
+  if constexpr (std::is_void_v<std::invoke_result_t<F, Args...>>) {
+    std::invoke(std::forward<F>(fun), std::forward<Args>(args)...);
+    return Res(ok_tag);
+  } else {
+    return Res(ok_tag,
+               std::invoke(std::forward<F>(fun), std::forward<Args>(args)...));
+  }
+}
+
+/// catch_as for a single error type: the exception is converted in its
+/// handler, an exception thrown by the conversion propagates.
+template <typename Res, typename E, typename F, typename... Args>
+Res catch_one(F &&fun, Args &&...args) {
+  using traits = exception_traits<E>;
+  try {
+    return invoke_ok<Res>(std::forward<F>(fun), std::forward<Args>(args)...);
+  } catch (typename traits::exception_type &e) {
+    return Res(err_tag, E(traits::convert(e)));
+  }
+}
+
+/// An exception caught by catch_nested and the position of the error type
+/// whose handler matched it.
+struct caught_exception {
+  std::size_t index = 0;
+  std::exception_ptr exception;
+};
+
+/// Nested try blocks, one per error type, that only match the exception.
+/// The innermost block belongs to the first error type, so the handlers
+/// are tried in the listed order. The matched exception is converted by
+/// convert_caught once every try block is left: an exception thrown by a
+/// conversion isn't caught by the handler of another error type.
+template <std::size_t I, typename Res, typename... Es, typename F,
+          typename... Args>
+std::optional<Res> catch_nested(caught_exception &caught, F &&fun,
+                                Args &&...args) {
+  using E = std::tuple_element_t<I, std::tuple<Es...>>;
+  try {
+    if constexpr (I == 0) {
+      return invoke_ok<Res>(std::forward<F>(fun), std::forward<Args>(args)...);
+    } else {
+      return catch_nested<I - 1, Res, Es...>(caught, std::forward<F>(fun),
+                                            std::forward<Args>(args)...);
+    }
+  } catch (typename exception_traits<E>::exception_type &) {
+    caught = {I, std::current_exception()};
+  }
+  return std::nullopt;
+}
+
+/// Convert the exception matched by the handler of the error type at
+/// caught.index.
+template <std::size_t I, typename Res, typename... Es>
+Res convert_caught(const caught_exception &caught) {
+  using E = std::tuple_element_t<I, std::tuple<Es...>>;
+  using traits = exception_traits<E>;
+  if constexpr (I + 1 < sizeof...(Es)) {
+    if (caught.index != I) {
+      return convert_caught<I + 1, Res, Es...>(caught);
+    }
+  }
+  try {
+    std::rethrow_exception(caught.exception);
+  } catch (typename traits::exception_type &e) {
+    return Res(err_tag, E(traits::convert(e)));
+  }
+  unreachable();
+}
+
+template <typename E, typename U>
+[[noreturn, gnu::cold, gnu::noinline]] void raise_err(U &&e) {
+  exception_traits<E>::raise(std::forward<U>(e));
+}
+} // namespace details
+
+/// Call fun with args and catch the exceptions of the error types Es.
+///
+/// Returns a result holding the return value of fun (empty_tag_t if fun
+/// returns void) or the caught error. The error type is E for a single
+/// error type and error_set<Es...> otherwise. Exceptions are caught by
+/// reference and converted by exception_traits<E>::convert, handlers are
+/// tried in the order of Es, other exceptions propagate, including those
+/// thrown by convert.
+template <typename... Es, typename F, typename... Args>
+  requires(sizeof...(Es) > 0 && std::invocable<F, Args...>)
+auto catch_as(F &&fun, Args &&...args) {
+  using value_type = details::catch_value_t<std::invoke_result_t<F, Args...>>;
+  using error_type = typename details::catch_error<Es...>::type;
+  using res = result<value_type, error_type>;
+  if constexpr (sizeof...(Es) == 1) {
+    return details::catch_one<res, Es...>(std::forward<F>(fun),
+                                          std::forward<Args>(args)...);
+  } else {
+    details::caught_exception caught;
+    if (auto r = details::catch_nested<sizeof...(Es) - 1, res, Es...>(
+            caught, std::forward<F>(fun), std::forward<Args>(args)...)) {
+      return std::move(*r);
+    }
+    return details::convert_caught<0, res, Es...>(caught);
+  }
+}
+
+/// Return the ok value of r or throw its error through
+/// exception_traits<E>::raise. The throw is kept out of line, the ok path
+/// is a branch and a return.
+template <typename T, typename E>
+constexpr T &throw_if_err(result<T, E> &r) {
+  if (r.is_err()) [[unlikely]] {
+    details::raise_err<E>(r.err_unchecked());
+  }
+  return r.ok_unchecked();
+}
+
+template <typename T, typename E>
+constexpr const T &throw_if_err(const result<T, E> &r) {
+  if (r.is_err()) [[unlikely]] {
+    details::raise_err<E>(r.err_unchecked());
+  }
+  return r.ok_unchecked();
+}
+
+/// Rvalue results return the ok value by value, so the returned value
+/// can't dangle.
+template <typename T, typename E> constexpr T throw_if_err(result<T, E> &&r) {
+  if (r.is_err()) [[unlikely]] {
+    details::raise_err<E>(std::move(r).err_unchecked());
+  }
+  return std::move(r).ok_unchecked();
+}
+
+} // namespace result
+
+#endif // RESULT_EXCEPTION_HPP
@@ -0,0 +1,638 @@
+#ifndef RESULT_FALLIBLE_HPP
+#define RESULT_FALLIBLE_HPP
+
+#include "relocate.hpp"
+#include "result.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Containers reporting allocation failures as results: they neither throw
+// std::bad_alloc nor terminate, and can be used without exceptions
+// (-fno-exceptions). Exceptions thrown by the constructors of the elements
+// are propagated, after the container is restored to its previous state.
+
+namespace result {
+
+/// Why a fallible container couldn't grow.
+///
+/// Wider than a byte on purpose: result<T &, alloc_error> then holds a
+/// pointer and a tag, instead of storing the error in the pointer (see
+/// result_storage<T &, E>). The bytes of that encoding take the address of
+/// the container along, and the optimizer keeps the members of a local
+/// container in memory rather than in registers in the loops filling it.
+enum class alloc_error {
+  /// The allocator had no memory left.
+  out_of_memory,
+  /// The size asked for is above max_size().
+  capacity_overflow,
+};
+
+/// Allocator reporting failures from try_allocate() with a null pointer
+/// rather than an exception, through the nothrow operator new. The default
+/// allocator of try_vector and try_string.
+///
+/// Fallible containers use the try_allocate() of an allocator when it has
+/// one. With other allocators they catch std::bad_alloc, which needs
+/// exceptions.
+template <typename T> struct nothrow_allocator {
+  using value_type = T;
+
+  constexpr nothrow_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr nothrow_allocator(const nothrow_allocator<U> &) noexcept {}
+
+  /// Storage for n objects, or nullptr.
+  T *try_allocate(std::size_t n) noexcept {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      return nullptr;
+    }
+    if constexpr (over_aligned) {
+      return static_cast<T *>(::operator new(
+          n * sizeof(T), std::align_val_t(alignof(T)), std::nothrow));
+    } else {
+      return static_cast<T *>(::operator new(n * sizeof(T), std::nothrow));
+    }
+  }
+
+  /// Storage for n objects, for the standard containers. A failure throws
+  /// std::bad_alloc, or terminates without exceptions.
+  T *allocate(std::size_t n) {
+    if (T *p = try_allocate(n)) {
+      return p;
+    }
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    details::terminate("nothrow_allocator::allocate() failed.");
+    return nullptr;
+#endif
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    if constexpr (over_aligned) {
+      ::operator delete(p, n * sizeof(T), std::align_val_t(alignof(T)));
+    } else {
+      ::operator delete(p, n * sizeof(T));
+    }
+  }
+
+  template <typename U>
+  friend constexpr bool operator==(const nothrow_allocator &,
+                                   const nothrow_allocator<U> &) noexcept {
+    return true;
+  }
+
+private:
+  static constexpr bool over_aligned =
+      alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+};
+
+namespace details {
+// Storage for n objects from alloc, or nullptr.
+template <typename Alloc>
+auto try_allocate(Alloc &alloc, std::size_t n) noexcept ->
+    typename std::allocator_traits<Alloc>::pointer {
+  if constexpr (requires { alloc.try_allocate(n); }) {
+    return alloc.try_allocate(n);
+  } else {
+#if defined(__cpp_exceptions)
+    try {
+      return std::allocator_traits<Alloc>::allocate(alloc, n);
+    } catch (const std::bad_alloc &) {
+      return nullptr;
+    }
+#else
+    return std::allocator_traits<Alloc>::allocate(alloc, n);
+#endif
+  }
+}
+
+// Capacity to grow to for at least needed elements: twice the current
+// capacity, within max.
+constexpr std::size_t grown_capacity(std::size_t capacity, std::size_t needed,
+                                     std::size_t max) noexcept {
+  const std::size_t doubled = capacity > max / 2 ? max : 2 * capacity;
+  return std::max(needed, doubled);
+}
+} // namespace details
+
+/// Vector whose operations that may allocate return a result instead of
+/// throwing: try_push_back() returns the new element or an alloc_error,
+/// try_reserve() and try_resize() the vector or an alloc_error. On failure
+/// the vector is left unchanged.
+///
+/// When growing by one element fails, it tries again for just the elements
+/// needed rather than twice its capacity, so that it can fill the memory
+/// left.
+/// \code
+/// result::try_vector<std::uint32_t> ids;
+/// if (ids.try_push_back(id).is_err()) {
+///   return shed_load();
+/// }
+/// \endcode
+/// try_vector can't be copied, as a copy may fail: see try_clone().
+/// \tparam T element type, which must be nothrow movable (or trivially
+/// relocatable)
+/// \tparam Alloc allocator of T, see nothrow_allocator
+template <typename T, typename Alloc = nothrow_allocator<T>> class try_vector {
+  static_assert(is_trivially_relocatable_v<T> ||
+                    std::is_nothrow_move_constructible_v<T>,
+                "try_vector<T> requires T to be nothrow move constructible");
+  static_assert(std::is_same_v<typename Alloc::value_type, T>,
+                "try_vector<T, Alloc> requires an allocator of T");
+
+  using traits = std::allocator_traits<Alloc>;
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  try_vector() noexcept(std::is_nothrow_default_constructible_v<Alloc>) =
+      default;
+
+  explicit try_vector(const Alloc &alloc) noexcept : m_alloc(alloc) {}
+
+  try_vector(const try_vector &) = delete;
+  try_vector &operator=(const try_vector &) = delete;
+
+  /// Takes over the buffer of other, which is left empty.
+  try_vector(try_vector &&other) noexcept
+      : m_alloc(other.m_alloc), m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_capacity(std::exchange(other.m_capacity, 0)) {}
+
+  try_vector &operator=(try_vector &&rhs) noexcept
+    requires(traits::propagate_on_container_move_assignment::value ||
+             traits::is_always_equal::value)
+  {
+    if (this != &rhs) {
+      clear();
+      release();
+      if constexpr (traits::propagate_on_container_move_assignment::value) {
+        m_alloc = std::move(rhs.m_alloc);
+      }
+      m_data = std::exchange(rhs.m_data, nullptr);
+      m_size = std::exchange(rhs.m_size, 0);
+      m_capacity = std::exchange(rhs.m_capacity, 0);
+    }
+    return *this;
+  }
+
+  ~try_vector() {
+    clear();
+    release();
+  }
+
+  /// A copy of this vector, with its own buffer of size() elements.
+  result<try_vector, alloc_error> try_clone() const
+      noexcept(std::is_nothrow_copy_constructible_v<T>)
+    requires std::is_copy_constructible_v<T>
+  {
+    try_vector copy(traits::select_on_container_copy_construction(m_alloc));
+    if (const auto r = copy.try_append(std::span<const T>(m_data, m_size));
+        r.is_err()) {
+      return result<try_vector, alloc_error>(err_tag, r.err_unchecked());
+    }
+    return result<try_vector, alloc_error>(ok_tag, std::move(copy));
+  }
+
+  /// Construct an element from args at the end of the vector.
+  /// \returns the new element, or the reason the vector couldn't grow
+  template <typename... Args>
+  result<T &, alloc_error> try_emplace_back(Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>) {
+    if (m_size == m_capacity) [[unlikely]] {
+      return grow_emplace_back(std::forward<Args>(args)...);
+    }
+    return result<T &, alloc_error>(
+        ok_tag, emplace_back_unchecked(std::forward<Args>(args)...));
+  }
+
+  result<T &, alloc_error> try_push_back(const T &value) noexcept(
+      std::is_nothrow_copy_constructible_v<T>) {
+    return try_emplace_back(value);
+  }
+
+  result<T &, alloc_error> try_push_back(T &&value) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    return try_emplace_back(std::move(value));
+  }
+
+  /// Copy values to the end of the vector, which may hold them already.
+  result<try_vector &, alloc_error>
+  try_append(std::span<const T> values) noexcept(
+      std::is_nothrow_copy_constructible_v<T>) {
+    return self(append(values));
+  }
+
+  /// Make room for at least capacity elements. Unlike growing by
+  /// try_push_back(), the vector allocates exactly capacity elements.
+  result<try_vector &, alloc_error> try_reserve(size_type capacity) noexcept {
+    return self(reserve(capacity));
+  }
+
+  /// Resize the vector to size elements, value-initializing the new ones.
+  result<try_vector &, alloc_error> try_resize(size_type size) noexcept(
+      std::is_nothrow_default_constructible_v<T>)
+    requires std::is_default_constructible_v<T>
+  {
+    return self(resize_with(size, [](T *dest, size_type n) {
+      std::uninitialized_value_construct_n(dest, n);
+    }));
+  }
+
+  /// Resize the vector to size elements, copying value to the new ones.
+  result<try_vector &, alloc_error>
+  try_resize(size_type size, const T &value) noexcept(
+      std::is_nothrow_copy_constructible_v<T>) {
+    return self(resize_with(size, [&value](T *dest, size_type n) {
+      std::uninitialized_fill_n(dest, n, value);
+    }));
+  }
+
+  /// Construct an element from args at the end of the vector, which must
+  /// have room for it: size() < capacity(), e.g. after try_reserve().
+  template <typename... Args>
+  T &emplace_back_unchecked(Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>) {
+    T *element = construct(m_data + m_size, std::forward<Args>(args)...);
+    ++m_size;
+    return *element;
+  }
+
+  /// Copy values to the end of the vector, which must have room for them:
+  /// size() + values.size() <= capacity().
+  void append_unchecked(std::span<const T> values) noexcept(
+      std::is_nothrow_copy_constructible_v<T>) {
+    std::uninitialized_copy_n(values.data(), values.size(), m_data + m_size);
+    m_size += values.size();
+  }
+
+  void pop_back() noexcept {
+    --m_size;
+    std::destroy_at(m_data + m_size);
+  }
+
+  /// Destroy all elements. The capacity is kept.
+  void clear() noexcept {
+    std::destroy_n(m_data, m_size);
+    m_size = 0;
+  }
+
+  size_type size() const noexcept { return m_size; }
+
+  size_type capacity() const noexcept { return m_capacity; }
+
+  size_type max_size() const noexcept {
+    return std::min<size_type>(traits::max_size(m_alloc),
+                               std::numeric_limits<size_type>::max() /
+                                   sizeof(T));
+  }
+
+  bool empty() const noexcept { return m_size == 0; }
+
+  allocator_type get_allocator() const noexcept { return m_alloc; }
+
+  T *data() noexcept { return m_data; }
+
+  const T *data() const noexcept { return m_data; }
+
+  iterator begin() noexcept { return m_data; }
+
+  const_iterator begin() const noexcept { return m_data; }
+
+  iterator end() noexcept { return m_data + m_size; }
+
+  const_iterator end() const noexcept { return m_data + m_size; }
+
+  T &operator[](size_type i) noexcept { return m_data[i]; }
+
+  const T &operator[](size_type i) const noexcept { return m_data[i]; }
+
+  T &front() noexcept { return m_data[0]; }
+
+  const T &front() const noexcept { return m_data[0]; }
+
+  T &back() noexcept { return m_data[m_size - 1]; }
+
+  const T &back() const noexcept { return m_data[m_size - 1]; }
+
+  friend bool operator==(const try_vector &lhs, const try_vector &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  template <typename... Args> static T *construct(T *p, Args &&...args) {
+    return std::construct_at(p, std::forward<Args>(args)...);
+  }
+
+  // Outcome of the operations that may allocate. Unlike a
+  // result<try_vector &, alloc_error>, it doesn't hold the address of the
+  // vector: the members of a vector that doesn't escape stay in registers.
+  using status = result<empty_tag_t, alloc_error>;
+
+  result<try_vector &, alloc_error> self(status s) noexcept {
+    if (s.is_err()) {
+      return result<try_vector &, alloc_error>(err_tag, s.err_unchecked());
+    }
+    return result<try_vector &, alloc_error>(ok_tag, *this);
+  }
+
+  template <typename... Args>
+  result<T &, alloc_error> grow_emplace_back(Args &&...args) {
+    T *element = nullptr;
+    const status s = grow(
+        m_size + 1,
+        [&](T *dest) {
+          element = construct(dest, std::forward<Args>(args)...);
+        },
+        1);
+    if (s.is_err()) {
+      return result<T &, alloc_error>(err_tag, s.err_unchecked());
+    }
+    return result<T &, alloc_error>(ok_tag, *element);
+  }
+
+  status append(std::span<const T> values) {
+    if (values.size() > max_size() - m_size) {
+      return status(err_tag, alloc_error::capacity_overflow);
+    }
+    if (values.size() > m_capacity - m_size) {
+      return grow(
+          m_size + values.size(),
+          [&values](T *dest) {
+            std::uninitialized_copy_n(values.data(), values.size(), dest);
+          },
+          values.size());
+    }
+    append_unchecked(values);
+    return status(ok_tag);
+  }
+
+  status reserve(size_type capacity) noexcept {
+    if (capacity > m_capacity) {
+      if (capacity > max_size()) {
+        return status(err_tag, alloc_error::capacity_overflow);
+      }
+      T *data = details::try_allocate(m_alloc, capacity);
+      if (data == nullptr) {
+        return status(err_tag, alloc_error::out_of_memory);
+      }
+      adopt(data, capacity);
+    }
+    return status(ok_tag);
+  }
+
+  // Move to a larger buffer, constructing count elements at its end with
+  // construct_tail before relocating the current ones: the arguments of
+  // construct_tail may refer to elements of this vector.
+  template <typename F>
+  status grow(size_type needed, F &&construct_tail, size_type count) {
+    if (needed > max_size()) {
+      return status(err_tag, alloc_error::capacity_overflow);
+    }
+    size_type capacity =
+        details::grown_capacity(m_capacity, needed, max_size());
+    T *data = details::try_allocate(m_alloc, capacity);
+    if (data == nullptr && capacity > needed) {
+      capacity = needed;
+      data = details::try_allocate(m_alloc, capacity);
+    }
+    if (data == nullptr) {
+      return status(err_tag, alloc_error::out_of_memory);
+    }
+    // Frees the new buffer if construct_tail throws.
+    struct buffer_guard {
+      Alloc &alloc;
+      T *data;
+      size_type capacity;
+      ~buffer_guard() {
+        if (data != nullptr) {
+          traits::deallocate(alloc, data, capacity);
+        }
+      }
+    } guard{m_alloc, data, capacity};
+    construct_tail(data + m_size);
+    guard.data = nullptr;
+    adopt(data, capacity);
+    m_size += count;
+    return status(ok_tag);
+  }
+
+  template <typename F> status resize_with(size_type size, F &&construct_n) {
+    if (size <= m_size) {
+      std::destroy_n(m_data + size, m_size - size);
+      m_size = size;
+      return status(ok_tag);
+    }
+    const size_type count = size - m_size;
+    if (size > m_capacity) {
+      return grow(
+          size, [&](T *dest) { construct_n(dest, count); }, count);
+    }
+    construct_n(m_data + m_size, count);
+    m_size = size;
+    return status(ok_tag);
+  }
+
+  // Relocate the elements to data, which becomes the buffer of the vector.
+  void adopt(T *data, size_type capacity) noexcept {
+    relocate_n(m_data, m_size, data);
+    release();
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  // Free the buffer, if any. The elements must be destroyed or relocated
+  // already.
+  void release() noexcept {
+    if (m_data != nullptr) {
+      traits::deallocate(m_alloc, m_data, m_capacity);
+      m_data = nullptr;
+      m_capacity = 0;
+    }
+  }
+
+  [[no_unique_address]] Alloc m_alloc;
+  T *m_data = nullptr;
+  size_type m_size = 0;
+  size_type m_capacity = 0;
+};
+
+/// String whose appends return a result instead of throwing, see
+/// try_vector. Once the string has allocated, its characters are followed by
+/// a null character, kept in the spare capacity: c_str() never allocates.
+/// \tparam Alloc allocator of char, see nothrow_allocator
+template <typename Alloc = nothrow_allocator<char>> class basic_try_string {
+public:
+  using value_type = char;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+  using iterator = char *;
+  using const_iterator = const char *;
+
+  basic_try_string() noexcept(std::is_nothrow_default_constructible_v<Alloc>) =
+      default;
+
+  explicit basic_try_string(const Alloc &alloc) noexcept : m_chars(alloc) {}
+
+  /// A string holding a copy of text.
+  static result<basic_try_string, alloc_error>
+  try_from(std::string_view text, const Alloc &alloc = Alloc()) noexcept {
+    basic_try_string s(alloc);
+    if (const auto r = s.try_append(text); r.is_err()) {
+      return result<basic_try_string, alloc_error>(err_tag, r.err_unchecked());
+    }
+    return result<basic_try_string, alloc_error>(ok_tag, std::move(s));
+  }
+
+  /// Append text, which may be a part of this string.
+  result<basic_try_string &, alloc_error>
+  try_append(std::string_view text) noexcept {
+    if (text.empty()) {
+      return result<basic_try_string &, alloc_error>(ok_tag, *this);
+    }
+    if (text.size() >= m_chars.capacity() - m_chars.size()) {
+      // text moves along with the characters if it is a part of them.
+      const char *chars = m_chars.data();
+      const bool inside = std::less_equal<>()(chars, text.data()) &&
+                          std::less<>()(text.data(), chars + m_chars.size());
+      const size_type offset = inside ? text.data() - chars : 0;
+      if (const auto r = grow_for(text.size()); r.is_err()) {
+        return result<basic_try_string &, alloc_error>(err_tag,
+                                                       r.err_unchecked());
+      }
+      if (inside) {
+        text = std::string_view(m_chars.data() + offset, text.size());
+      }
+    }
+    m_chars.append_unchecked(std::span<const char>(text.data(), text.size()));
+    write_null();
+    return result<basic_try_string &, alloc_error>(ok_tag, *this);
+  }
+
+  result<basic_try_string &, alloc_error> try_push_back(char c) noexcept {
+    if (m_chars.capacity() - m_chars.size() < 2) {
+      if (const auto r = grow_for(1); r.is_err()) {
+        return result<basic_try_string &, alloc_error>(err_tag,
+                                                       r.err_unchecked());
+      }
+    }
+    m_chars.emplace_back_unchecked(c);
+    write_null();
+    return result<basic_try_string &, alloc_error>(ok_tag, *this);
+  }
+
+  result<basic_try_string &, alloc_error>
+  try_reserve(size_type capacity) noexcept {
+    if (capacity > max_size()) {
+      return result<basic_try_string &, alloc_error>(
+          err_tag, alloc_error::capacity_overflow);
+    }
+    if (capacity > this->capacity()) {
+      if (const auto r = m_chars.try_reserve(capacity + 1); r.is_err()) {
+        return result<basic_try_string &, alloc_error>(err_tag,
+                                                       r.err_unchecked());
+      }
+      write_null();
+    }
+    return result<basic_try_string &, alloc_error>(ok_tag, *this);
+  }
+
+  void clear() noexcept {
+    m_chars.clear();
+    if (m_chars.capacity() != 0) {
+      write_null();
+    }
+  }
+
+  size_type size() const noexcept { return m_chars.size(); }
+
+  size_type capacity() const noexcept {
+    return m_chars.capacity() == 0 ? 0 : m_chars.capacity() - 1;
+  }
+
+  size_type max_size() const noexcept { return m_chars.max_size() - 1; }
+
+  bool empty() const noexcept { return m_chars.empty(); }
+
+  allocator_type get_allocator() const noexcept {
+    return m_chars.get_allocator();
+  }
+
+  const char *data() const noexcept { return c_str(); }
+
+  /// The characters followed by a null character.
+  const char *c_str() const noexcept {
+    return m_chars.capacity() == 0 ? "" : m_chars.data();
+  }
+
+  std::string_view view() const noexcept { return {c_str(), size()}; }
+
+  operator std::string_view() const noexcept { return view(); }
+
+  const_iterator begin() const noexcept { return c_str(); }
+
+  const_iterator end() const noexcept { return c_str() + size(); }
+
+  char operator[](size_type i) const noexcept { return m_chars[i]; }
+
+  friend bool operator==(const basic_try_string &lhs,
+                         std::string_view rhs) noexcept {
+    return lhs.view() == rhs;
+  }
+
+private:
+  // Make room for count more characters and the null character. Out of
+  // line, to keep the appends small enough to be inlined.
+  [[gnu::noinline]] result<empty_tag_t, alloc_error>
+  grow_for(size_type count) noexcept {
+    using status = result<empty_tag_t, alloc_error>;
+    const size_type size = m_chars.size();
+    if (count > max_size() - size) {
+      return status(err_tag, alloc_error::capacity_overflow);
+    }
+    const size_type needed = size + count + 1;
+    // Short strings start with as much room as the small buffer of a
+    // std::string, rather than growing one character at a time.
+    const size_type capacity = std::max<size_type>(
+        details::grown_capacity(m_chars.capacity(), needed, m_chars.max_size()),
+        min_capacity);
+    if (m_chars.try_reserve(capacity).is_err()) {
+      if (const auto r = m_chars.try_reserve(needed); r.is_err()) {
+        return status(err_tag, r.err_unchecked());
+      }
+    }
+    return status(ok_tag);
+  }
+
+  // Write the null character after the characters, within the capacity.
+  void write_null() noexcept {
+    std::construct_at(m_chars.data() + m_chars.size(), '\0');
+  }
+
+  static constexpr size_type min_capacity = 16;
+
+  try_vector<char, Alloc> m_chars;
+};
+
+using try_string = basic_try_string<>;
+
+} // namespace result
+
+#endif // RESULT_FALLIBLE_HPP
@@ -0,0 +1,203 @@
+#ifndef RESULT_INTEROP_HPP
+#define RESULT_INTEROP_HPP
+
+#include "result.hpp"
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+namespace result {
+
+// Conversions between result and the standard vocabulary types. They
+// construct the target in place from the payload of the source, so the
+// payload is moved (or copied) exactly once.
+
+/// Convert a result<T, empty_tag_t> to an optional: ok values become the
+/// contained value, err results std::nullopt.
+template <typename T>
+constexpr std::optional<T> to_optional(result<T, empty_tag_t> &&r) noexcept(
+    std::is_nothrow_move_constructible_v<T>) {
+  if (r.is_ok()) {
+    return std::optional<T>(std::in_place, std::move(r).ok_unchecked());
+  }
+  return std::nullopt;
+}
+
+template <typename T>
+constexpr std::optional<T>
+to_optional(const result<T, empty_tag_t> &r) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) {
+  if (r.is_ok()) {
+    return std::optional<T>(std::in_place, r.ok_unchecked());
+  }
+  return std::nullopt;
+}
+
+/// Convert an optional to a result<T, empty_tag_t>: std::nullopt becomes
+/// an err result.
+template <typename T>
+constexpr result<T, empty_tag_t> from_optional(std::optional<T> &&o) noexcept(
+    std::is_nothrow_move_constructible_v<T>) {
+  if (o.has_value()) {
+    return result<T, empty_tag_t>(ok_tag, std::move(*o));
+  }
+  return result<T, empty_tag_t>(err_tag);
+}
+
+template <typename T>
+constexpr result<T, empty_tag_t>
+from_optional(const std::optional<T> &o) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) {
+  if (o.has_value()) {
+    return result<T, empty_tag_t>(ok_tag, *o);
+  }
+  return result<T, empty_tag_t>(err_tag);
+}
+
+/// Convert an optional to a result<T, E> with error as the err value of
+/// std::nullopt.
+template <typename T, typename E>
+constexpr result<T, std::remove_cvref_t<E>> from_optional(std::optional<T> &&o,
+                                                          E &&error) {
+  if (o.has_value()) {
+    return result<T, std::remove_cvref_t<E>>(ok_tag, std::move(*o));
+  }
+  return result<T, std::remove_cvref_t<E>>(err_tag, std::forward<E>(error));
+}
+
+template <typename T, typename E>
+constexpr result<T, std::remove_cvref_t<E>>
+from_optional(const std::optional<T> &o, E &&error) {
+  if (o.has_value()) {
+    return result<T, std::remove_cvref_t<E>>(ok_tag, *o);
+  }
+  return result<T, std::remove_cvref_t<E>>(err_tag, std::forward<E>(error));
+}
+
+/// An ok result equals an optional holding an equal value, an err result
+/// equals std::nullopt.
+template <typename T, typename U>
+constexpr bool operator==(const result<T, empty_tag_t> &lhs,
+                          const std::optional<U> &rhs) {
+  if (lhs.is_ok() != rhs.has_value()) {
+    return false;
+  }
+  return lhs.is_err() || lhs.ok_unchecked() == *rhs;
+}
+
+#if defined(__cpp_lib_expected)
+/// Convert a result to a std::expected holding the ok or err value.
+template <typename T, typename E>
+constexpr std::expected<T, E> to_expected(result<T, E> &&r) noexcept(
+    std::is_nothrow_move_constructible_v<T> &&
+    std::is_nothrow_move_constructible_v<E>) {
+  if (r.is_ok()) {
+    return std::expected<T, E>(std::in_place, std::move(r).ok_unchecked());
+  }
+  return std::expected<T, E>(std::unexpect, std::move(r).err_unchecked());
+}
+
+template <typename T, typename E>
+constexpr std::expected<T, E> to_expected(const result<T, E> &r) noexcept(
+    std::is_nothrow_copy_constructible_v<T> &&
+    std::is_nothrow_copy_constructible_v<E>) {
+  if (r.is_ok()) {
+    return std::expected<T, E>(std::in_place, r.ok_unchecked());
+  }
+  return std::expected<T, E>(std::unexpect, r.err_unchecked());
+}
+
+/// Convert a std::expected to a result holding the value or error.
+template <typename T, typename E>
+constexpr result<T, E> from_expected(std::expected<T, E> &&e) noexcept(
+    std::is_nothrow_move_constructible_v<T> &&
+    std::is_nothrow_move_constructible_v<E>) {
+  if (e.has_value()) {
+    return result<T, E>(ok_tag, std::move(*e));
+  }
+  return result<T, E>(err_tag, std::move(e).error());
+}
+
+template <typename T, typename E>
+constexpr result<T, E> from_expected(const std::expected<T, E> &e) noexcept(
+    std::is_nothrow_copy_constructible_v<T> &&
+    std::is_nothrow_copy_constructible_v<E>) {
+  if (e.has_value()) {
+    return result<T, E>(ok_tag, *e);
+  }
+  return result<T, E>(err_tag, e.error());
+}
+
+/// std::expected<void, E> maps to result<empty_tag_t, E>.
+template <typename E>
+constexpr std::expected<void, E>
+to_expected(result<empty_tag_t, E> &&r) noexcept(
+    std::is_nothrow_move_constructible_v<E>) {
+  if (r.is_ok()) {
+    return std::expected<void, E>();
+  }
+  return std::expected<void, E>(std::unexpect, std::move(r).err_unchecked());
+}
+
+template <typename E>
+constexpr std::expected<void, E>
+to_expected(const result<empty_tag_t, E> &r) noexcept(
+    std::is_nothrow_copy_constructible_v<E>) {
+  if (r.is_ok()) {
+    return std::expected<void, E>();
+  }
+  return std::expected<void, E>(std::unexpect, r.err_unchecked());
+}
+
+template <typename E>
+constexpr result<empty_tag_t, E>
+from_expected(std::expected<void, E> &&e) noexcept(
+    std::is_nothrow_move_constructible_v<E>) {
+  if (e.has_value()) {
+    return result<empty_tag_t, E>(ok_tag);
+  }
+  return result<empty_tag_t, E>(err_tag, std::move(e).error());
+}
+
+template <typename E>
+constexpr result<empty_tag_t, E>
+from_expected(const std::expected<void, E> &e) noexcept(
+    std::is_nothrow_copy_constructible_v<E>) {
+  if (e.has_value()) {
+    return result<empty_tag_t, E>(ok_tag);
+  }
+  return result<empty_tag_t, E>(err_tag, e.error());
+}
+
+/// A result equals a std::expected in the same state with an equal value
+/// or error.
+template <typename T, typename E, typename U, typename G>
+  requires(!std::is_void_v<U>)
+constexpr bool operator==(const result<T, E> &lhs,
+                          const std::expected<U, G> &rhs) {
+  if (lhs.is_ok() != rhs.has_value()) {
+    return false;
+  }
+  if (lhs.is_ok()) {
+    return lhs.ok_unchecked() == *rhs;
+  }
+  return lhs.err_unchecked() == rhs.error();
+}
+
+template <typename E, typename G>
+constexpr bool operator==(const result<empty_tag_t, E> &lhs,
+                          const std::expected<void, G> &rhs) {
+  if (lhs.is_ok() != rhs.has_value()) {
+    return false;
+  }
+  return lhs.is_ok() || lhs.err_unchecked() == rhs.error();
+}
+#endif
+
+} // namespace result
+
+#endif // RESULT_INTEROP_HPP
@@ -0,0 +1,319 @@
+#ifndef RESULT_IO_HPP
+#define RESULT_IO_HPP
+
+#include "result.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace result {
+
+/// The I/O operation that failed.
+enum class io_op : std::uint8_t { open, stat, map, advise, seek, read, write };
+
+/// Error type of the I/O functions: the operation that failed and the value
+/// of errno it set.
+struct io_error {
+  io_op op;
+  int sys_errno = 0;
+
+  /// sys_errno as a std::error_code, e.g. to print its message.
+  std::error_code code() const noexcept {
+    return {sys_errno, std::generic_category()};
+  }
+
+  constexpr bool operator==(const io_error &) const = default;
+};
+
+template <typename T> using io_result = result<T, io_error>;
+
+using io_status = result<empty_tag_t, io_error>;
+
+namespace details {
+// Allocator whose value-less construct() default-initializes: resizing a
+// vector of bytes doesn't zero the bytes that read() is about to overwrite.
+template <typename T> struct default_init_allocator : std::allocator<T> {
+  template <typename U> struct rebind {
+    using other = default_init_allocator<U>;
+  };
+
+  default_init_allocator() noexcept = default;
+
+  template <typename U>
+  default_init_allocator(const default_init_allocator<U> &) noexcept {}
+
+  template <typename U>
+  void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void *>(p)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U *p, Args &&...args) {
+    std::allocator_traits<std::allocator<T>>::construct(
+        *this, p, std::forward<Args>(args)...);
+  }
+};
+} // namespace details
+
+/// Bytes read by read_all. Growing it leaves the new bytes uninitialized.
+using byte_buffer =
+    std::vector<std::byte, details::default_init_allocator<std::byte>>;
+
+/// How a mapped file is going to be accessed, passed to madvise.
+enum class map_advice : std::uint8_t {
+  normal,
+  /// Read ahead aggressively and drop pages once read.
+  sequential,
+  /// Don't read ahead.
+  random,
+  /// Start reading the pages in now.
+  will_need
+};
+
+namespace details {
+template <typename T> io_result<T> io_err(io_op op, int e = errno) noexcept {
+  return io_result<T>(err_tag, io_error{op, e});
+}
+
+// Closes a file descriptor when leaving the scope.
+struct fd_guard {
+  int fd;
+
+  ~fd_guard() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+};
+
+constexpr int madvise_flag(map_advice advice) noexcept {
+  switch (advice) {
+  case map_advice::sequential:
+    return MADV_SEQUENTIAL;
+  case map_advice::random:
+    return MADV_RANDOM;
+  case map_advice::will_need:
+    return MADV_WILLNEED;
+  default:
+    return MADV_NORMAL;
+  }
+}
+} // namespace details
+
+/// Read-only memory mapping of a whole file, see map_file().
+///
+/// The bytes stay valid until the mapped_file is destroyed, even if the file
+/// is closed or removed, but change if another process writes to the file.
+class mapped_file {
+public:
+  mapped_file() noexcept = default;
+
+  mapped_file(mapped_file &&other) noexcept
+      : m_addr(std::exchange(other.m_addr, nullptr)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+  mapped_file &operator=(mapped_file &&rhs) noexcept {
+    if (this != &rhs) {
+      unmap();
+      m_addr = std::exchange(rhs.m_addr, nullptr);
+      m_size = std::exchange(rhs.m_size, 0);
+    }
+    return *this;
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  ~mapped_file() { unmap(); }
+
+  const std::byte *data() const noexcept {
+    return static_cast<const std::byte *>(m_addr);
+  }
+
+  std::size_t size() const noexcept { return m_size; }
+
+  bool empty() const noexcept { return m_size == 0; }
+
+  std::span<const std::byte> bytes() const noexcept { return {data(), m_size}; }
+
+  /// The bytes as characters, e.g. to parse a text file in place.
+  std::string_view view() const noexcept {
+    return {static_cast<const char *>(m_addr), m_size};
+  }
+
+  /// Give the kernel a new hint about how the whole file is going to be
+  /// accessed.
+  io_status advise(map_advice advice) const noexcept {
+    if (m_size != 0 &&
+        ::madvise(m_addr, m_size, details::madvise_flag(advice)) != 0) {
+      return details::io_err<empty_tag_t>(io_op::advise);
+    }
+    return io_status(ok_tag);
+  }
+
+private:
+  friend io_result<mapped_file> map_file(const char *path,
+                                         map_advice advice) noexcept;
+
+  mapped_file(void *addr, std::size_t size) noexcept
+      : m_addr(addr), m_size(size) {}
+
+  void unmap() noexcept {
+    if (m_addr != nullptr) {
+      ::munmap(m_addr, m_size);
+      m_addr = nullptr;
+    }
+  }
+
+  void *m_addr = nullptr;
+  std::size_t m_size = 0;
+};
+
+/// Map the file at path in memory, read-only, and pass advice to madvise.
+///
+/// madvise is only a hint: its failure isn't an error of map_file. An empty
+/// file is mapped to an empty mapped_file.
+/// \code
+/// auto file = result::map_file("input.csv");
+/// if (file.is_err()) {
+///   std::cerr << file.err_unchecked().code().message() << '\n';
+/// }
+/// \endcode
+inline io_result<mapped_file>
+map_file(const char *path,
+         map_advice advice = map_advice::sequential) noexcept {
+  const details::fd_guard file{::open(path, O_RDONLY | O_CLOEXEC)};
+  if (file.fd < 0) {
+    return details::io_err<mapped_file>(io_op::open);
+  }
+  struct stat st {};
+  if (::fstat(file.fd, &st) != 0) {
+    return details::io_err<mapped_file>(io_op::stat);
+  }
+  const auto size = static_cast<std::size_t>(st.st_size);
+  if (size == 0) {
+    return io_result<mapped_file>(ok_tag);
+  }
+  void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file.fd, 0);
+  if (addr == MAP_FAILED) {
+    return details::io_err<mapped_file>(io_op::map);
+  }
+  ::madvise(addr, size, details::madvise_flag(advice));
+  return io_result<mapped_file>(ok_tag, mapped_file(addr, size));
+}
+
+/// Read from fd at offset until buffer is full or the end of the file,
+/// without moving the file offset, retrying reads interrupted by signals.
+/// \returns the number of bytes read, less than buffer.size() only at the
+/// end of the file
+inline io_result<std::size_t> pread(int fd, std::span<std::byte> buffer,
+                                    off_t offset) noexcept {
+  std::size_t done = 0;
+  while (done < buffer.size()) {
+    const ssize_t n = ::pread(fd, buffer.data() + done, buffer.size() - done,
+                              offset + static_cast<off_t>(done));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return details::io_err<std::size_t>(io_op::read);
+    }
+    if (n == 0) {
+      break;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return io_result<std::size_t>(ok_tag, done);
+}
+
+/// Write all of buffer to fd at offset, without moving the file offset,
+/// retrying writes interrupted by signals or partial.
+inline io_status pwrite(int fd, std::span<const std::byte> buffer,
+                        off_t offset) noexcept {
+  std::size_t done = 0;
+  while (done < buffer.size()) {
+    const ssize_t n = ::pwrite(fd, buffer.data() + done, buffer.size() - done,
+                               offset + static_cast<off_t>(done));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return details::io_err<empty_tag_t>(io_op::write);
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return io_status(ok_tag);
+}
+
+/// Read fd from its offset to the end of the file.
+///
+/// The bytes left in a regular file are read into a single allocation of
+/// their size. Other files, such as pipes, are read into a buffer growing
+/// geometrically. The buffer isn't zeroed before the bytes are read into
+/// it.
+inline io_result<byte_buffer> read_all(int fd) {
+  using ret_type = io_result<byte_buffer>;
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    return details::io_err<byte_buffer>(io_op::stat);
+  }
+  // One byte more than the file holds, to see its end without growing.
+  std::size_t expected = 64 * 1024;
+  if (S_ISREG(st.st_mode)) {
+    const off_t offset = ::lseek(fd, 0, SEEK_CUR);
+    if (offset < 0) {
+      return details::io_err<byte_buffer>(io_op::seek);
+    }
+    expected = offset < st.st_size
+                   ? static_cast<std::size_t>(st.st_size - offset) + 1
+                   : 1;
+  }
+  byte_buffer bytes(expected);
+  std::size_t size = 0;
+  while (true) {
+    if (size == bytes.size()) {
+      // The file grew since fstat, or isn't a regular file.
+      bytes.resize(bytes.size() * 2);
+    }
+    const ssize_t n = ::read(fd, bytes.data() + size, bytes.size() - size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return details::io_err<byte_buffer>(io_op::read);
+    }
+    if (n == 0) {
+      break;
+    }
+    size += static_cast<std::size_t>(n);
+  }
+  bytes.resize(size);
+  return ret_type(ok_tag, std::move(bytes));
+}
+
+/// Read the whole file at path, see read_all(int).
+inline io_result<byte_buffer> read_all(const char *path) {
+  const details::fd_guard file{::open(path, O_RDONLY | O_CLOEXEC)};
+  if (file.fd < 0) {
+    return details::io_err<byte_buffer>(io_op::open);
+  }
+  return read_all(file.fd);
+}
+
+} // namespace result
+
+#endif // RESULT_IO_HPP
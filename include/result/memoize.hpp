@@ -0,0 +1,407 @@
+#ifndef RESULT_MEMOIZE_HPP
+#define RESULT_MEMOIZE_HPP
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace result {
+
+/// Bounds of the caches of a memoize.
+struct memoize_options {
+  /// Number of ok values kept. Once full, the least recently used value is
+  /// evicted.
+  std::size_t capacity = 1024;
+  /// Number of err results kept, 0 to call the function again on every
+  /// failure. Once full, the least recently used error is evicted.
+  std::size_t error_capacity = 0;
+  /// How long an err result is returned from the cache.
+  std::chrono::steady_clock::duration error_ttl = std::chrono::seconds(1);
+  /// Number of independently locked parts of the caches, rounded up to a
+  /// power of two. The capacities are split among them as evenly as
+  /// possible. Fewer shards are used if a non-zero capacity is smaller
+  /// than their number, so that every shard caches values and errors.
+  std::size_t shards = 16;
+  /// Current time, for the expiry of errors.
+  std::chrono::steady_clock::time_point (*now)() noexcept =
+      &std::chrono::steady_clock::now;
+};
+
+/// Counters of a memoize, summed over its shards.
+struct memoize_stats {
+  /// Calls answered with a cached ok value.
+  std::size_t hits = 0;
+  /// Calls answered with a cached err result.
+  std::size_t error_hits = 0;
+  /// Calls of the function.
+  std::size_t misses = 0;
+  /// Calls that waited for a concurrent call of the function with the same
+  /// arguments instead of calling it again.
+  std::size_t shared = 0;
+  /// Values and errors dropped to stay within the capacities.
+  std::size_t evictions = 0;
+
+  friend bool operator==(const memoize_stats &,
+                         const memoize_stats &) = default;
+};
+
+namespace details {
+// A key of a lookup together with its hash, computed once per call rather
+// than once per map searched.
+template <typename K> struct hashed_key {
+  const K &key;
+  std::size_t hash;
+};
+
+template <typename K> const K &unhashed(const K &key) noexcept { return key; }
+
+template <typename K> const K &unhashed(const hashed_key<K> &key) noexcept {
+  return key.key;
+}
+
+// Hash and equality of the argument tuples of a memoize. Transparent, so
+// that a lookup with a tuple of references doesn't copy the arguments.
+struct memoize_key_hash {
+  using is_transparent = void;
+
+  template <typename... Ts>
+  std::size_t operator()(const std::tuple<Ts...> &key) const {
+    hash_state h;
+    hash_append(h, key);
+    return h.finish();
+  }
+
+  template <typename K>
+  std::size_t operator()(const hashed_key<K> &key) const noexcept {
+    return key.hash;
+  }
+};
+
+struct memoize_key_equal {
+  using is_transparent = void;
+
+  template <typename L, typename R>
+  bool operator()(const L &lhs, const R &rhs) const {
+    return unhashed(lhs) == unhashed(rhs);
+  }
+};
+
+// Map of at most capacity entries, which evicts the least recently used
+// entry to make room for a new one. Not thread-safe.
+template <typename K, typename V> class lru_map {
+  using list_type = std::list<std::pair<K, V>>;
+
+public:
+  explicit lru_map(std::size_t capacity) : m_capacity(capacity) {}
+
+  std::size_t size() const noexcept { return m_index.size(); }
+
+  // The value of key, now the most recently used, or nullptr.
+  template <typename Q> V *find(const Q &key) {
+    const auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->second;
+  }
+
+  template <typename Q> void erase(const Q &key) {
+    const auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      m_entries.erase(it->second);
+      m_index.erase(it);
+    }
+  }
+
+  // Insert or replace the value of key.
+  // \returns the number of entries evicted
+  std::size_t insert(K key, V value) {
+    if (m_capacity == 0) {
+      return 0;
+    }
+    if (V *v = find(key)) {
+      *v = std::move(value);
+      return 0;
+    }
+    std::size_t evicted = 0;
+    if (m_index.size() == m_capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+      evicted = 1;
+    }
+    m_entries.emplace_front(std::move(key), std::move(value));
+    try {
+      m_index.emplace(m_entries.front().first, m_entries.begin());
+    } catch (...) {
+      m_entries.pop_front();
+      throw;
+    }
+    return evicted;
+  }
+
+  void clear() noexcept {
+    m_index.clear();
+    m_entries.clear();
+  }
+
+private:
+  std::size_t m_capacity;
+  list_type m_entries;
+  std::unordered_map<K, typename list_type::iterator, memoize_key_hash,
+                     memoize_key_equal>
+      m_index;
+};
+} // namespace details
+
+/// Cache of the results of a function returning result<T, E>.
+///
+/// Ok values are kept up to a capacity, least recently used first out. Err
+/// results are only kept if options.error_capacity isn't 0, and for
+/// options.error_ttl: repeated failures don't call the function again until
+/// the error expires.
+///
+/// The cache is split into shards, selected by the hash of the arguments
+/// (see hash_append), each with its own lock, so that calls with different
+/// arguments rarely contend. Concurrent calls with the same arguments
+/// that miss the cache call the function once: the others wait for it and
+/// return its result (or exception).
+///
+/// The function may be called from several threads at once, but never
+/// with the lock of a shard held.
+/// \code
+/// result::memoize<decltype(&resolve), std::string> cached(&resolve);
+/// auto address = cached("example.org"); // calls resolve
+/// address = cached("example.org");      // from the cache
+/// \endcode
+/// \tparam F function object called with const Args &...
+/// \tparam Args the arguments, which must be copyable, equality comparable
+/// and hashable by hash_append. The cache keeps a copy of them.
+template <typename F, typename... Args>
+  requires is_result<std::invoke_result_t<F &, const Args &...>>::value
+class memoize {
+public:
+  using key_type = std::tuple<Args...>;
+  using result_type = std::invoke_result_t<F &, const Args &...>;
+  using value_type = typename result_type::value_type;
+  using error_type = typename result_type::error_type;
+
+  explicit memoize(F fun, const memoize_options &options = {})
+      : m_fun(std::move(fun)),
+        m_shard_count(shard_count(options)),
+        m_shards(std::make_unique<shard[]>(m_shard_count)),
+        m_error_ttl(options.error_ttl), m_now(options.now) {
+    for (std::size_t i = 0; i < m_shard_count; ++i) {
+      m_shards[i].init(per_shard(options.capacity, i),
+                       per_shard(options.error_capacity, i));
+    }
+  }
+
+  memoize(const memoize &) = delete;
+  memoize &operator=(const memoize &) = delete;
+
+  /// The result of fun(args...), from the cache if possible.
+  result_type operator()(const Args &...args) {
+    const auto arguments = std::forward_as_tuple(args...);
+    const details::hashed_key<decltype(arguments)> key{
+        arguments, details::memoize_key_hash{}(arguments)};
+    // The shard is selected with the high half of the hash, the buckets of
+    // the maps of a shard with the low bits.
+    constexpr int high_half = std::numeric_limits<std::size_t>::digits / 2;
+    shard &s = m_shards[(key.hash >> high_half) & (m_shard_count - 1)];
+    std::unique_lock lock(s.mutex);
+    if (const stored_value *v = s.values.find(key)) {
+      ++s.stats.hits;
+      return result_type(ok_tag, static_cast<const value_type &>(*v));
+    }
+    if (const cached_error *e = s.errors.find(key)) {
+      if (m_now() < e->expiry) {
+        ++s.stats.error_hits;
+        return result_type(err_tag, e->error);
+      }
+      s.errors.erase(key);
+    }
+    if (const auto it = s.flights.find(key); it != s.flights.end()) {
+      const std::shared_ptr<flight> f = it->second;
+      ++s.stats.shared;
+      s.landed.wait(lock, [&f] { return f->done; });
+      if (f->exception) {
+        std::rethrow_exception(f->exception);
+      }
+      return *f->value;
+    }
+
+    const auto f = std::make_shared<flight>();
+    s.flights.emplace(arguments, f);
+    ++s.stats.misses;
+    lock.unlock();
+    std::optional<result_type> r;
+    try {
+      r.emplace(std::invoke(m_fun, args...));
+    } catch (...) {
+      f->exception = std::current_exception();
+    }
+    lock.lock();
+    s.flights.erase(s.flights.find(key));
+    {
+      // Wake the waiting calls, even if caching the result throws.
+      struct landing_guard {
+        flight &f;
+        std::unique_lock<std::mutex> &lock;
+        std::condition_variable &landed;
+        ~landing_guard() {
+          f.done = true;
+          lock.unlock();
+          landed.notify_all();
+        }
+      } guard{*f, lock, s.landed};
+      if (r) {
+        try {
+          cache(s, arguments, *r);
+          // Only copy the result if another call is waiting for it.
+          if (f.use_count() > 1) {
+            f->value = r;
+          }
+        } catch (...) {
+          f->exception = std::current_exception();
+          throw;
+        }
+      }
+    }
+    if (f->exception) {
+      std::rethrow_exception(f->exception);
+    }
+    return std::move(*r);
+  }
+
+  /// Drop every cached value and error.
+  void clear() {
+    for (std::size_t i = 0; i < m_shard_count; ++i) {
+      const std::lock_guard lock(m_shards[i].mutex);
+      m_shards[i].values.clear();
+      m_shards[i].errors.clear();
+    }
+  }
+
+  /// Number of cached values and errors.
+  std::size_t size() const {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < m_shard_count; ++i) {
+      const std::lock_guard lock(m_shards[i].mutex);
+      n += m_shards[i].values.size() + m_shards[i].errors.size();
+    }
+    return n;
+  }
+
+  memoize_stats stats() const {
+    memoize_stats total;
+    for (std::size_t i = 0; i < m_shard_count; ++i) {
+      const std::lock_guard lock(m_shards[i].mutex);
+      const memoize_stats &s = m_shards[i].stats;
+      total.hits += s.hits;
+      total.error_hits += s.error_hits;
+      total.misses += s.misses;
+      total.shared += s.shared;
+      total.evictions += s.evictions;
+    }
+    return total;
+  }
+
+private:
+  // The cached ok values, references of a result<T &, E> as
+  // reference_wrapper.
+  using stored_value =
+      std::conditional_t<std::is_reference_v<value_type>,
+                         std::reference_wrapper<
+                             std::remove_reference_t<value_type>>,
+                         value_type>;
+
+  struct cached_error {
+    error_type error;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  // A call of the function in progress.
+  struct flight {
+    bool done = false;
+    std::optional<result_type> value;
+    std::exception_ptr exception;
+  };
+
+  // On a cache line of its own, so that threads working on different
+  // shards don't share lines.
+  struct alignas(details::cache_line) shard {
+    void init(std::size_t capacity, std::size_t error_capacity) {
+      values = details::lru_map<key_type, stored_value>(capacity);
+      errors = details::lru_map<key_type, cached_error>(error_capacity);
+    }
+
+    mutable std::mutex mutex;
+    std::condition_variable landed;
+    details::lru_map<key_type, stored_value> values{0};
+    details::lru_map<key_type, cached_error> errors{0};
+    std::unordered_map<key_type, std::shared_ptr<flight>,
+                       details::memoize_key_hash, details::memoize_key_equal>
+        flights;
+    memoize_stats stats;
+  };
+
+  // options.shards rounded up to a power of two, and down to one that
+  // leaves no shard with a capacity of 0 where the total isn't 0.
+  static std::size_t shard_count(const memoize_options &options) noexcept {
+    std::size_t n = std::bit_ceil(std::max<std::size_t>(options.shards, 1));
+    for (const std::size_t capacity :
+         {options.capacity, options.error_capacity}) {
+      if (capacity != 0) {
+        n = std::min(n, std::bit_floor(capacity));
+      }
+    }
+    return n;
+  }
+
+  // The part of capacity of shard i. The parts sum to capacity.
+  std::size_t per_shard(std::size_t capacity, std::size_t i) const noexcept {
+    return capacity / m_shard_count + (i < capacity % m_shard_count ? 1 : 0);
+  }
+
+  template <typename K>
+  void cache(shard &s, const K &key, const result_type &r) {
+    if (r.is_ok()) {
+      s.stats.evictions += s.values.insert(key_type(key), r.ok_unchecked());
+    } else {
+      const auto expiry = m_now() + m_error_ttl;
+      s.stats.evictions += s.errors.insert(
+          key_type(key), cached_error{r.err_unchecked(), expiry});
+    }
+  }
+
+  F m_fun;
+  std::size_t m_shard_count;
+  std::unique_ptr<shard[]> m_shards;
+  std::chrono::steady_clock::duration m_error_ttl;
+  std::chrono::steady_clock::time_point (*m_now)() noexcept;
+};
+
+template <typename R, typename... Args>
+memoize(R (*)(Args...), const memoize_options & = {})
+    -> memoize<R (*)(Args...), std::remove_cvref_t<Args>...>;
+
+} // namespace result
+
+#endif // RESULT_MEMOIZE_HPP
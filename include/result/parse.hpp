@@ -0,0 +1,362 @@
+#ifndef RESULT_PARSE_HPP
+#define RESULT_PARSE_HPP
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace result {
+
+/// Why a text couldn't be parsed as a number.
+enum class parse_errc : std::uint8_t {
+  /// The text is empty.
+  empty,
+  /// The text doesn't start with a number.
+  invalid_character,
+  /// The number doesn't fit in the type parsed.
+  out_of_range,
+  /// The number is followed by other characters.
+  trailing_characters,
+};
+
+/// Error type of the parse functions.
+/// \c position is the offset in the text of the first character that isn't
+/// part of the number, 0 for an empty text or a number out of range. It has
+/// 32 bits, so that a result<std::int64_t, parse_error> fits in two
+/// registers: longer texts report at most UINT32_MAX.
+struct parse_error {
+  parse_errc kind;
+  std::uint32_t position = 0;
+
+  constexpr bool operator==(const parse_error &) const = default;
+};
+
+template <typename T> using parse_result = result<T, parse_error>;
+
+namespace details {
+template <typename T>
+concept parsable_integer =
+    std::integral<T> && !std::same_as<std::remove_cv_t<T>, bool>;
+
+// The digit functions read 8 characters at a time as a little endian word,
+// the first character in the low byte. Other platforms read one character
+// at a time.
+inline constexpr bool swar_digits = std::endian::native == std::endian::little;
+
+template <typename T> parse_result<T> parse_err(parse_errc kind,
+                                                std::size_t position) noexcept {
+  constexpr std::size_t max = std::numeric_limits<std::uint32_t>::max();
+  return parse_result<T>(
+      err_tag, parse_error{kind, static_cast<std::uint32_t>(
+                                     position < max ? position : max)});
+}
+
+inline std::uint64_t load_8(const char *p) noexcept {
+  std::uint64_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+// The bytes of word that aren't ASCII digits have their high bit set. The
+// bytes after the first such byte may be wrong: the addition carries into
+// them.
+constexpr std::uint64_t non_digits(std::uint64_t word) noexcept {
+  const std::uint64_t x = word ^ 0x3030303030303030;
+  return (x | (x + 0x7676767676767676)) & 0x8080808080808080;
+}
+
+// Value of the 8 ASCII digits of word: pairs of digits are combined with
+// one multiplication, then pairs of pairs with two.
+constexpr std::uint32_t eight_digits(std::uint64_t word) noexcept {
+  constexpr std::uint64_t mask = 0x000000FF000000FF;
+  constexpr std::uint64_t mul1 = 100 + (1000000ULL << 32);
+  constexpr std::uint64_t mul2 = 1 + (10000ULL << 32);
+  word -= 0x3030303030303030;
+  word = word * 10 + (word >> 8);
+  return static_cast<std::uint32_t>(
+      ((word & mask) * mul1 + ((word >> 16) & mask) * mul2) >> 32);
+}
+
+constexpr bool is_digit(char c) noexcept {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+inline constexpr std::uint64_t powers_of_10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL};
+
+struct digit_run {
+  std::size_t count;
+  std::uint64_t value;
+};
+
+// The digits at the start of [first, last), up to max <= 19 of them, and
+// their value, in one pass.
+inline digit_run scan_digits(const char *first, const char *last,
+                             std::size_t max) noexcept {
+  const char *p = first;
+  std::uint64_t value = 0;
+  if constexpr (swar_digits) {
+    while (last - p >= 8 &&
+           max - static_cast<std::size_t>(p - first) >= 8) {
+      const std::uint64_t word = load_8(p);
+      const std::uint64_t nd = non_digits(word);
+      if (nd == 0) {
+        value = value * 100000000 + eight_digits(word);
+        p += 8;
+        continue;
+      }
+      // The k digits before the first non digit, shifted to the end of the
+      // word and preceded by zeros.
+      const int k = std::countr_zero(nd) / 8;
+      if (k != 0) {
+        const std::uint64_t digits = (word << (64 - 8 * k)) |
+                                     (0x3030303030303030 >> (8 * k));
+        value = value * powers_of_10[k] + eight_digits(digits);
+      }
+      return {static_cast<std::size_t>(p - first) + k, value};
+    }
+    // Fewer than 8 characters are left after at least 8 digits: read the 8
+    // characters ending the text, the first of which are those digits.
+    const std::size_t count = static_cast<std::size_t>(p - first);
+    if (p != last && last - p < 8 && count >= 8 && count < max) {
+      const std::size_t left = static_cast<std::size_t>(last - p);
+      const std::uint64_t word = load_8(last - 8);
+      const std::uint64_t nd = non_digits(word);
+      const std::size_t end =
+          nd == 0 ? 8 : static_cast<std::size_t>(std::countr_zero(nd)) / 8;
+      const std::size_t k = std::min(end - (8 - left), max - count);
+      if (k == 0) {
+        return {count, value};
+      }
+      // The k digits shifted to the end of the word, preceded by zeros.
+      const std::uint64_t zeros = (1ULL << (8 * (8 - k))) - 1;
+      const std::uint64_t digits = ((word << (8 * (left - k))) & ~zeros) |
+                                   (0x3030303030303030 & zeros);
+      return {count + k, value * powers_of_10[k] + eight_digits(digits)};
+    }
+  }
+  while (p != last && is_digit(*p) &&
+         static_cast<std::size_t>(p - first) < max) {
+    value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+    ++p;
+  }
+  return {static_cast<std::size_t>(p - first), value};
+}
+
+// The digits at the start of [first, last), shorter than 8 characters.
+constexpr digit_run scan_short(const char *first, const char *last) noexcept {
+  const char *p = first;
+  std::uint64_t value = 0;
+  for (; p != last && is_digit(*p); ++p) {
+    value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+  }
+  return {static_cast<std::size_t>(p - first), value};
+}
+
+// Any number std::from_chars can parse, the text must hold nothing else.
+template <typename T, typename... Args>
+parse_result<T> parse_from_chars(std::string_view text,
+                                 Args... args) noexcept {
+  if (text.empty()) {
+    return parse_err<T>(parse_errc::empty, 0);
+  }
+  const char *first = text.data();
+  const char *last = first + text.size();
+  T value;
+  const auto [end, ec] = std::from_chars(first, last, value, args...);
+  if (ec == std::errc::invalid_argument) {
+    // Past the sign, if T has one.
+    const bool sign = !std::is_unsigned_v<T> && *first == '-';
+    return parse_err<T>(parse_errc::invalid_character, sign ? 1 : 0);
+  }
+  if (ec == std::errc::result_out_of_range) {
+    return parse_err<T>(parse_errc::out_of_range, 0);
+  }
+  if (end != last) {
+    return parse_err<T>(parse_errc::trailing_characters,
+                        static_cast<std::size_t>(end - first));
+  }
+  return parse_result<T>(ok_tag, value);
+}
+
+template <typename T>
+parse_result<T> parse_integer(std::string_view text) noexcept {
+  using U = std::make_unsigned_t<T>;
+  if (text.empty()) {
+    return parse_err<T>(parse_errc::empty, 0);
+  }
+  const char *first = text.data();
+  const char *last = first + text.size();
+  const bool negative = std::is_signed_v<T> && *first == '-';
+  const char *digits = first + negative;
+  const digit_run run = last - digits < 8 ? scan_short(digits, last)
+                                          : scan_digits(digits, last, 19);
+  std::size_t n = run.count;
+  if (n == 0) {
+    return parse_err<T>(parse_errc::invalid_character,
+                        static_cast<std::size_t>(digits - first));
+  }
+  std::uint64_t magnitude = run.value;
+  if (n == 19 && last - digits > 19 && is_digit(digits[19])) {
+    // 19 digits always fit in 64 bits, 20 may. Longer numbers, which may
+    // have leading zeros, are left to std::from_chars.
+    if (last - digits > 20 && is_digit(digits[20])) {
+      return parse_from_chars<T>(text);
+    }
+    const std::uint64_t digit = static_cast<std::uint64_t>(digits[19] - '0');
+    constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    if (magnitude > (max - digit) / 10) {
+      return parse_err<T>(parse_errc::out_of_range, 0);
+    }
+    magnitude = magnitude * 10 + digit;
+    n = 20;
+  }
+  const std::uint64_t limit =
+      static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + negative;
+  if (magnitude > limit) {
+    return parse_err<T>(parse_errc::out_of_range, 0);
+  }
+  if (digits + n != last) {
+    return parse_err<T>(parse_errc::trailing_characters,
+                        static_cast<std::size_t>(digits + n - first));
+  }
+  const U value = static_cast<U>(magnitude);
+  return parse_result<T>(ok_tag,
+                         static_cast<T>(negative ? U(0) - value : value));
+}
+
+// Powers of ten exactly representable as a T.
+template <typename T> struct exact_powers;
+
+template <> struct exact_powers<double> {
+  static constexpr std::size_t max_exponent = 22;
+  static constexpr std::uint64_t max_mantissa = 1ULL << 53;
+  static constexpr double values[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+template <> struct exact_powers<float> {
+  static constexpr std::size_t max_exponent = 10;
+  static constexpr std::uint64_t max_mantissa = 1ULL << 24;
+  static constexpr float values[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                     1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+};
+
+template <typename T>
+parse_result<T> parse_floating(std::string_view text) noexcept {
+  // Plain decimals, such as -123.456, whose digits and power of ten are both
+  // exact in T: their quotient is the correctly rounded value (Clinger's
+  // fast path). Other numbers are left to std::from_chars.
+  if constexpr ((std::is_same_v<T, double> || std::is_same_v<T, float>) &&
+                std::numeric_limits<T>::is_iec559 && FLT_EVAL_METHOD == 0) {
+    const char *first = text.data();
+    const char *last = first + text.size();
+    const bool negative = !text.empty() && *first == '-';
+    const char *p = first + negative;
+    // At most 19 digits, any more are left on the text.
+    const digit_run whole = scan_digits(p, last, 19);
+    std::uint64_t mantissa = whole.value;
+    p += whole.count;
+    std::size_t fraction = 0;
+    if (p != last && *p == '.') {
+      ++p;
+      const digit_run decimals = scan_digits(p, last, 19 - whole.count);
+      fraction = decimals.count;
+      mantissa = mantissa * powers_of_10[fraction] + decimals.value;
+      p += fraction;
+    }
+    if (p == last && whole.count + fraction != 0 &&
+        mantissa <= exact_powers<T>::max_mantissa &&
+        fraction <= exact_powers<T>::max_exponent) {
+      const T value =
+          static_cast<T>(mantissa) / exact_powers<T>::values[fraction];
+      return parse_result<T>(ok_tag, negative ? -value : value);
+    }
+  }
+  return parse_from_chars<T>(text);
+}
+} // namespace details
+
+/// Parse text, which must hold a decimal number and nothing else, as a T.
+///
+/// The syntax is that of std::from_chars: an optional minus sign (for signed
+/// and floating point types), no leading whitespace or plus sign. Floating
+/// point numbers may have an exponent, or be inf or nan.
+///
+/// Digits are validated and converted 8 at a time (SWAR) on little endian
+/// platforms, and plain decimals such as 12.5 are converted without
+/// std::from_chars. The values are those of std::from_chars.
+/// \code
+/// const auto port = result::parse<std::uint16_t>("8080");
+/// const auto load = result::parse<double>("0.75");
+/// \endcode
+template <typename T>
+  requires details::parsable_integer<T> || std::floating_point<T>
+parse_result<T> parse(std::string_view text) noexcept {
+  if constexpr (std::floating_point<T>) {
+    return details::parse_floating<T>(text);
+  } else {
+    return details::parse_integer<T>(text);
+  }
+}
+
+/// Parse text as an integer in base, from 2 to 36, see std::from_chars.
+template <details::parsable_integer T>
+parse_result<T> parse(std::string_view text, int base) noexcept {
+  if (base == 10) {
+    return details::parse_integer<T>(text);
+  }
+  return details::parse_from_chars<T>(text, base);
+}
+
+/// Parse each of texts as a T into the result of out at the same index.
+/// out must hold at least texts.size() results, e.g. a
+/// result::pmr::result_vector<T, parse_error> resized to texts.size().
+/// \returns the number of texts that couldn't be parsed
+template <typename T>
+  requires details::parsable_integer<T> || std::floating_point<T>
+std::size_t parse_many(std::span<const std::string_view> texts,
+                       std::span<parse_result<T>> out) noexcept {
+  std::size_t errors = 0;
+  for (std::size_t i = 0; i < texts.size(); ++i) {
+    out[i] = parse<T>(texts[i]);
+    errors += out[i].is_err();
+  }
+  return errors;
+}
+
+} // namespace result
+
+#endif // RESULT_PARSE_HPP
@@ -0,0 +1,51 @@
+#ifndef RESULT_PMR_HPP
+#define RESULT_PMR_HPP
+
+#include "result.hpp"
+
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace result::pmr {
+
+// Results of the std::pmr containers. Through std::uses_allocator they take
+// their memory resource from the allocator-aware container holding them:
+// \code
+// std::pmr::monotonic_buffer_resource arena;
+// std::pmr::vector<result::pmr::string_result<int>> rows(&arena);
+// rows.emplace_back(result::ok_tag, "stored in arena");
+// \endcode
+
+template <typename E> using string_result = result<std::pmr::string, E>;
+
+template <typename T, typename E>
+using vector_result = result<std::pmr::vector<T>, E>;
+
+/// A std::pmr::vector of results, whose payloads use the resource of the
+/// vector.
+template <typename T, typename E>
+using result_vector = std::pmr::vector<result<T, E>>;
+
+/// Construct a result<T, E> holding an ok value constructed from args with
+/// memory from resource.
+template <typename T, typename E, typename... Args>
+result<T, E> make_ok(std::pmr::memory_resource *resource, Args &&...args) {
+  return result<T, E>(std::allocator_arg,
+                      std::pmr::polymorphic_allocator<>(resource), ok_tag,
+                      std::forward<Args>(args)...);
+}
+
+/// Construct a result<T, E> holding an err value constructed from args with
+/// memory from resource.
+template <typename T, typename E, typename... Args>
+result<T, E> make_err(std::pmr::memory_resource *resource, Args &&...args) {
+  return result<T, E>(std::allocator_arg,
+                      std::pmr::polymorphic_allocator<>(resource), err_tag,
+                      std::forward<Args>(args)...);
+}
+
+} // namespace result::pmr
+
+#endif // RESULT_PMR_HPP
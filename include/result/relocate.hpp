@@ -0,0 +1,64 @@
+#ifndef RESULT_RELOCATE_HPP
+#define RESULT_RELOCATE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace result {
+
+/// Whether an object of type T can be relocated, moved to new storage and
+/// the source destroyed, by copying its bytes. This holds for trivially
+/// copyable types and for most types that own their resources through a
+/// pointer, but not for types pointing into themselves, like a std::string
+/// with a small buffer.
+///
+/// Defaults to std::is_trivially_copyable. Specialize it as std::true_type
+/// for a type known to be relocatable:
+/// \code
+/// template <>
+/// struct result::is_trivially_relocatable<my_handle> : std::true_type {};
+/// \endcode
+/// result<T, E> and error_set<Es...> are trivially relocatable when all of
+/// their payloads are.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+/// Relocate n objects from first to the uninitialized storage at dest, for
+/// instance when a container grows. The ranges must not overlap. Trivially
+/// relocatable objects are copied with a single memcpy, other objects are
+/// constructed from std::move_if_noexcept of the sources, which are then
+/// destroyed. If a constructor throws, the objects constructed at dest are
+/// destroyed and the source range is left untouched, unless T is neither
+/// nothrow move constructible nor copy constructible: the sources are then
+/// moved from.
+/// \returns the end of the destination range
+template <typename T>
+T *relocate_n(T *first, std::size_t n, T *dest) noexcept(
+    is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+  if constexpr (is_trivially_relocatable_v<T>) {
+    if (n != 0) {
+      std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                  n * sizeof(T));
+    }
+    return dest + n;
+  } else if constexpr (std::is_nothrow_move_constructible_v<T> ||
+                       !std::is_copy_constructible_v<T>) {
+    T *last = std::uninitialized_move_n(first, n, dest).second;
+    std::destroy_n(first, n);
+    return last;
+  } else {
+    T *last = std::uninitialized_copy_n(first, n, dest);
+    std::destroy_n(first, n);
+    return last;
+  }
+}
+
+} // namespace result
+
+#endif // RESULT_RELOCATE_HPP
@@ -1,11 +1,52 @@
 #ifndef RESULT_RESULT_HPP
 #define RESULT_RESULT_HPP
 
+#include <bit>
 #include <compare>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+
+#include "error_set.hpp"
+#include "relocate.hpp"
+
+/// RESULT_CHECKED_ACCESS selects what ok_unchecked() and err_unchecked() do
+/// with a result in the other state:
+/// - 1: terminate with a message. The default in debug builds (NDEBUG not
+///   defined) and with AddressSanitizer or ThreadSanitizer. Compilers don't
+///   tell UndefinedBehaviorSanitizer builds apart: define it to 1 for them.
+/// - 0: nothing, as documented. The state is instead given to the optimizer
+///   as an assumption, so that checks of the state after an unchecked
+///   access are removed.
+///
+/// Define it before including any header of the library, to the same value
+/// in every translation unit of a program.
+#ifndef RESULT_CHECKED_ACCESS
+#if defined(__has_feature)
+#define RESULT_DETAILS_SANITIZED                                               \
+  (__has_feature(address_sanitizer) || __has_feature(thread_sanitizer))
+#elif defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define RESULT_DETAILS_SANITIZED 1
+#else
+#define RESULT_DETAILS_SANITIZED 0
+#endif
+#if !defined(NDEBUG) || RESULT_DETAILS_SANITIZED
+#define RESULT_CHECKED_ACCESS 1
+#else
+#define RESULT_CHECKED_ACCESS 0
+#endif
+#undef RESULT_DETAILS_SANITIZED
+#endif
 
 namespace result {
 
@@ -54,7 +95,7 @@ constexpr empty_tag_t empty_tag = empty_tag_t{};
 constexpr bool operator==(empty_tag_t, empty_tag_t) { return true; }
 constexpr bool operator!=(empty_tag_t, empty_tag_t) { return false; }
 
-enum class result_type { ok, err };
+enum class result_type : std::uint8_t { ok, err };
 
 // constexpr bool operator==(const result_type& lhs,const result_type& rhs ) {
 //   if ((lhs == result_type::ok && rhs == result_type::ok) &&
@@ -78,11 +119,11 @@ public:
   [[maybe_unused]] constexpr T &&value() && { return std::move(m_value); }
 
   template <typename E> constexpr operator result<T, E>() const & {
-    return result<T, E>(oke(m_value));
+    return result<T, E>(ok_tag, m_value);
   }
 
   template <typename E> constexpr operator result<T, E>() && {
-    return result<T, E>(ok(std::move(m_value)));
+    return result<T, E>(ok_tag, std::move(m_value));
   }
 
 private:
@@ -102,6 +143,23 @@ public:
 
 ok() -> ok<empty_tag_t>;
 
+/// ok value of a result<T &, E>: holds a reference to the value.
+template <typename T> class ok<T &> {
+public:
+  using value_type [[maybe_unused]] = T &;
+
+  explicit constexpr ok(T &value) noexcept : m_value(std::addressof(value)) {}
+
+  constexpr T &value() const noexcept { return *m_value; }
+
+  template <typename E> constexpr operator result<T &, E>() const {
+    return result<T &, E>(ok_tag, *m_value);
+  }
+
+private:
+  T *m_value;
+};
+
 template <typename T> class err {
 public:
   using value_type [[maybe_unused]] = T;
@@ -112,6 +170,14 @@ public:
   constexpr const T &value() const & { return m_value; }
   [[maybe_unused]] constexpr T &&value() && { return std::move(m_value); }
 
+  template <typename U> constexpr operator result<U, T>() const & {
+    return result<U, T>(err_tag, m_value);
+  }
+
+  template <typename U> constexpr operator result<U, T>() && {
+    return result<U, T>(err_tag, std::move(m_value));
+  }
+
 private:
   T m_value;
 };
@@ -127,12 +193,340 @@ public:
   }
 };
 
+/// Reference to an ok value that converts to any result<U, E> able to hold
+/// it.
+///
+/// Unlike ok<T>, ok_ref doesn't store a copy of the value: the result is
+/// constructed directly from the referenced expression, so
+/// \code
+/// return result::ok_ref(make_large_value());
+/// \endcode
+/// moves the value once, straight into the storage of the returned result.
+/// An ok_ref must not outlive the full expression it is created in.
+/// \tparam T type of the referenced expression, an lvalue reference for
+///           lvalues (copied) or a non-reference type for rvalues (moved)
+template <typename T> class ok_ref {
+public:
+  using value_type [[maybe_unused]] = std::remove_cvref_t<T>;
+
+  explicit constexpr ok_ref(T &&value) noexcept
+      : m_value(std::addressof(value)) {}
+
+  template <typename U, typename E>
+    requires std::is_constructible_v<U, T &&>
+  constexpr operator result<U, E>() const {
+    return result<U, E>(ok_tag, std::forward<T>(*m_value));
+  }
+
+private:
+  std::remove_reference_t<T> *m_value;
+};
+
+template <typename T> ok_ref(T &&) -> ok_ref<T>;
+
+/// Reference to an err value that converts to any result<U, E> able to
+/// hold it. See ok_ref.
+template <typename T> class err_ref {
+public:
+  using value_type [[maybe_unused]] = std::remove_cvref_t<T>;
+
+  explicit constexpr err_ref(T &&value) noexcept
+      : m_value(std::addressof(value)) {}
+
+  template <typename U, typename E>
+    requires std::is_constructible_v<E, T &&>
+  constexpr operator result<U, E>() const {
+    return result<U, E>(err_tag, std::forward<T>(*m_value));
+  }
+
+private:
+  std::remove_reference_t<T> *m_value;
+};
+
+template <typename T> err_ref(T &&) -> err_ref<T>;
+
 namespace details {
 inline void terminate(const std::string_view &msg) {
   std::cerr << msg << std::endl;
   std::terminate();
 }
 
+// Check, or with RESULT_CHECKED_ACCESS == 0 assume, that a result is in the
+// state an unchecked accessor expects.
+constexpr void expect_state([[maybe_unused]] bool expected,
+                            [[maybe_unused]] const char *msg) noexcept {
+#if RESULT_CHECKED_ACCESS
+  if (!expected) {
+    terminate(msg);
+  }
+#elif __has_cpp_attribute(assume) >= 202207L
+  [[assume(expected)]];
+#elif defined(__clang__)
+  __builtin_assume(expected);
+#elif defined(_MSC_VER)
+  __assume(expected);
+#else
+  if (!expected) {
+    __builtin_unreachable();
+  }
+#endif
+}
+
+// Size of a cache line, for the types shared between threads. Fixed rather
+// than std::hardware_destructive_interference_size, which depends on
+// compiler flags: the layout of a header-only type must not.
+inline constexpr std::size_t cache_line = 64;
+} // namespace details
+
+namespace details {
+/// How a payload of type T is stored inside a result: objects are stored
+/// by value, references as a pointer to the referenced object.
+template <typename T> struct payload {
+  using stored_type = T;
+
+  template <typename... Args>
+  static constexpr void construct(stored_type &s, Args &&...args) {
+    std::construct_at(std::addressof(s), std::forward<Args>(args)...);
+  }
+
+  static constexpr T &get(stored_type &s) noexcept { return s; }
+
+  static constexpr const T &get(const stored_type &s) noexcept { return s; }
+
+  static constexpr void destroy(stored_type &s) noexcept {
+    std::destroy_at(std::addressof(s));
+  }
+};
+
+template <typename T> struct payload<T &> {
+  using stored_type = T *;
+
+  static constexpr void construct(stored_type &s, T &ref) noexcept {
+    std::construct_at(std::addressof(s), std::addressof(ref));
+  }
+
+  static constexpr T &get(stored_type s) noexcept { return *s; }
+
+  static constexpr void destroy(stored_type &) noexcept {}
+};
+
+template <typename T>
+inline constexpr bool trivially_destructible_payload_v =
+    std::is_trivially_destructible_v<typename payload<T>::stored_type>;
+
+template <typename T>
+inline constexpr bool trivially_copyable_payload_v =
+    std::is_trivially_copyable_v<typename payload<T>::stored_type>;
+
+template <typename T>
+inline constexpr bool trivially_relocatable_payload_v =
+    is_trivially_relocatable_v<typename payload<T>::stored_type>;
+
+// Exception specifications of the special members of result. They follow
+// the stored payloads: a reference payload is stored as a pointer, so it
+// never throws. Assigning to a result either assigns the payloads or
+// destroys the old one and constructs the new one, so assignments depend
+// on both the construction and the assignment of a payload.
+
+template <typename T>
+inline constexpr bool nothrow_copy_constructible_payload_v =
+    std::is_nothrow_copy_constructible_v<typename payload<T>::stored_type>;
+
+template <typename T>
+inline constexpr bool nothrow_move_constructible_payload_v =
+    std::is_nothrow_move_constructible_v<typename payload<T>::stored_type>;
+
+template <typename T>
+inline constexpr bool nothrow_copy_assignable_payload_v =
+    nothrow_copy_constructible_payload_v<T> &&
+    std::is_nothrow_copy_assignable_v<typename payload<T>::stored_type>;
+
+template <typename T>
+inline constexpr bool nothrow_move_assignable_payload_v =
+    nothrow_move_constructible_payload_v<T> &&
+    std::is_nothrow_move_assignable_v<typename payload<T>::stored_type>;
+
+template <typename T>
+inline constexpr bool nothrow_swappable_payload_v =
+    nothrow_move_constructible_payload_v<T> &&
+    std::is_nothrow_swappable_v<typename payload<T>::stored_type>;
+
+/// Arguments constructing a payload of type T with the allocator alloc,
+/// following uses-allocator construction. References don't use allocators.
+template <typename T, typename Alloc, typename... Args>
+constexpr auto uses_allocator_args(const Alloc &alloc, Args &&...args) {
+  if constexpr (std::is_reference_v<T>) {
+    return std::forward_as_tuple(std::forward<Args>(args)...);
+  } else {
+    return std::uses_allocator_construction_args<T>(
+        alloc, std::forward<Args>(args)...);
+  }
+}
+
+/// Union of both payloads. The active member is tracked by result_storage.
+template <typename T, typename E> union result_union {
+  constexpr result_union() noexcept {}
+  constexpr ~result_union()
+    requires(trivially_destructible_payload_v<T> &&
+             trivially_destructible_payload_v<E>)
+  = default;
+  constexpr ~result_union() {}
+
+  typename payload<T>::stored_type ok;
+  typename payload<E>::stored_type err;
+};
+
+/// Storage of a result: the union of both payloads followed by a one byte
+/// discriminant. An empty T or E takes one byte in the union, so it only
+/// adds to its size when the other payload is empty too.
+template <typename T, typename E> class result_storage {
+public:
+  constexpr bool is_ok() const noexcept { return m_type == result_type::ok; }
+
+  template <typename... Args> constexpr void construct_ok(Args &&...args) {
+    payload<T>::construct(m_data.ok, std::forward<Args>(args)...);
+    m_type = result_type::ok;
+  }
+
+  template <typename... Args> constexpr void construct_err(Args &&...args) {
+    payload<E>::construct(m_data.err, std::forward<Args>(args)...);
+    m_type = result_type::err;
+  }
+
+  constexpr void destroy() noexcept {
+    if (is_ok()) {
+      payload<T>::destroy(m_data.ok);
+    } else {
+      payload<E>::destroy(m_data.err);
+    }
+  }
+
+  constexpr decltype(auto) ok_value() noexcept {
+    return payload<T>::get(m_data.ok);
+  }
+
+  constexpr decltype(auto) ok_value() const noexcept {
+    return payload<T>::get(m_data.ok);
+  }
+
+  constexpr E &err_value() noexcept { return m_data.err; }
+
+  constexpr const E &err_value() const noexcept { return m_data.err; }
+
+private:
+  result_union<T, E> m_data;
+  result_type m_type;
+};
+
+/// Storage of a result with two empty, trivial payload types: only the
+/// discriminant is stored, so the result is a single byte. Empty trivial
+/// types have no state, the accessors return a shared instance.
+template <typename T, typename E>
+  requires(std::is_empty_v<T> && std::is_empty_v<E> && std::is_trivial_v<T> &&
+           std::is_trivial_v<E>)
+class result_storage<T, E> {
+public:
+  constexpr bool is_ok() const noexcept { return m_type == result_type::ok; }
+
+  template <typename... Args> constexpr void construct_ok(Args &&...args) {
+    static_cast<void>(T(std::forward<Args>(args)...));
+    m_type = result_type::ok;
+  }
+
+  template <typename... Args> constexpr void construct_err(Args &&...args) {
+    static_cast<void>(E(std::forward<Args>(args)...));
+    m_type = result_type::err;
+  }
+
+  constexpr void destroy() noexcept {}
+
+  static T &ok_value() noexcept { return s_ok; }
+
+  static E &err_value() noexcept { return s_err; }
+
+private:
+  static inline T s_ok{};
+  static inline E s_err{};
+
+  result_type m_type;
+};
+
+/// Error types that fit in the address range no object can live in.
+template <typename E>
+concept pointer_niche =
+    std::is_same_v<E, empty_tag_t> || (std::is_enum_v<E> && sizeof(E) == 1);
+
+/// Storage of a result<T &, E> with an empty or single byte enum error type.
+///
+/// The result is the size of a pointer: an ok result stores the address of
+/// the referenced object, an err result stores the error in the low order
+/// byte of a value below niche_limit. No object can be located in the first
+/// page of the address space on the supported platforms, so an address is
+/// never mistaken for an error.
+template <typename T, typename E>
+  requires pointer_niche<E>
+class result_storage<T &, E> {
+public:
+  static constexpr std::uintptr_t niche_limit = 256;
+
+  bool is_ok() const noexcept { return bits() >= niche_limit; }
+
+  void construct_ok(T &ref) noexcept {
+    T *ptr = std::addressof(ref);
+    std::memcpy(m_raw, &ptr, sizeof(ptr));
+  }
+
+  template <typename... Args> void construct_err(Args &&...args) {
+    std::memset(m_raw, 0, sizeof(m_raw));
+    new (m_raw + err_offset) E(std::forward<Args>(args)...);
+  }
+
+  void destroy() noexcept {}
+
+  T &ok_value() const noexcept {
+    T *ptr;
+    std::memcpy(&ptr, m_raw, sizeof(ptr));
+    return *ptr;
+  }
+
+  E &err_value() noexcept {
+    return *std::launder(reinterpret_cast<E *>(m_raw + err_offset));
+  }
+
+  const E &err_value() const noexcept {
+    return *std::launder(reinterpret_cast<const E *>(m_raw + err_offset));
+  }
+
+private:
+  static constexpr std::size_t err_offset =
+      std::endian::native == std::endian::little
+          ? 0
+          : sizeof(std::uintptr_t) - sizeof(E);
+
+  std::uintptr_t bits() const noexcept {
+    std::uintptr_t b;
+    std::memcpy(&b, m_raw, sizeof(b));
+    return b;
+  }
+
+  alignas(std::uintptr_t) unsigned char m_raw[sizeof(std::uintptr_t)];
+};
+
+// Return type of match(on_ok, on_err): the type both handlers return, else
+// their common type.
+template <typename R1, typename R2> struct match_result {
+  static_assert(requires { typename std::common_type<R1, R2>::type; },
+                "match(on_ok, on_err) requires both handlers to return the "
+                "same type, or types with a common type");
+  using type = std::common_type_t<R1, R2>;
+};
+
+template <typename R> struct match_result<R, R> {
+  using type = R;
+};
+
+template <typename R1, typename R2>
+using match_result_t = typename match_result<R1, R2>::type;
 } // namespace details
 
 /// result is a type to represent either a value (ok) or failure (err).
@@ -143,14 +537,12 @@ template <typename T, typename E> class result {
 public:
   using value_type [[maybe_unused]] = T;
   using error_type [[maybe_unused]] = E;
-  using data_type = std::aligned_union_t<1, T, E>;
 
-  static_assert(std::is_same<std::remove_reference_t<T>, T>::value,
-                "result<T, E> can't store reference types. "
-                "Try using `std::reference_wrapper`");
   static_assert(std::is_same<std::remove_reference_t<E>, E>::value,
-                "result<T, E> can't store reference types. "
+                "result<T, E> can't store reference error types. "
                 "Try using `std::reference_wrapper`");
+  static_assert(!std::is_rvalue_reference_v<T>,
+                "result<T, E> can't store rvalue references.");
   static_assert(!std::is_same<T, void>::value,
                 "result<T, E> can't be created with T=void. "
                 "Try replacing T with `empty_tag_t`");
@@ -158,212 +550,268 @@ public:
                 "result<T, E> can't be created with E=void. "
                 "Try replacing E with `empty_tag_t`");
 
-  friend class ok<T>;
-  friend class err<E>;
+  friend class ::result::ok<T>;
+  friend class ::result::err<E>;
+
+private:
+  static constexpr bool trivially_destructible =
+      details::trivially_destructible_payload_v<T> &&
+      details::trivially_destructible_payload_v<E>;
+
+  static constexpr bool trivially_copyable =
+      details::trivially_copyable_payload_v<T> &&
+      details::trivially_copyable_payload_v<E>;
+
+  static constexpr bool nothrow_copy_constructible =
+      details::nothrow_copy_constructible_payload_v<T> &&
+      details::nothrow_copy_constructible_payload_v<E>;
+
+  static constexpr bool nothrow_move_constructible =
+      details::nothrow_move_constructible_payload_v<T> &&
+      details::nothrow_move_constructible_payload_v<E>;
 
-  constexpr result() {
+  static constexpr bool nothrow_copy_assignable =
+      details::nothrow_copy_assignable_payload_v<T> &&
+      details::nothrow_copy_assignable_payload_v<E>;
+
+  static constexpr bool nothrow_move_assignable =
+      details::nothrow_move_assignable_payload_v<T> &&
+      details::nothrow_move_assignable_payload_v<E>;
+
+public:
+
+  constexpr result() noexcept(std::is_nothrow_default_constructible_v<T>) {
     static_assert(std::is_default_constructible<T>::value,
                   "result<T, E> can only be default constructed if T "
                   "is default constructible.");
+    m_storage.construct_ok();
   }
 
-  constexpr result(ok<T> value) {
-    if constexpr (!std::is_same_v<T, empty_tag_t>) {
-      new (std::addressof(m_data)) std::decay_t<T>(std::move(value).value());
-    }
-    m_type = result_type::ok;
+  constexpr result(const ::result::ok<T> &value) noexcept(
+      details::nothrow_copy_constructible_payload_v<T>) {
+    m_storage.construct_ok(value.value());
   }
 
-  constexpr result(err<E> value) {
-    if constexpr (!std::is_same_v<E, empty_tag_t>) {
-      new (std::addressof(m_data)) std::decay_t<E>(std::move(value).value());
-    }
-    m_type = result_type::err;
+  constexpr result(::result::ok<T> &&value) noexcept(
+      details::nothrow_move_constructible_payload_v<T>) {
+    m_storage.construct_ok(std::move(value).value());
+  }
+
+  constexpr result(const ::result::err<E> &value) noexcept(
+      std::is_nothrow_copy_constructible_v<E>) {
+    m_storage.construct_err(value.value());
+  }
+
+  constexpr result(::result::err<E> &&value) noexcept(
+      std::is_nothrow_move_constructible_v<E>) {
+    m_storage.construct_err(std::move(value).value());
+  }
+
+  template <typename... Args>
+  constexpr result(ok_tag_t, Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<T, Args &&...>) {
+    m_storage.construct_ok(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  constexpr result(err_tag_t, Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<E, Args &&...>) {
+    m_storage.construct_err(std::forward<Args>(args)...);
+  }
+
+  /// Allocator-extended constructors: the payload is constructed with alloc
+  /// by uses-allocator construction, so it is used by an allocator-aware T
+  /// or E and ignored otherwise. result<T, E> declares std::uses_allocator
+  /// when T or E does, so allocator-aware containers and
+  /// std::pmr::polymorphic_allocator pass their allocator on to the
+  /// payloads of the results they hold.
+  ///
+  /// The allocator is only used while constructing: an assignment that
+  /// changes the state of the result constructs the new payload as the
+  /// non-extended constructors do.
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc) {
+    construct_ok_with(alloc);
+  }
+
+  template <typename Alloc, typename... Args>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc, ok_tag_t,
+                   Args &&...args) {
+    construct_ok_with(alloc, std::forward<Args>(args)...);
+  }
+
+  template <typename Alloc, typename... Args>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc, err_tag_t,
+                   Args &&...args) {
+    construct_err_with(alloc, std::forward<Args>(args)...);
   }
 
-  template <typename... Args> constexpr result(ok_tag_t, Args &&...args) {
-    if constexpr (!std::is_same_v<T, empty_tag_t>) {
-      new (std::addressof(m_data)) std::decay_t<T>(std::forward<Args>(args)...);
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc,
+                   const ::result::ok<T> &value) {
+    construct_ok_with(alloc, value.value());
+  }
+
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc,
+                   ::result::ok<T> &&value) {
+    construct_ok_with(alloc, std::move(value).value());
+  }
+
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc,
+                   const ::result::err<E> &value) {
+    construct_err_with(alloc, value.value());
+  }
+
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc,
+                   ::result::err<E> &&value) {
+    construct_err_with(alloc, std::move(value).value());
+  }
+
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc,
+                   const result<T, E> &other) {
+    if (other.is_ok()) {
+      construct_ok_with(alloc, other.ok_unchecked());
+    } else {
+      construct_err_with(alloc, other.err_unchecked());
     }
-    m_type = result_type::ok;
   }
 
-  template <typename... Args> constexpr result(err_tag_t, Args &&...args) {
-    if constexpr (!std::is_same_v<E, empty_tag_t>) {
-      new (std::addressof(m_data)) std::decay_t<E>(std::forward<Args>(args)...);
+  template <typename Alloc>
+  constexpr result(std::allocator_arg_t, const Alloc &alloc,
+                   result<T, E> &&other) {
+    if (other.is_ok()) {
+      construct_ok_with(alloc, std::move(other).ok_unchecked());
+    } else {
+      construct_err_with(alloc, std::move(other).err_unchecked());
     }
-    m_type = result_type::err;
   }
 
+  // A result of trivially copyable payloads is trivially copyable itself,
+  // so it can be copied with memcpy and is passed and returned in
+  // registers where the ABI allows.
+  constexpr result(const result<T, E> &other)
+    requires(trivially_copyable)
+  = default;
+
+  constexpr result(result<T, E> &&other)
+    requires(trivially_copyable)
+  = default;
+
+  constexpr result<T, E> &operator=(const result<T, E> &rhs)
+    requires(trivially_copyable)
+  = default;
+
+  constexpr result<T, E> &operator=(result<T, E> &&rhs)
+    requires(trivially_copyable)
+  = default;
+
+  constexpr ~result()
+    requires(trivially_destructible)
+  = default;
+
   constexpr result(const result<T, E> &other) noexcept(
-      std::is_nothrow_copy_assignable_v<T>
-          &&std::is_nothrow_copy_assignable_v<E>) {
-    m_type = other.m_type;
-    if (m_type == result_type::ok) {
-      new (std::addressof(m_data)) std::decay_t<T>(other.template get<T>());
+      nothrow_copy_constructible) {
+    if (other.is_ok()) {
+      m_storage.construct_ok(other.ok_unchecked());
     } else {
-      new (std::addressof(m_data)) std::decay_t<E>(other.template get<E>());
+      m_storage.construct_err(other.err_unchecked());
     }
   }
 
   constexpr result(result<T, E> &&other) noexcept(
-      std::is_nothrow_move_assignable_v<T>
-          &&std::is_nothrow_move_assignable_v<E>) {
-    m_type = other.m_type;
-    if (m_type == result_type::ok) {
-      new (std::addressof(m_data))
-          std::decay_t<T>(std::move(other).template get<T>());
+      nothrow_move_constructible) {
+    if (other.is_ok()) {
+      m_storage.construct_ok(std::move(other).ok_unchecked());
     } else {
-      new (std::addressof(m_data))
-          std::decay_t<E>(std::move(other).template get<E>());
+      m_storage.construct_err(std::move(other).err_unchecked());
     }
   }
 
-  ~result() { destroy(); }
+  constexpr ~result() { m_storage.destroy(); }
 
   /// Assign another result to this instance.
-  /// If the result type changes, allocate space for the new data type.
+  /// If the result type changes, the old value is destroyed and the new one
+  /// constructed in its place. A result<T &, E> rebinds the reference, it
+  /// never assigns through it.
   constexpr result<T, E> &operator=(const result<T, E> &rhs) noexcept(
-      std::is_nothrow_copy_assignable_v<T>
-          &&std::is_nothrow_copy_assignable_v<E>) {
-    destroy();
-    bool reallocate = m_type != rhs.m_type;
-    m_type = rhs.m_type;
-    if (reallocate) {
-      if (m_type == result_type::ok) {
-        new (std::addressof(m_data)) std::decay_t<T>(rhs.template get<T>());
-      } else {
-        new (std::addressof(m_data)) std::decay_t<E>(rhs.template get<E>());
-      }
+      nothrow_copy_assignable) {
+    if (rhs.is_ok()) {
+      assign_ok(rhs.ok_unchecked());
     } else {
-      if (m_type == result_type::ok) {
-        T &value = get<T>();
-        value = rhs.template get<T>();
-      } else {
-        E &value = get<E>();
-        value = rhs.template get<E>();
-      }
+      assign_err(rhs.err_unchecked());
     }
     return *this;
   }
 
   /// Assign an ok value to this instance.
   /// If the result type changes, allocate space for the new data type.
-  constexpr result<T, E> &operator=(const ok<T> &rhs) noexcept(
-      std::is_nothrow_copy_assignable_v<T>
-          &&std::is_nothrow_copy_assignable_v<E>) {
-    destroy();
-    bool reallocate = m_type != result_type::ok;
-    m_type = result_type::ok;
-    if (reallocate) {
-      new (std::addressof(m_data)) std::decay_t<T>(rhs.value());
-    } else {
-      T &value = get<T>();
-      value = rhs.value();
-    }
+  constexpr result<T, E> &operator=(const ::result::ok<T> &rhs) noexcept(
+      details::nothrow_copy_assignable_payload_v<T>) {
+    assign_ok(rhs.value());
     return *this;
   }
 
   /// Assign an ok value to this instance.
   /// If the result type changes, allocate space for the new data type.
-  constexpr result<T, E> &
-  operator=(ok<T> &&rhs) noexcept(std::is_nothrow_copy_assignable_v<T>
-                                      &&std::is_nothrow_copy_assignable_v<E>) {
-    destroy();
-    bool reallocate = m_type != result_type::ok;
-    m_type = result_type::ok;
-    if (reallocate) {
-      new (std::addressof(m_data)) std::decay_t<T>(std::move(rhs).value());
-    } else {
-      T &value = get<T>();
-      value = std::move(rhs).value();
-    }
+  constexpr result<T, E> &operator=(::result::ok<T> &&rhs) noexcept(
+      details::nothrow_move_assignable_payload_v<T>) {
+    assign_ok(std::move(rhs).value());
     return *this;
   }
 
   /// Assign another result to this instance.
   /// If the result type changes, allocate space for the new data type.
   constexpr result<T, E> &operator=(result<T, E> &&rhs) noexcept(
-      std::is_nothrow_move_assignable_v<T>
-          &&std::is_nothrow_move_assignable_v<E>) {
-    destroy();
-    bool reallocate = m_type != rhs.m_type;
-    m_type = rhs.m_type;
-    if (reallocate) {
-      if (m_type == result_type::ok) {
-        new (std::addressof(m_data))
-            std::decay_t<T>(std::move(rhs).template get<T>());
-      } else {
-        new (std::addressof(m_data))
-            std::decay_t<E>(std::move(rhs).template get<E>());
-      }
+      nothrow_move_assignable) {
+    if (rhs.is_ok()) {
+      assign_ok(std::move(rhs).ok_unchecked());
     } else {
-      if (m_type == result_type::ok) {
-        T &value = get<T>();
-        value = std::move(rhs).template get<T>();
-      } else {
-        E &value = get<E>();
-        value = std::move(rhs).template get<E>();
-      }
+      assign_err(std::move(rhs).err_unchecked());
     }
     return *this;
   }
 
   /// Assign an err value to this instance.
   /// If the result type changes, allocate space for the new data type.
-  constexpr result<T, E> &operator=(const err<E> &rhs) noexcept(
-      std::is_nothrow_copy_assignable_v<T>
-          &&std::is_nothrow_copy_assignable_v<E>) {
-    destroy();
-    bool reallocate = m_type != result_type::err;
-    m_type = result_type::err;
-    if (reallocate) {
-      new (std::addressof(m_data)) std::decay_t<E>(rhs.value());
-    } else {
-      E &value = get<E>();
-      value = rhs.value();
-    }
+  constexpr result<T, E> &operator=(const ::result::err<E> &rhs) noexcept(
+      details::nothrow_copy_assignable_payload_v<E>) {
+    assign_err(rhs.value());
     return *this;
   }
 
   /// Assign an err value to this instance.
   /// If the result type changes, allocate space for the new data type.
-  constexpr result<T, E> &
-  operator=(err<E> &&rhs) noexcept(std::is_nothrow_copy_assignable_v<T>
-                                       &&std::is_nothrow_copy_assignable_v<E>) {
-    destroy();
-    bool reallocate = m_type != result_type::err;
-    m_type = result_type::err;
-    if (reallocate) {
-      new (std::addressof(m_data)) std::decay_t<E>(std::move(rhs).value());
-    } else {
-      E &value = get<E>();
-      value = std::move(rhs).value();
-    }
+  constexpr result<T, E> &operator=(::result::err<E> &&rhs) noexcept(
+      details::nothrow_move_assignable_payload_v<E>) {
+    assign_err(std::move(rhs).value());
     return *this;
   }
 
   constexpr explicit operator bool() const noexcept { return is_ok(); }
 
-  constexpr bool is_ok() const noexcept { return m_type == result_type::ok; }
+  constexpr bool is_ok() const noexcept { return m_storage.is_ok(); }
 
-  constexpr bool is_err() const noexcept { return m_type == result_type::err; }
+  constexpr bool is_err() const noexcept { return !m_storage.is_ok(); }
 
   constexpr bool operator==(const result<T, E> &rhs) const {
-    if (m_type != rhs.m_type) {
+    if (is_ok() != rhs.is_ok()) {
       return false;
     }
-    if (m_type == result_type::ok) {
+    if (is_ok()) {
       if constexpr (std::is_same_v<T, empty_tag_t>) {
         return true;
       } else {
-        return get<T>() == rhs.template get<T>();
+        return ok_unchecked() == rhs.ok_unchecked();
       }
     } else {
       if constexpr (std::is_same_v<E, empty_tag_t>) {
         return true;
       } else {
-        return get<E>() == rhs.template get<E>();
+        return err_unchecked() == rhs.err_unchecked();
       }
     }
   }
@@ -372,27 +820,27 @@ public:
     return !(*this == rhs);
   }
 
-  constexpr bool operator==(const ok<T> &rhs) const {
+  constexpr bool operator==(const ::result::ok<T> &rhs) const {
     if constexpr (std::is_same_v<T, empty_tag_t>) {
       return true;
     } else {
-      return m_type == result_type::ok && get<T>() == rhs.value();
+      return is_ok() && ok_unchecked() == rhs.value();
     }
   }
 
-  constexpr bool operator!=(const ok<T> &rhs) const { return !(*this == rhs); }
+  constexpr bool operator!=(const ::result::ok<T> &rhs) const { return !(*this == rhs); }
 
-  constexpr bool operator==(const err<E> &rhs) const {
+  constexpr bool operator==(const ::result::err<E> &rhs) const {
     if constexpr (std::is_same_v<E, empty_tag_t>) {
       return true;
     } else {
-      return m_type == result_type::err && get<E>() == rhs.value();
+      return is_err() && err_unchecked() == rhs.value();
     }
   }
 
-  constexpr bool operator!=(const err<E> &rhs) const { return !(*this == rhs); }
+  constexpr bool operator!=(const ::result::err<E> &rhs) const { return !(*this == rhs); }
 
-  bool contains(T rhs) const {
+  bool contains(const std::remove_reference_t<T> &rhs) const {
     if (is_ok()) {
       const auto &t = ok_unchecked();
       return t == rhs;
@@ -400,7 +848,7 @@ public:
     return false;
   }
 
-  bool contains_err(E rhs) const {
+  bool contains_err(const E &rhs) const {
     if (is_err()) {
       const auto &t = err_unchecked();
       return t == rhs;
@@ -408,7 +856,8 @@ public:
     return false;
   }
 
-  [[maybe_unused]] constexpr std::optional<std::reference_wrapper<const T>>
+  [[maybe_unused]] constexpr std::optional<
+      std::reference_wrapper<const std::remove_reference_t<T>>>
   ok() const & {
     if (is_ok()) {
       return std::cref(ok_unchecked());
@@ -416,15 +865,22 @@ public:
     return std::nullopt;
   }
 
-  [[maybe_unused]] constexpr std::optional<std::reference_wrapper<T>> ok() & {
+  [[maybe_unused]] constexpr std::optional<
+      std::reference_wrapper<std::remove_reference_t<T>>>
+  ok() & {
     if (is_ok()) {
       return std::ref(ok_unchecked());
     }
     return std::nullopt;
   }
-  [[maybe_unused]] constexpr std::optional<T> ok() && {
+
+  /// For a result<T &, E> the returned optional holds a reference_wrapper.
+  [[maybe_unused]] constexpr std::optional<std::conditional_t<
+      std::is_reference_v<T>,
+      std::reference_wrapper<std::remove_reference_t<T>>, T>>
+  ok() && {
     if (is_ok()) {
-      return ok_unchecked();
+      return std::forward<T>(ok_unchecked());
     }
     return std::nullopt;
   }
@@ -446,24 +902,55 @@ public:
 
   [[maybe_unused]] constexpr std::optional<E> err() && {
     if (is_err()) {
-      return err_unchecked();
+      return std::move(err_unchecked());
     }
     return std::nullopt;
   };
 
-  constexpr const T &ok_unchecked() const &noexcept { return get<T>(); }
+  /// Access the ok value without checking the state of the result.
+  /// For a result<T &, E> all overloads return the stored reference.
+  ///
+  /// Calling it on an err result terminates with a message in debug builds,
+  /// and is undefined behavior otherwise, see RESULT_CHECKED_ACCESS. In
+  /// release builds the state is assumed to be ok: the optimizer drops the
+  /// checks of the state that follow.
+  constexpr const T &ok_unchecked() const &noexcept {
+    details::expect_state(is_ok(), "ok_unchecked() was called on an err "
+                                   "result.");
+    return m_storage.ok_value();
+  }
 
+  /// Access the err value without checking the state of the result, see
+  /// ok_unchecked().
   [[maybe_unused]] constexpr const E &err_unchecked() const &noexcept {
-    return get<E>();
+    details::expect_state(is_err(), "err_unchecked() was called on an ok "
+                                    "result.");
+    return m_storage.err_value();
   }
 
-  constexpr T &ok_unchecked() &noexcept { return get<T>(); }
+  constexpr T &ok_unchecked() &noexcept {
+    details::expect_state(is_ok(), "ok_unchecked() was called on an err "
+                                   "result.");
+    return m_storage.ok_value();
+  }
 
-  [[maybe_unused]] constexpr E &err_unchecked() &noexcept { return get<E>(); }
+  [[maybe_unused]] constexpr E &err_unchecked() &noexcept {
+    details::expect_state(is_err(), "err_unchecked() was called on an ok "
+                                    "result.");
+    return m_storage.err_value();
+  }
 
-  constexpr T &&ok_unchecked() &&noexcept { return std::move(get<T>()); }
+  constexpr T &&ok_unchecked() &&noexcept {
+    details::expect_state(is_ok(), "ok_unchecked() was called on an err "
+                                   "result.");
+    return std::forward<T>(m_storage.ok_value());
+  }
 
-  constexpr E &&err_unchecked() &&noexcept { return std::move(get<E>()); }
+  constexpr E &&err_unchecked() &&noexcept {
+    details::expect_state(is_err(), "err_unchecked() was called on an ok "
+                                    "result.");
+    return std::move(m_storage.err_value());
+  }
 
   [[maybe_unused]] constexpr const T &try_ok() const {
     if (!is_ok()) {
@@ -497,14 +984,14 @@ public:
     if (is_err()) {
       details::terminate(msg);
     }
-    return std::move(unwrap());
+    return unwrap();
   }
 
-  [[maybe_unused]] constexpr T &&expect_err(const std::string_view &msg) {
+  [[maybe_unused]] constexpr E &&expect_err(const std::string_view &msg) {
     if (is_ok()) {
       details::terminate(msg);
     }
-    return std::move(unwrap_err());
+    return unwrap_err();
   }
 
   [[maybe_unused]] constexpr T &&unwrap() {
@@ -516,16 +1003,19 @@ public:
 
   constexpr T &&unwrap_or(T &&default_value) {
     if (!is_ok()) {
-      return std::move(default_value);
+      return std::forward<T>(default_value);
     }
     return std::move(*this).ok_unchecked();
   }
 
-  [[maybe_unused]] constexpr T &&unwrap_or_default() {
+  [[maybe_unused]] constexpr T unwrap_or_default() {
     static_assert(std::is_default_constructible_v<T>,
                   "result<T, E>::unwrap_or_default() requires T to be default "
                   "constructible");
-    return std::move(unwrap_or(T()));
+    if (!is_ok()) {
+      return T();
+    }
+    return std::move(*this).ok_unchecked();
   }
 
   [[maybe_unused]] constexpr E &&unwrap_err() {
@@ -542,60 +1032,162 @@ public:
     return std::move(*this).err_unchecked();
   }
 
-  template <typename F, typename R = std::invoke_result_t<F, T>,
-            std::enable_if_t<std::is_invocable_r<R, F, T>::value, int> = 0>
-  result<R, E> map(F &&fun) {
-    if (is_ok()) {
-      return result<R, E>(::result::ok(fun(std::move(*this).ok_unchecked())));
-    }
-    return result<R, E>(::result::err(std::move(*this).err_unchecked()));
+  /// Transform the ok value with fun, err values are passed through.
+  /// fun receives the ok value with the value category of *this: a (const)
+  /// lvalue reference for lvalue results, an rvalue reference for rvalue
+  /// results. The payload is only moved from when *this is an rvalue.
+  template <typename F>
+    requires std::invocable<F, T &>
+  constexpr auto map(F &&fun) & {
+    return map_impl(*this, std::forward<F>(fun));
   }
 
-  template <typename F, typename R = std::invoke_result_t<F, E>,
-            std::enable_if_t<std::is_invocable_r<R, F, E>::value, int> = 0>
-  result<T, R> map_err(F &&fun) {
-    if (is_ok()) {
-      return result<T, R>(::result::ok(std::move(*this).ok_unchecked()));
-    }
-    return result<T, R>(::result::err(fun(std::move(*this).err_unchecked())));
+  template <typename F>
+    requires std::invocable<F, const T &>
+  constexpr auto map(F &&fun) const & {
+    return map_impl(*this, std::forward<F>(fun));
   }
 
-  template <typename F, typename D, typename R = std::invoke_result_t<F, T>,
-            typename R2 = std::invoke_result_t<D, E>,
-            std::enable_if_t<std::is_invocable_r<R, F, T>::value, int> = 0,
-            std::enable_if_t<std::is_invocable_r<R2, D, E>::value, int> = 0,
-            std::enable_if_t<std::is_same_v<R, R2>, int> = 0>
-  R map_or_else(D default_fun, F &&fun) {
-    if (is_ok()) {
-      return fun(std::move(*this).ok_unchecked());
-    }
-    return default_fun(std::move(*this).err_unchecked());
+  template <typename F>
+    requires std::invocable<F, T &&>
+  constexpr auto map(F &&fun) && {
+    return map_impl(std::move(*this), std::forward<F>(fun));
+  }
+
+  /// Transform the err value with fun, ok values are passed through.
+  /// See map() for how the value category of *this is forwarded.
+  template <typename F>
+    requires std::invocable<F, E &>
+  constexpr auto map_err(F &&fun) & {
+    return map_err_impl(*this, std::forward<F>(fun));
+  }
+
+  template <typename F>
+    requires std::invocable<F, const E &>
+  constexpr auto map_err(F &&fun) const & {
+    return map_err_impl(*this, std::forward<F>(fun));
+  }
+
+  template <typename F>
+    requires std::invocable<F, E &&>
+  constexpr auto map_err(F &&fun) && {
+    return map_err_impl(std::move(*this), std::forward<F>(fun));
+  }
+
+  /// Apply fun to the ok value or default_fun to the err value. Both
+  /// functions must return the same type.
+  template <typename D, typename F>
+    requires std::invocable<D, E &> && std::invocable<F, T &>
+  constexpr auto map_or_else(D &&default_fun, F &&fun) & {
+    return map_or_else_impl(*this, std::forward<D>(default_fun),
+                            std::forward<F>(fun));
+  }
+
+  template <typename D, typename F>
+    requires std::invocable<D, const E &> && std::invocable<F, const T &>
+  constexpr auto map_or_else(D &&default_fun, F &&fun) const & {
+    return map_or_else_impl(*this, std::forward<D>(default_fun),
+                            std::forward<F>(fun));
+  }
+
+  template <typename D, typename F>
+    requires std::invocable<D, E &&> && std::invocable<F, T &&>
+  constexpr auto map_or_else(D &&default_fun, F &&fun) && {
+    return map_or_else_impl(std::move(*this), std::forward<D>(default_fun),
+                            std::forward<F>(fun));
+  }
+
+  /// Call on_ok with the ok value or on_err with the err value, and return
+  /// what it returns. Both handlers are required, the value categories are
+  /// forwarded as by map(). If the handlers return different types, the
+  /// result is their std::common_type.
+  /// \code
+  /// const std::string text = r.match(
+  ///     [](int v) { return std::to_string(v); },
+  ///     [](const error &e) { return e.message(); });
+  /// \endcode
+  template <typename O, typename D>
+    requires std::invocable<O, T &> && std::invocable<D, E &>
+  constexpr decltype(auto) match(O &&on_ok, D &&on_err) & {
+    return match_impl(*this, std::forward<O>(on_ok), std::forward<D>(on_err));
   }
 
-  template <typename U> result<U, E> and_(result<U, E> r) {
+  template <typename O, typename D>
+    requires std::invocable<O, const T &> && std::invocable<D, const E &>
+  constexpr decltype(auto) match(O &&on_ok, D &&on_err) const & {
+    return match_impl(*this, std::forward<O>(on_ok), std::forward<D>(on_err));
+  }
+
+  template <typename O, typename D>
+    requires std::invocable<O, T &&> && std::invocable<D, E &&>
+  constexpr decltype(auto) match(O &&on_ok, D &&on_err) && {
+    return match_impl(std::move(*this), std::forward<O>(on_ok),
+                      std::forward<D>(on_err));
+  }
+
+  /// Return if_ok if *this is ok, if_err otherwise. Both values are
+  /// evaluated by the caller and nothing is called, so that for integers
+  /// and pointers the choice compiles to a conditional move rather than a
+  /// branch.
+  template <typename U>
+  constexpr U select(U if_ok, std::type_identity_t<U> if_err) const
+      noexcept(std::is_nothrow_move_constructible_v<U>) {
+    return is_ok() ? std::move(if_ok) : std::move(if_err);
+  }
+
+  /// Return r if *this is ok, otherwise the err value of *this.
+  template <typename U> constexpr result<U, E> and_(result<U, E> r) const & {
     if (is_ok()) {
       return r;
     }
-    return result<U, E>(::result::err(std::move(*this).err_unchecked()));
+    return result<U, E>(err_tag, err_unchecked());
   }
 
-  template <
-      typename F, typename U = typename std::invoke_result_t<F, T>::value_type,
-      std::enable_if_t<std::is_invocable_r_v<result<U, E>, F, T>, int> = 0>
-  result<U, E> and_then(F fun) {
+  template <typename U> constexpr result<U, E> and_(result<U, E> r) && {
     if (is_ok()) {
-      return fun(std::move(*this).ok_unchecked());
+      return r;
     }
-    return result<U, E>(::result::err(std::move(*this).err_unchecked()));
+    return result<U, E>(err_tag, std::move(*this).err_unchecked());
+  }
+
+  /// Call fun with the ok value and return its result, err values are
+  /// passed through. If fun returns a result with another error type, the
+  /// error type of the returned result is error_union_t of both.
+  template <typename F>
+    requires std::invocable<F, T &>
+  constexpr auto and_then(F &&fun) & {
+    return and_then_impl(*this, std::forward<F>(fun));
+  }
+
+  template <typename F>
+    requires std::invocable<F, const T &>
+  constexpr auto and_then(F &&fun) const & {
+    return and_then_impl(*this, std::forward<F>(fun));
+  }
+
+  template <typename F>
+    requires std::invocable<F, T &&>
+  constexpr auto and_then(F &&fun) && {
+    return and_then_impl(std::move(*this), std::forward<F>(fun));
   }
 
 #if defined(__clang__)
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "readability-identifier-naming"
 #endif
-  template <typename E2> [[maybe_unused]] result<T, E2> or_(result<T, E2> r) {
+  /// Return *this if it is ok, otherwise r.
+  template <typename E2>
+  [[maybe_unused]] constexpr result<T, E2> or_(result<T, E2> r) const & {
+    if (is_ok()) {
+      return result<T, E2>(ok_tag, ok_unchecked());
+    }
+    return r;
+  }
+
+  template <typename E2>
+  [[maybe_unused]] constexpr result<T, E2> or_(result<T, E2> r) && {
     if (is_ok()) {
-      return result<T, E2>(::result::ok(std::move(*this).ok_unchecked()));
+      return result<T, E2>(ok_tag, std::move(*this).ok_unchecked());
     }
     return r;
   }
@@ -603,50 +1195,341 @@ public:
 #pragma clang diagnostic pop
 #endif
 
-  template <
-      typename F, typename E2 = typename std::invoke_result_t<F, E>::error_type,
-      std::enable_if_t<std::is_invocable_r_v<result<T, E2>, F, E>, int> = 0>
-  result<T, E2> or_else(F fun) {
+  /// Call fun with the err value and return its result, ok values are
+  /// passed through. fun must return a result with the same value type.
+  template <typename F>
+    requires std::invocable<F, E &>
+  constexpr auto or_else(F &&fun) & {
+    return or_else_impl(*this, std::forward<F>(fun));
+  }
+
+  template <typename F>
+    requires std::invocable<F, const E &>
+  constexpr auto or_else(F &&fun) const & {
+    return or_else_impl(*this, std::forward<F>(fun));
+  }
+
+  template <typename F>
+    requires std::invocable<F, E &&>
+  constexpr auto or_else(F &&fun) && {
+    return or_else_impl(std::move(*this), std::forward<F>(fun));
+  }
+
+  /// Call fun with a const reference to the ok value, if any, and return
+  /// *this. The && overload returns the result by value (moved).
+  template <typename F>
+    requires std::invocable<F, const T &>
+  constexpr result<T, E> &inspect(F &&fun) & {
+    if (is_ok()) {
+      std::invoke(std::forward<F>(fun), std::as_const(ok_unchecked()));
+    }
+    return *this;
+  }
+
+  template <typename F>
+    requires std::invocable<F, const T &>
+  constexpr const result<T, E> &inspect(F &&fun) const & {
     if (is_ok()) {
-      return result<T, E2>(::result::ok(std::move(*this).ok_unchecked()));
+      std::invoke(std::forward<F>(fun), ok_unchecked());
+    }
+    return *this;
+  }
+
+  template <typename F>
+    requires std::invocable<F, const T &>
+  constexpr result<T, E> inspect(F &&fun) && {
+    if (is_ok()) {
+      std::invoke(std::forward<F>(fun), std::as_const(ok_unchecked()));
+    }
+    return std::move(*this);
+  }
+
+  /// Call fun with a const reference to the err value, if any, and return
+  /// *this. The && overload returns the result by value (moved).
+  template <typename F>
+    requires std::invocable<F, const E &>
+  constexpr result<T, E> &inspect_err(F &&fun) & {
+    if (is_err()) {
+      std::invoke(std::forward<F>(fun), std::as_const(err_unchecked()));
+    }
+    return *this;
+  }
+
+  template <typename F>
+    requires std::invocable<F, const E &>
+  constexpr const result<T, E> &inspect_err(F &&fun) const & {
+    if (is_err()) {
+      std::invoke(std::forward<F>(fun), err_unchecked());
+    }
+    return *this;
+  }
+
+  template <typename F>
+    requires std::invocable<F, const E &>
+  constexpr result<T, E> inspect_err(F &&fun) && {
+    if (is_err()) {
+      std::invoke(std::forward<F>(fun), std::as_const(err_unchecked()));
+    }
+    return std::move(*this);
+  }
+
+  /// Exchange the contents of two results.
+  /// Payloads of the same kind are swapped in place, if the kinds differ the
+  /// payloads are moved across directly without assigning to a temporary
+  /// result. References held by a result<T &, E> are rebound, the referenced
+  /// objects are left untouched.
+  ///
+  /// If moving a payload across throws, both results are given their
+  /// original kind back, with values that may have been moved from. An
+  /// exception thrown while doing so terminates the program, so a result
+  /// never keeps its kind over a destroyed value.
+  constexpr void swap(result<T, E> &other) noexcept(
+      details::nothrow_swappable_payload_v<T> &&
+      details::nothrow_swappable_payload_v<E>) {
+    using std::swap;
+    if (is_ok() == other.is_ok()) {
+      if (is_ok()) {
+        if constexpr (std::is_reference_v<T>) {
+          T lhs = ok_unchecked();
+          m_storage.construct_ok(other.ok_unchecked());
+          other.m_storage.construct_ok(lhs);
+        } else {
+          swap(ok_unchecked(), other.ok_unchecked());
+        }
+      } else {
+        swap(err_unchecked(), other.err_unchecked());
+      }
+      return;
     }
-    return fun(std::move(*this).err_unchecked());
+    result<T, E> &ok_side = is_ok() ? *this : other;
+    result<T, E> &err_side = is_ok() ? other : *this;
+    T tmp(std::move(ok_side).ok_unchecked());
+    ok_side.m_storage.destroy();
+    // stage 1: ok_side holds no value, stage 2: ok_side holds the err value
+    // and err_side no value, stage 0: done.
+    struct rollback_guard {
+      result<T, E> &ok_side;
+      result<T, E> &err_side;
+      std::remove_reference_t<T> &tmp;
+      int stage;
+      constexpr ~rollback_guard() {
+        if (stage == 2) {
+          err_side.m_storage.construct_err(
+              std::move(ok_side).err_unchecked());
+          ok_side.m_storage.destroy();
+        }
+        if (stage != 0) {
+          ok_side.m_storage.construct_ok(std::forward<T>(tmp));
+        }
+      }
+    } guard{ok_side, err_side, tmp, 1};
+    ok_side.m_storage.construct_err(std::move(err_side).err_unchecked());
+    guard.stage = 2;
+    err_side.m_storage.destroy();
+    err_side.m_storage.construct_ok(std::forward<T>(tmp));
+    guard.stage = 0;
+  }
+
+  friend constexpr void swap(result<T, E> &lhs,
+                             result<T, E> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
   }
 
 private:
-  template <typename U> constexpr const U &get() const &noexcept {
-    static_assert(std::is_same<T, U>::value || std::is_same<E, U>::value);
-    return *reinterpret_cast<const U *>(std::addressof(m_data));
+  template <typename Self, typename F>
+  static constexpr auto map_impl(Self &&self, F &&fun) {
+    using R = std::remove_cvref_t<std::invoke_result_t<
+        F, decltype(std::forward<Self>(self).ok_unchecked())>>;
+    if (self.is_ok()) {
+      return result<R, E>(ok_tag,
+                          std::invoke(std::forward<F>(fun),
+                                      std::forward<Self>(self).ok_unchecked()));
+    }
+    return result<R, E>(err_tag, std::forward<Self>(self).err_unchecked());
   }
 
-  template <typename U> constexpr U &get() &noexcept {
-    static_assert(std::is_same<T, U>::value || std::is_same<E, U>::value);
-    return *reinterpret_cast<U *>(std::addressof(m_data));
+  template <typename Self, typename F>
+  static constexpr auto map_err_impl(Self &&self, F &&fun) {
+    using R = std::remove_cvref_t<std::invoke_result_t<
+        F, decltype(std::forward<Self>(self).err_unchecked())>>;
+    if (self.is_ok()) {
+      return result<T, R>(ok_tag, std::forward<Self>(self).ok_unchecked());
+    }
+    return result<T, R>(err_tag,
+                        std::invoke(std::forward<F>(fun),
+                                    std::forward<Self>(self).err_unchecked()));
   }
 
-  template <typename U>
-  constexpr U &&get() &&noexcept(std::is_nothrow_move_assignable_v<U>) {
-    static_assert(std::is_same<T, U>::value || std::is_same<E, U>::value);
-    return std::move(*reinterpret_cast<U *>(std::addressof(m_data)));
+  template <typename Self, typename D, typename F>
+  static constexpr auto map_or_else_impl(Self &&self, D &&default_fun,
+                                         F &&fun) {
+    using R = std::invoke_result_t<
+        F, decltype(std::forward<Self>(self).ok_unchecked())>;
+    using R2 = std::invoke_result_t<
+        D, decltype(std::forward<Self>(self).err_unchecked())>;
+    static_assert(std::is_same_v<R, R2>,
+                  "map_or_else(default_fun, fun) requires both functions to "
+                  "return the same type");
+    if (self.is_ok()) {
+      return std::invoke(std::forward<F>(fun),
+                         std::forward<Self>(self).ok_unchecked());
+    }
+    return std::invoke(std::forward<D>(default_fun),
+                       std::forward<Self>(self).err_unchecked());
+  }
+
+  template <typename Self, typename O, typename D>
+  static constexpr details::match_result_t<
+      std::invoke_result_t<O, decltype(std::declval<Self>().ok_unchecked())>,
+      std::invoke_result_t<D, decltype(std::declval<Self>().err_unchecked())>>
+  match_impl(Self &&self, O &&on_ok, D &&on_err) {
+    if (self.is_ok()) {
+      return std::invoke(std::forward<O>(on_ok),
+                         std::forward<Self>(self).ok_unchecked());
+    }
+    return std::invoke(std::forward<D>(on_err),
+                       std::forward<Self>(self).err_unchecked());
   }
 
-  void destroy() {
-    if (m_type == result_type::ok) {
-      auto *ptr = reinterpret_cast<T *>(std::addressof(m_data));
-      if (ptr != nullptr)
-        ptr->~T();
+  template <typename Self, typename F>
+  static constexpr auto and_then_impl(Self &&self, F &&fun) {
+    using R = std::remove_cvref_t<std::invoke_result_t<
+        F, decltype(std::forward<Self>(self).ok_unchecked())>>;
+    static_assert(is_result<R>::value,
+                  "and_then(fun) requires fun to return a result");
+    if constexpr (std::is_same_v<typename R::error_type, E>) {
+      if (self.is_ok()) {
+        return R(std::invoke(std::forward<F>(fun),
+                             std::forward<Self>(self).ok_unchecked()));
+      }
+      return R(err_tag, std::forward<Self>(self).err_unchecked());
     } else {
-      auto *ptr = reinterpret_cast<E *>(std::addressof(m_data));
-      if (ptr != nullptr)
-        ptr->~E();
+      // Different error types widen to the union of both error sets.
+      using W = error_union_t<E, typename R::error_type>;
+      using RW = result<typename R::value_type, W>;
+      if (self.is_ok()) {
+        R r = std::invoke(std::forward<F>(fun),
+                          std::forward<Self>(self).ok_unchecked());
+        if (r.is_ok()) {
+          return RW(ok_tag, std::move(r).ok_unchecked());
+        }
+        return RW(err_tag, std::move(r).err_unchecked());
+      }
+      return RW(err_tag, std::forward<Self>(self).err_unchecked());
+    }
+  }
+
+  template <typename Self, typename F>
+  static constexpr auto or_else_impl(Self &&self, F &&fun) {
+    using R = std::remove_cvref_t<std::invoke_result_t<
+        F, decltype(std::forward<Self>(self).err_unchecked())>>;
+    static_assert(is_result<R>::value,
+                  "or_else(fun) requires fun to return a result");
+    static_assert(std::is_same_v<typename R::value_type, T>,
+                  "or_else(fun) requires fun to return a result with the "
+                  "same value type");
+    if (self.is_ok()) {
+      return R(ok_tag, std::forward<Self>(self).ok_unchecked());
+    }
+    return R(std::invoke(std::forward<F>(fun),
+                         std::forward<Self>(self).err_unchecked()));
+  }
+
+  template <typename U> constexpr void assign_ok(U &&value) {
+    if constexpr (!std::is_reference_v<T>) {
+      if (is_ok()) {
+        m_storage.ok_value() = std::forward<U>(value);
+        return;
+      }
+    }
+    m_storage.destroy();
+    m_storage.construct_ok(std::forward<U>(value));
+  }
+
+  template <typename Alloc, typename... Args>
+  constexpr void construct_ok_with(const Alloc &alloc, Args &&...args) {
+    std::apply(
+        [this](auto &&...a) {
+          m_storage.construct_ok(std::forward<decltype(a)>(a)...);
+        },
+        details::uses_allocator_args<T>(alloc, std::forward<Args>(args)...));
+  }
+
+  template <typename Alloc, typename... Args>
+  constexpr void construct_err_with(const Alloc &alloc, Args &&...args) {
+    std::apply(
+        [this](auto &&...a) {
+          m_storage.construct_err(std::forward<decltype(a)>(a)...);
+        },
+        details::uses_allocator_args<E>(alloc, std::forward<Args>(args)...));
+  }
+
+  template <typename U> constexpr void assign_err(U &&value) {
+    if (is_err()) {
+      m_storage.err_value() = std::forward<U>(value);
+      return;
     }
+    m_storage.destroy();
+    m_storage.construct_err(std::forward<U>(value));
   }
 
 private:
-  data_type m_data;
-  result_type m_type;
+  details::result_storage<T, E> m_storage;
+};
+
+/// A result is its payload plus a discriminant, it can be relocated with
+/// memcpy when both payloads can.
+template <typename T, typename E>
+struct is_trivially_relocatable<result<T, E>>
+    : std::bool_constant<details::trivially_relocatable_payload_v<T> &&
+                         details::trivially_relocatable_payload_v<E>> {};
+
+/// Construct a result<T, E> holding an ok value constructed in place from
+/// args. The value is neither copied nor moved.
+template <typename T, typename E, typename... Args>
+constexpr result<T, E> make_ok(Args &&...args) {
+  return result<T, E>(ok_tag, std::forward<Args>(args)...);
+}
+
+/// Construct a result<T, E> holding an err value constructed in place from
+/// args. The error is neither copied nor moved.
+template <typename T, typename E, typename... Args>
+constexpr result<T, E> make_err(Args &&...args) {
+  return result<T, E>(err_tag, std::forward<Args>(args)...);
+}
+
+/// Function object calling the overload of its operator() that fits the
+/// arguments, out of those of fs, e.g. to visit() a result:
+/// \code
+/// result::visit(result::overloaded{[](int v) { ... },
+///                                  [](const error &e) { ... }},
+///               r);
+/// \endcode
+template <typename... Fs> struct overloaded : Fs... {
+  using Fs::operator()...;
 };
 
+template <typename... Fs> overloaded(Fs...) -> overloaded<Fs...>;
+
+/// Call visitor with the ok value or the err value of r, forwarded with the
+/// value category of r, and return what it returns. visitor must accept
+/// both, which is checked whatever the state of r.
+///
+/// The overload is selected by type: with T and E the same type, visitor
+/// can't tell the states apart, use r.match() instead.
+template <typename V, typename R>
+  requires is_result<std::remove_cvref_t<R>>::value
+constexpr decltype(auto) visit(V &&visitor, R &&r) {
+  static_assert(
+      std::invocable<V, decltype(std::forward<R>(r).ok_unchecked())> &&
+          std::invocable<V, decltype(std::forward<R>(r).err_unchecked())>,
+      "visit(visitor, r) requires visitor to accept both the ok and the err "
+      "value of r");
+  // Only one of the two is called, visitor is never used after a move.
+  return std::forward<R>(r).match(std::forward<V>(visitor),
+                                  std::forward<V>(visitor));
+}
+
 /**
  * Compare two results and their respective values if any are stored.
  *
@@ -673,45 +1556,152 @@ private:
 template <typename T, typename E,
           typename R = std::compare_three_way_result_t<T>>
 R operator<=>(const result<T, E> &lhs, const result<T, E> &rhs) {
-  auto lok = lhs.is_ok() ? 1 : 0;
-  auto rok = rhs.is_ok() ? 1 : 0;
-  if (auto c = lok <=> rok; c != 0)
-    return c;
-  auto lopt = lhs.ok();
-  auto ropt = rhs.ok();
-  lok = lopt.has_value() ? 1 : 0;
-  rok = ropt.has_value() ? 1 : 0;
-  if (lok == rok) {
-    if (lok) {
-      // compare both values
-      const auto &lv = lopt.value().get();
-      const auto &rv = ropt.value().get();
-      return lv <=> rv;
-    }
+  const bool lok = lhs.is_ok();
+  const bool rok = rhs.is_ok();
+  if (lok && rok) {
+    return lhs.ok_unchecked() <=> rhs.ok_unchecked();
   }
   return lok <=> rok;
 }
 
+/// Incremental 64-bit hash state used by hash_append().
+///
+/// Words are combined with a rotate-xor-multiply step and the final value is
+/// passed through the murmur3 fmix64 finalizer, so every input bit affects
+/// every output bit. This matters for hash tables that select a bucket using
+/// the low bits of the hash.
+class hash_state {
+public:
+  constexpr explicit hash_state(std::uint64_t seed = 0) noexcept
+      : m_state(seed) {}
+
+  constexpr void append(std::uint64_t word) noexcept {
+    m_state = (std::rotl(m_state, 5) ^ word) * 0x9e3779b97f4a7c15ULL;
+  }
+
+  constexpr std::size_t finish() const noexcept {
+    std::uint64_t h = m_state;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+  }
+
+private:
+  std::uint64_t m_state;
+};
+
+/// hash_append() is the customization point to feed a value into a
+/// hash_state. Provide an overload in the namespace of a composite type to
+/// hash its members, e.g.
+/// \code
+/// void hash_append(result::hash_state &h, const point &p) {
+///   hash_append(h, p.x);
+///   hash_append(h, p.y);
+/// }
+/// \endcode
+/// Types without an overload fall back to std::hash.
+constexpr void hash_append(hash_state &, empty_tag_t) noexcept {}
+
+template <typename T>
+  requires(std::is_integral_v<T> || std::is_enum_v<T>)
+constexpr void hash_append(hash_state &h, T value) noexcept {
+  if constexpr (std::is_enum_v<T>) {
+    h.append(static_cast<std::uint64_t>(
+        static_cast<std::underlying_type_t<T>>(value)));
+  } else {
+    h.append(static_cast<std::uint64_t>(value));
+  }
+}
+
+template <typename T>
+  requires std::is_floating_point_v<T>
+constexpr void hash_append(hash_state &h, T value) noexcept {
+  // +0.0 and -0.0 compare equal and must hash equal.
+  const double d = value == T(0) ? 0.0 : static_cast<double>(value);
+  h.append(std::bit_cast<std::uint64_t>(d));
+}
+
+template <typename T>
+void hash_append(hash_state &h, T *const ptr) noexcept {
+  h.append(reinterpret_cast<std::uintptr_t>(ptr));
+}
+
+template <typename T>
+  requires(!std::is_arithmetic_v<T> && !std::is_enum_v<T> &&
+           !std::is_pointer_v<T> && requires(const T &v) {
+             { std::hash<T>{}(v) } -> std::convertible_to<std::size_t>;
+           })
+void hash_append(hash_state &h, const T &value) noexcept(
+    noexcept(std::hash<T>{}(value))) {
+  h.append(std::hash<T>{}(value));
+}
+
+template <typename T1, typename T2>
+void hash_append(hash_state &h, const std::pair<T1, T2> &value) {
+  hash_append(h, value.first);
+  hash_append(h, value.second);
+}
+
+template <typename... Ts>
+void hash_append(hash_state &h, const std::tuple<Ts...> &value) {
+  std::apply([&h](const auto &...vs) { (hash_append(h, vs), ...); }, value);
+}
+
+/// Hash the position of the error stored in an error_set followed by the
+/// error itself.
+template <typename... Es>
+void hash_append(hash_state &h, const error_set<Es...> &value) {
+  h.append(static_cast<std::uint64_t>(value.index()));
+  value.visit([&h](const auto &e) { hash_append(h, e); });
+}
+
+/// Hash the state of a result (ok or err) followed by its payload.
+template <typename T, typename E>
+void hash_append(hash_state &h, const result<T, E> &value) {
+  if (value.is_ok()) {
+    h.append(0x6f6bULL);
+    hash_append(h, value.ok_unchecked());
+  } else {
+    h.append(0x657272ULL);
+    hash_append(h, value.err_unchecked());
+  }
+}
+
+/// Hash a batch of results stored in contiguous memory, e.g. a
+/// std::span<const result<T, E>> or a std::vector<result<T, E>>.
+///
+/// out[i] receives the same value as std::hash<result<T, E>>{}(values[i]).
+/// \pre out.size() >= values.size()
+template <std::ranges::contiguous_range R>
+  requires is_result<std::ranges::range_value_t<R>>::value
+void hash_many(const R &values, std::span<std::size_t> out) {
+  const auto *first = std::ranges::data(values);
+  const std::size_t n = std::ranges::size(values);
+  for (std::size_t i = 0; i < n; ++i) {
+    hash_state h;
+    hash_append(h, first[i]);
+    out[i] = h.finish();
+  }
+}
+
 } // namespace result
 
 namespace std {
+/// A result uses an allocator when one of its payloads does, see the
+/// allocator-extended constructors of result.
+template <typename T, typename E, typename Alloc>
+struct uses_allocator<::result::result<T, E>, Alloc>
+    : bool_constant<uses_allocator_v<T, Alloc> || uses_allocator_v<E, Alloc>> {
+};
+
 template <typename T, typename E> struct hash<::result::result<T, E>> {
   size_t operator()(const ::result::result<T, E> &result) const noexcept {
-    bool is_ok = result.is_ok();
-    size_t h1 = is_ok ? 1 : 0;
-    size_t h2;
-    if (result.is_ok()) {
-      auto value = result.ok();
-      if (value) {
-        h2 = std::hash<T>{}(value.value().get());
-      }
-    } else {
-      auto value = result.err();
-      if (value) {
-        h2 = std::hash<E>{}(value.value().get());
-      }
-    }
-    return h1 ^ (h2 << 1);
+    ::result::hash_state h;
+    hash_append(h, result);
+    return h.finish();
   }
 };
 } // namespace std
@@ -0,0 +1,421 @@
+#ifndef RESULT_SERIALIZE_HPP
+#define RESULT_SERIALIZE_HPP
+
+#include "result.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace result {
+
+/// Reason why a serialized result file couldn't be written or mapped.
+enum class serialize_errc : std::uint8_t {
+  open,
+  stat,
+  map,
+  write,
+  truncated,
+  bad_magic,
+  byte_order,
+  version,
+  layout
+};
+
+/// Error type of the binary (de)serialization functions.
+/// \c sys_errno is the value of errno when a system call failed, 0 otherwise.
+struct serialize_error {
+  serialize_errc code;
+  int sys_errno = 0;
+
+  constexpr bool operator==(const serialize_error &) const = default;
+};
+
+using serialize_status = result<empty_tag_t, serialize_error>;
+
+/// Fixed layout representation of a result<T, E> that can be read in place.
+///
+/// The payload is stored at offset 0, followed by a one byte discriminant
+/// (1 = ok, 0 = err). Unused and padding bytes are always zero, so two
+/// equal results encode to identical bytes.
+/// \tparam T trivially copyable value type
+/// \tparam E trivially copyable error type
+template <typename T, typename E> struct packed_result {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                    std::is_trivially_copyable_v<E>,
+                "packed_result<T, E> requires trivially copyable T and E");
+
+  alignas(T) alignas(E) unsigned char data[std::max(sizeof(T), sizeof(E))];
+  std::uint8_t type;
+
+  static packed_result pack(const result<T, E> &r) noexcept {
+    // Value initialization doesn't guarantee zero padding bytes.
+    packed_result p;
+    std::memset(&p, 0, sizeof(p));
+    if (r.is_ok()) {
+      std::memcpy(p.data, std::addressof(r.ok_unchecked()), sizeof(T));
+      p.type = 1;
+    } else {
+      std::memcpy(p.data, std::addressof(r.err_unchecked()), sizeof(E));
+      p.type = 0;
+    }
+    return p;
+  }
+
+  constexpr bool is_ok() const noexcept { return type != 0; }
+
+  constexpr bool is_err() const noexcept { return type == 0; }
+
+  constexpr explicit operator bool() const noexcept { return is_ok(); }
+
+  const T &ok_unchecked() const noexcept {
+    return *std::launder(reinterpret_cast<const T *>(data));
+  }
+
+  const E &err_unchecked() const noexcept {
+    return *std::launder(reinterpret_cast<const E *>(data));
+  }
+
+  /// Copy the payload out into a result<T, E>.
+  result<T, E> unpack() const {
+    if (is_ok()) {
+      return result<T, E>(ok_tag, ok_unchecked());
+    }
+    return result<T, E>(err_tag, err_unchecked());
+  }
+};
+
+/// File header preceding the packed records.
+///
+/// The header is 64 bytes, which keeps the first record cache line aligned
+/// in a memory mapped file. The records directly follow it, so T and E
+/// can't be aligned to more than 64 bytes. \c byte_order is written in the native byte order
+/// of the writer; a reader with a different byte order rejects the file
+/// instead of reading garbage.
+struct serialized_header {
+  static constexpr char magic_value[8] = {'R', 'E', 'S', 'U',
+                                          'L', 'T', '\x1a', '\n'};
+  static constexpr std::uint32_t byte_order_value = 0x01020304;
+  static constexpr std::uint16_t version_value = 1;
+
+  char magic[8];
+  std::uint32_t byte_order;
+  std::uint16_t version;
+  std::uint16_t header_size;
+  std::uint32_t record_size;
+  std::uint32_t record_align;
+  std::uint32_t ok_size;
+  std::uint32_t err_size;
+  std::uint64_t count;
+  unsigned char reserved[24];
+
+  template <typename T, typename E>
+  static constexpr serialized_header make(std::uint64_t n) noexcept {
+    static_assert(alignof(packed_result<T, E>) <= 64,
+                  "the records following the 64 byte header require T and E "
+                  "aligned to at most 64 bytes");
+    serialized_header h{};
+    std::copy(std::begin(magic_value), std::end(magic_value), h.magic);
+    h.byte_order = byte_order_value;
+    h.version = version_value;
+    h.header_size = sizeof(serialized_header);
+    h.record_size = sizeof(packed_result<T, E>);
+    h.record_align = alignof(packed_result<T, E>);
+    h.ok_size = sizeof(T);
+    h.err_size = sizeof(E);
+    h.count = n;
+    return h;
+  }
+
+  /// Check if the header describes packed_result<T, E> records written by
+  /// a machine with the same byte order.
+  template <typename T, typename E>
+  serialize_status validate() const noexcept {
+    const auto fail = [](serialize_errc code) {
+      return serialize_status(err_tag, serialize_error{code});
+    };
+    if (!std::equal(std::begin(magic_value), std::end(magic_value), magic)) {
+      return fail(serialize_errc::bad_magic);
+    }
+    if (byte_order != byte_order_value) {
+      return fail(serialize_errc::byte_order);
+    }
+    if (version != version_value || header_size != sizeof(serialized_header)) {
+      return fail(serialize_errc::version);
+    }
+    const auto expected = make<T, E>(count);
+    if (record_size != expected.record_size ||
+        record_align != expected.record_align ||
+        ok_size != expected.ok_size || err_size != expected.err_size) {
+      return fail(serialize_errc::layout);
+    }
+    return serialize_status(ok_tag);
+  }
+};
+
+static_assert(sizeof(serialized_header) == 64);
+
+namespace details {
+inline serialize_status write_all(int fd, const void *buf, std::size_t n,
+                                  off_t offset = -1) {
+  const auto *p = static_cast<const unsigned char *>(buf);
+  while (n > 0) {
+    ssize_t written = offset < 0 ? ::write(fd, p, n) : ::pwrite(fd, p, n, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return serialize_status(err_tag,
+                              serialize_error{serialize_errc::write, errno});
+    }
+    p += written;
+    n -= static_cast<std::size_t>(written);
+    if (offset >= 0) {
+      offset += written;
+    }
+  }
+  return serialize_status(ok_tag);
+}
+} // namespace details
+
+/// Streaming writer of packed results.
+///
+/// Records are packed into an internal buffer and written to the file in
+/// batches of \c batch_size records. The header is written when the file is
+/// created and rewritten with the final record count by close().
+///
+/// Once a batch fails to be written, the writer is failed: the records it
+/// held are dropped, write(), flush() and close() return the error, and the
+/// header keeps a count of 0 so that the file reads as empty rather than with
+/// records that are missing or torn.
+template <typename T, typename E> class result_writer {
+public:
+  using record_type = packed_result<T, E>;
+
+  static result<result_writer, serialize_error>
+  create(const char *path, std::size_t batch_size = 4096) {
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      return result<result_writer, serialize_error>(
+          err_tag, serialize_error{serialize_errc::open, errno});
+    }
+    const auto header = serialized_header::make<T, E>(0);
+    if (auto s = details::write_all(fd, &header, sizeof(header)); s.is_err()) {
+      ::close(fd);
+      return result<result_writer, serialize_error>(err_tag,
+                                                    s.err_unchecked());
+    }
+    return result<result_writer, serialize_error>(
+        ::result::ok(result_writer(fd, std::max<std::size_t>(batch_size, 1))));
+  }
+
+  result_writer(result_writer &&other) noexcept
+      : m_fd(std::exchange(other.m_fd, -1)),
+        m_buffer(std::move(other.m_buffer)), m_batch(other.m_batch),
+        m_count(other.m_count), m_status(other.m_status) {}
+
+  result_writer &operator=(result_writer &&rhs) noexcept {
+    if (this != &rhs) {
+      close();
+      m_fd = std::exchange(rhs.m_fd, -1);
+      m_buffer = std::move(rhs.m_buffer);
+      m_batch = rhs.m_batch;
+      m_count = rhs.m_count;
+      m_status = rhs.m_status;
+    }
+    return *this;
+  }
+
+  result_writer(const result_writer &) = delete;
+  result_writer &operator=(const result_writer &) = delete;
+
+  /// Finalizes the file, errors are ignored. Call close() to observe them.
+  ~result_writer() { close(); }
+
+  serialize_status write(const result<T, E> &r) {
+    if (m_status.is_err()) {
+      return m_status;
+    }
+    m_buffer.push_back(record_type::pack(r));
+    if (m_buffer.size() >= m_batch) {
+      return flush();
+    }
+    return serialize_status(ok_tag);
+  }
+
+  serialize_status write(std::span<const result<T, E>> rs) {
+    for (const auto &r : rs) {
+      if (auto s = write(r); s.is_err()) {
+        return s;
+      }
+    }
+    return serialize_status(ok_tag);
+  }
+
+  /// Write all buffered records to the file.
+  serialize_status flush() {
+    if (m_status.is_err() || m_buffer.empty()) {
+      return m_status;
+    }
+    m_status = details::write_all(m_fd, m_buffer.data(),
+                                  m_buffer.size() * sizeof(record_type));
+    if (m_status.is_ok()) {
+      m_count += m_buffer.size();
+    }
+    m_buffer.clear();
+    return m_status;
+  }
+
+  /// Flush the buffered records, store the record count in the header and
+  /// close the file. The header isn't rewritten if any flush failed.
+  serialize_status close() {
+    if (m_fd < 0) {
+      return serialize_status(ok_tag);
+    }
+    auto s = flush();
+    if (s.is_ok()) {
+      const auto header = serialized_header::make<T, E>(m_count);
+      s = details::write_all(m_fd, &header, sizeof(header), 0);
+    }
+    ::close(std::exchange(m_fd, -1));
+    return s;
+  }
+
+  /// The number of records written so far, including the buffered ones.
+  std::size_t size() const noexcept { return m_count + m_buffer.size(); }
+
+private:
+  result_writer(int fd, std::size_t batch_size) : m_fd(fd), m_batch(batch_size) {
+    m_buffer.reserve(batch_size);
+  }
+
+  int m_fd = -1;
+  std::vector<record_type> m_buffer;
+  std::size_t m_batch = 0;
+  // Records written to the file.
+  std::size_t m_count = 0;
+  serialize_status m_status{ok_tag};
+};
+
+/// Read-only memory mapped array of packed results.
+///
+/// The records are accessed in place: no result<T, E> is constructed unless
+/// packed_result<T, E>::unpack() is called.
+template <typename T, typename E> class mapped_result_array {
+public:
+  using value_type = packed_result<T, E>;
+  using const_iterator = const value_type *;
+  using iterator = const_iterator;
+  using size_type = std::size_t;
+
+  static result<mapped_result_array, serialize_error> open(const char *path) {
+    using ret_type = result<mapped_result_array, serialize_error>;
+    const auto fail = [](serialize_errc code, int e = 0) {
+      return ret_type(err_tag, serialize_error{code, e});
+    };
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return fail(serialize_errc::open, errno);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      int e = errno;
+      ::close(fd);
+      return fail(serialize_errc::stat, e);
+    }
+    const auto length = static_cast<std::size_t>(st.st_size);
+    if (length < sizeof(serialized_header)) {
+      ::close(fd);
+      return fail(serialize_errc::truncated);
+    }
+    void *addr = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    int e = errno;
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      return fail(serialize_errc::map, e);
+    }
+    mapped_result_array array(addr, length);
+    const auto &header = *static_cast<const serialized_header *>(addr);
+    if (auto s = header.template validate<T, E>(); s.is_err()) {
+      return ret_type(err_tag, s.err_unchecked());
+    }
+    if (header.count > (length - sizeof(serialized_header)) / sizeof(value_type)) {
+      return fail(serialize_errc::truncated);
+    }
+    array.m_size = static_cast<size_type>(header.count);
+    return ret_type(::result::ok(std::move(array)));
+  }
+
+  mapped_result_array(mapped_result_array &&other) noexcept
+      : m_addr(std::exchange(other.m_addr, nullptr)),
+        m_length(std::exchange(other.m_length, 0)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+  mapped_result_array &operator=(mapped_result_array &&rhs) noexcept {
+    if (this != &rhs) {
+      unmap();
+      m_addr = std::exchange(rhs.m_addr, nullptr);
+      m_length = std::exchange(rhs.m_length, 0);
+      m_size = std::exchange(rhs.m_size, 0);
+    }
+    return *this;
+  }
+
+  mapped_result_array(const mapped_result_array &) = delete;
+  mapped_result_array &operator=(const mapped_result_array &) = delete;
+
+  ~mapped_result_array() { unmap(); }
+
+  size_type size() const noexcept { return m_size; }
+
+  bool empty() const noexcept { return m_size == 0; }
+
+  const value_type &operator[](size_type i) const noexcept {
+    return data()[i];
+  }
+
+  const value_type *data() const noexcept {
+    return std::launder(reinterpret_cast<const value_type *>(
+        static_cast<const unsigned char *>(m_addr) +
+        sizeof(serialized_header)));
+  }
+
+  const_iterator begin() const noexcept { return data(); }
+
+  const_iterator end() const noexcept { return data() + m_size; }
+
+  std::span<const value_type> records() const noexcept {
+    return {data(), m_size};
+  }
+
+private:
+  mapped_result_array(void *addr, std::size_t length)
+      : m_addr(addr), m_length(length) {}
+
+  void unmap() noexcept {
+    if (m_addr != nullptr) {
+      ::munmap(m_addr, m_length);
+      m_addr = nullptr;
+    }
+  }
+
+  void *m_addr = nullptr;
+  std::size_t m_length = 0;
+  size_type m_size = 0;
+};
+
+} // namespace result
+
+#endif // RESULT_SERIALIZE_HPP
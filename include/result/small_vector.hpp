@@ -0,0 +1,223 @@
+#ifndef RESULT_SMALL_VECTOR_HPP
+#define RESULT_SMALL_VECTOR_HPP
+
+#include "relocate.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace result {
+
+/// Vector storing up to N elements inline and the rest on the heap. It
+/// only allocates once it grows beyond N elements, and relocates its
+/// elements with relocate_n when it grows.
+/// \tparam T element type
+/// \tparam N number of elements stored inline, at least 1
+template <typename T, std::size_t N> class small_vector {
+  static_assert(N > 0, "small_vector<T, N> requires N > 0");
+
+  static constexpr bool nothrow_relocatable =
+      is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  static constexpr size_type inline_capacity = N;
+
+  small_vector() noexcept = default;
+
+  small_vector(const small_vector &other) {
+    reserve(other.m_size);
+    try {
+      std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+    } catch (...) {
+      release();
+      throw;
+    }
+    m_size = other.m_size;
+  }
+
+  /// Takes over the heap buffer of other, or relocates its inline elements.
+  /// other is left empty.
+  small_vector(small_vector &&other) noexcept(nothrow_relocatable) {
+    take(other);
+  }
+
+  small_vector &operator=(const small_vector &rhs) {
+    if (this != &rhs) {
+      small_vector copy(rhs);
+      clear();
+      release();
+      take(copy);
+    }
+    return *this;
+  }
+
+  small_vector &operator=(small_vector &&rhs) noexcept(nothrow_relocatable) {
+    if (this != &rhs) {
+      clear();
+      release();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  ~small_vector() {
+    clear();
+    release();
+  }
+
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (m_size == m_capacity) {
+      return grow_emplace_back(std::forward<Args>(args)...);
+    }
+    T *element =
+        std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+    ++m_size;
+    return *element;
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  void pop_back() noexcept {
+    --m_size;
+    std::destroy_at(m_data + m_size);
+  }
+
+  /// Destroy all elements. The capacity is kept.
+  void clear() noexcept {
+    std::destroy_n(m_data, m_size);
+    m_size = 0;
+  }
+
+  void reserve(size_type capacity) {
+    if (capacity > m_capacity) {
+      reallocate(capacity);
+    }
+  }
+
+  size_type size() const noexcept { return m_size; }
+
+  size_type capacity() const noexcept { return m_capacity; }
+
+  bool empty() const noexcept { return m_size == 0; }
+
+  /// Whether the elements are stored in the inline buffer.
+  bool stored_inline() const noexcept { return m_data == inline_data(); }
+
+  T *data() noexcept { return m_data; }
+
+  const T *data() const noexcept { return m_data; }
+
+  iterator begin() noexcept { return m_data; }
+
+  const_iterator begin() const noexcept { return m_data; }
+
+  iterator end() noexcept { return m_data + m_size; }
+
+  const_iterator end() const noexcept { return m_data + m_size; }
+
+  T &operator[](size_type i) noexcept { return m_data[i]; }
+
+  const T &operator[](size_type i) const noexcept { return m_data[i]; }
+
+  T &front() noexcept { return m_data[0]; }
+
+  const T &front() const noexcept { return m_data[0]; }
+
+  T &back() noexcept { return m_data[m_size - 1]; }
+
+  const T &back() const noexcept { return m_data[m_size - 1]; }
+
+  friend bool operator==(const small_vector &lhs, const small_vector &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  T *inline_data() noexcept { return reinterpret_cast<T *>(m_inline); }
+
+  const T *inline_data() const noexcept {
+    return reinterpret_cast<const T *>(m_inline);
+  }
+
+  // Grow, constructing the new element before relocating the old ones:
+  // args may refer to an element of this vector.
+  template <typename... Args> T &grow_emplace_back(Args &&...args) {
+    const size_type capacity = std::max<size_type>(2 * m_capacity, 1);
+    T *data = std::allocator<T>().allocate(capacity);
+    T *element = nullptr;
+    try {
+      element = std::construct_at(data + m_size, std::forward<Args>(args)...);
+      relocate_n(m_data, m_size, data);
+    } catch (...) {
+      if (element != nullptr) {
+        std::destroy_at(element);
+      }
+      std::allocator<T>().deallocate(data, capacity);
+      throw;
+    }
+    release();
+    m_data = data;
+    m_capacity = capacity;
+    ++m_size;
+    return *element;
+  }
+
+  void reallocate(size_type capacity) {
+    T *data = std::allocator<T>().allocate(capacity);
+    try {
+      relocate_n(m_data, m_size, data);
+    } catch (...) {
+      std::allocator<T>().deallocate(data, capacity);
+      throw;
+    }
+    release();
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  // Free the heap buffer, if any. The elements must be destroyed or
+  // relocated already.
+  void release() noexcept {
+    if (!stored_inline()) {
+      std::allocator<T>().deallocate(m_data, m_capacity);
+      m_data = inline_data();
+      m_capacity = N;
+    }
+  }
+
+  // Take the elements of other, leaving it empty. This vector must be
+  // empty and use its inline buffer.
+  void take(small_vector &other) {
+    if (other.stored_inline()) {
+      relocate_n(other.m_data, other.m_size, m_data);
+    } else {
+      m_data = other.m_data;
+      m_capacity = other.m_capacity;
+      other.m_data = other.inline_data();
+      other.m_capacity = N;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+  }
+
+  T *m_data = inline_data();
+  size_type m_size = 0;
+  size_type m_capacity = N;
+  alignas(T) unsigned char m_inline[N * sizeof(T)];
+};
+
+} // namespace result
+
+#endif // RESULT_SMALL_VECTOR_HPP
@@ -0,0 +1,304 @@
+#ifndef RESULT_STATUS_HPP
+#define RESULT_STATUS_HPP
+
+#include "result.hpp"
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace result {
+
+/// Domain of a status code: gives the code a name, a message and an
+/// equivalent std::error_code.
+///
+/// Domains are constant objects with static storage duration, a status
+/// refers to its domain by address. Messages are only built on request.
+class status_domain {
+public:
+  constexpr explicit status_domain(std::string_view name) noexcept
+      : m_name(name) {}
+
+  status_domain(const status_domain &) = delete;
+  status_domain &operator=(const status_domain &) = delete;
+
+  constexpr std::string_view name() const noexcept { return m_name; }
+
+  virtual std::string message(std::int64_t code) const = 0;
+
+  virtual std::error_code to_error_code(std::int64_t code) const noexcept = 0;
+
+protected:
+  constexpr ~status_domain() = default;
+
+private:
+  std::string_view m_name;
+};
+
+namespace details {
+class generic_status_domain final : public status_domain {
+public:
+  constexpr generic_status_domain() noexcept : status_domain("generic") {}
+
+  std::string message(std::int64_t code) const override {
+    return std::generic_category().message(static_cast<int>(code));
+  }
+
+  std::error_code to_error_code(std::int64_t code) const noexcept override {
+    return {static_cast<int>(code), std::generic_category()};
+  }
+};
+
+class system_status_domain final : public status_domain {
+public:
+  constexpr system_status_domain() noexcept : status_domain("system") {}
+
+  std::string message(std::int64_t code) const override {
+    return std::system_category().message(static_cast<int>(code));
+  }
+
+  std::error_code to_error_code(std::int64_t code) const noexcept override {
+    return {static_cast<int>(code), std::system_category()};
+  }
+};
+
+/// Domain of the codes of a std::error_category that has no domain of its
+/// own. The category is bound when the domain is first used.
+class category_status_domain final : public status_domain {
+public:
+  constexpr category_status_domain() noexcept : status_domain("category") {}
+
+  /// Bind the domain to category, returns false if bound to another one.
+  bool bind(const std::error_category &category) noexcept {
+    const std::error_category *expected = nullptr;
+    return m_category.compare_exchange_strong(expected, &category) ||
+           expected == &category;
+  }
+
+  std::string message(std::int64_t code) const override {
+    return m_category.load()->message(static_cast<int>(code));
+  }
+
+  std::error_code to_error_code(std::int64_t code) const noexcept override {
+    return {static_cast<int>(code), *m_category.load()};
+  }
+
+private:
+  std::atomic<const std::error_category *> m_category = nullptr;
+};
+
+inline constexpr std::size_t max_categories = 32;
+
+inline std::array<category_status_domain, max_categories> category_domains;
+
+// Domain allocated for a category once category_domains is exhausted. Never
+// freed: statuses may refer to it until the end of the program.
+struct overflow_domain {
+  category_status_domain domain;
+  overflow_domain *next;
+};
+
+inline std::mutex overflow_domains_mutex;
+
+inline overflow_domain *overflow_domains = nullptr;
+
+inline const status_domain &
+category_domain(const std::error_category &category) noexcept {
+  for (auto &domain : category_domains) {
+    if (domain.bind(category)) {
+      return domain;
+    }
+  }
+  const std::lock_guard lock(overflow_domains_mutex);
+  for (auto *d = overflow_domains; d != nullptr; d = d->next) {
+    if (d->domain.bind(category)) {
+      return d->domain;
+    }
+  }
+  auto *d = new (std::nothrow) overflow_domain{{}, overflow_domains};
+  if (d == nullptr) {
+    terminate("result::status: out of memory for a std::error_category");
+  }
+  d->domain.bind(category);
+  overflow_domains = d;
+  return d->domain;
+}
+} // namespace details
+
+/// Domain of errno and std::errc values.
+inline constexpr details::generic_status_domain generic_domain;
+
+/// Domain of the values of std::system_category().
+inline constexpr details::system_status_domain system_domain;
+
+/// Error code of a domain, stored in 16 bytes and trivially copyable.
+///
+/// A result<T, status> with a trivially copyable T of up to 8 bytes is
+/// itself 16 bytes and trivially copyable, so it is returned in two
+/// registers on the common 64 bit ABIs. The status code is compared and
+/// hashed together with its domain.
+class status {
+public:
+  constexpr status(std::int64_t code, const status_domain &domain) noexcept
+      : m_code(code), m_domain(&domain) {}
+
+  constexpr status(std::errc code) noexcept
+      : status(static_cast<std::int64_t>(code), generic_domain) {}
+
+  /// Convert an error code. The generic and system categories map to
+  /// generic_domain and system_domain, other categories to a domain bound
+  /// to the category: one of 32 static domains, then a domain allocated on
+  /// the first use of the category and never freed.
+  status(const std::error_code &code) noexcept
+      : m_code(code.value()), m_domain(domain_of(code.category())) {}
+
+  /// Status of an errno value.
+  static constexpr status from_errno(int code) noexcept {
+    return {code, generic_domain};
+  }
+
+  /// Status of the current value of errno.
+  static status last_errno() noexcept { return from_errno(errno); }
+
+  constexpr std::int64_t code() const noexcept { return m_code; }
+
+  constexpr const status_domain &domain() const noexcept { return *m_domain; }
+
+  /// Message of the code, built by the domain on every call.
+  std::string message() const { return m_domain->message(m_code); }
+
+  std::error_code to_error_code() const noexcept {
+    return m_domain->to_error_code(m_code);
+  }
+
+  friend constexpr bool operator==(const status &lhs,
+                                   const status &rhs) noexcept {
+    return lhs.m_code == rhs.m_code && lhs.m_domain == rhs.m_domain;
+  }
+
+  friend constexpr bool operator==(const status &lhs, std::errc rhs) noexcept {
+    return lhs == status(rhs);
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const status &s) {
+    return os << s.domain().name() << ':' << s.code() << ' ' << s.message();
+  }
+
+private:
+  template <typename T, typename E> friend class details::result_storage;
+
+  static const status_domain *
+  domain_of(const std::error_category &category) noexcept {
+    if (category == std::generic_category()) {
+      return &generic_domain;
+    }
+    if (category == std::system_category()) {
+      return &system_domain;
+    }
+    return &details::category_domain(category);
+  }
+
+  std::int64_t m_code;
+  const status_domain *m_domain;
+};
+
+static_assert(sizeof(status) == 16);
+static_assert(std::is_trivially_copyable_v<status>);
+
+inline void hash_append(hash_state &h, const status &value) noexcept {
+  h.append(static_cast<std::uint64_t>(value.code()));
+  hash_append(h, &value.domain());
+}
+
+namespace details {
+struct to_status_fn {
+  constexpr status operator()(const status &s) const noexcept { return s; }
+
+  constexpr status operator()(std::errc code) const noexcept { return code; }
+
+  status operator()(const std::error_code &code) const noexcept {
+    return code;
+  }
+};
+
+/// Value types that fit in place of the code of a status.
+template <typename T>
+concept status_niche =
+    !std::is_reference_v<T> && std::is_trivially_copyable_v<T> &&
+    sizeof(T) <= sizeof(std::int64_t) && alignof(T) <= alignof(std::int64_t);
+
+/// Storage of a result<T, status> with a small trivially copyable T.
+///
+/// The domain pointer of a status is never null, an ok result stores its
+/// value in place of the code and a null domain pointer. The result is the
+/// size of a status.
+template <typename T>
+  requires status_niche<T>
+class result_storage<T, status> {
+public:
+  bool is_ok() const noexcept {
+    const status_domain *domain;
+    std::memcpy(&domain, m_raw + domain_offset, sizeof(domain));
+    return domain == nullptr;
+  }
+
+  template <typename... Args> void construct_ok(Args &&...args) {
+    // Assemble both words in registers, memcpy implicitly creates the T.
+    const T value(std::forward<Args>(args)...);
+    std::uint64_t word = 0;
+    std::memcpy(&word, &value, sizeof(T));
+    const status_domain *domain = nullptr;
+    std::memcpy(m_raw, &word, sizeof(word));
+    std::memcpy(m_raw + domain_offset, &domain, sizeof(domain));
+  }
+
+  template <typename... Args> void construct_err(Args &&...args) {
+    new (m_raw) status(std::forward<Args>(args)...);
+  }
+
+  void destroy() noexcept {}
+
+  T &ok_value() noexcept {
+    return *std::launder(reinterpret_cast<T *>(m_raw));
+  }
+
+  const T &ok_value() const noexcept {
+    return *std::launder(reinterpret_cast<const T *>(m_raw));
+  }
+
+  status &err_value() noexcept {
+    return *std::launder(reinterpret_cast<status *>(m_raw));
+  }
+
+  const status &err_value() const noexcept {
+    return *std::launder(reinterpret_cast<const status *>(m_raw));
+  }
+
+private:
+  static constexpr std::size_t domain_offset = offsetof(status, m_domain);
+
+  alignas(status) unsigned char m_raw[sizeof(status)];
+};
+} // namespace details
+
+/// Convert a status, std::errc or std::error_code to a status, for use with
+/// result::map_err:
+/// \code
+/// result<int, std::error_code> r = ...;
+/// result<int, status> s = r.map_err(result::to_status);
+/// \endcode
+inline constexpr details::to_status_fn to_status;
+
+} // namespace result
+
+#endif // RESULT_STATUS_HPP
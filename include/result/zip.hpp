@@ -0,0 +1,100 @@
+#ifndef RESULT_ZIP_HPP
+#define RESULT_ZIP_HPP
+
+#include "result.hpp"
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace result {
+
+namespace details {
+/// error_union_t of any number of error types.
+template <typename E, typename... Es> struct error_union_of {
+  using type = E;
+};
+
+template <typename E1, typename E2, typename... Es>
+struct error_union_of<E1, E2, Es...>
+    : error_union_of<error_union_t<E1, E2>, Es...> {};
+
+template <typename... Rs>
+using zip_error_t = typename error_union_of<
+    typename std::remove_cvref_t<Rs>::error_type...>::type;
+
+// All results are ok. The states are combined without branches: the
+// results are independent, so there is nothing to short-circuit.
+template <typename... Rs> constexpr bool all_ok(const Rs &...rs) noexcept {
+  return (static_cast<unsigned>(rs.is_ok()) & ...) != 0;
+}
+
+// Construct a Res holding the error of the first err result in rs.
+template <typename Res, typename R, typename... Rs>
+constexpr Res first_err(R &&r, Rs &&...rs) {
+  if (r.is_err()) {
+    return Res(err_tag, std::forward<R>(r).err_unchecked());
+  }
+  if constexpr (sizeof...(Rs) > 0) {
+    return first_err<Res>(std::forward<Rs>(rs)...);
+  } else {
+    unreachable();
+  }
+}
+} // namespace details
+
+/// Combine independent results into a result of the tuple of their values.
+///
+/// The states of all results are checked at once, then each value is moved
+/// (or copied, for lvalues) exactly once into the tuple. Chaining the same
+/// results with nested and_then calls moves the values collected so far at
+/// every level.
+/// \code
+/// auto r = result::zip(read_name(), read_age());
+/// // result<std::tuple<std::string, int>, E>
+/// \endcode
+/// \returns the tuple of values, or the error of the first err result.
+/// Results with different error types give the error_union_t of all of
+/// them, as and_then does.
+template <typename R, typename... Rs>
+  requires(is_result<std::remove_cvref_t<R>>::value &&
+           (is_result<std::remove_cvref_t<Rs>>::value && ...))
+constexpr auto zip(R &&r, Rs &&...rs) {
+  using tuple_type =
+      std::tuple<typename std::remove_cvref_t<R>::value_type,
+                 typename std::remove_cvref_t<Rs>::value_type...>;
+  using result_type = result<tuple_type, details::zip_error_t<R, Rs...>>;
+  if (details::all_ok(r, rs...)) {
+    return result_type(ok_tag, std::forward<R>(r).ok_unchecked(),
+                       std::forward<Rs>(rs).ok_unchecked()...);
+  }
+  return details::first_err<result_type>(std::forward<R>(r),
+                                         std::forward<Rs>(rs)...);
+}
+
+/// Call fun with the values of independent results, like map on several
+/// results at once. The values are passed to fun directly, without an
+/// intermediate tuple: a parameter taken by value costs a single move.
+/// \returns fun's return value, or the error of the first err result
+template <typename F, typename R, typename... Rs>
+  requires(is_result<std::remove_cvref_t<R>>::value &&
+           (is_result<std::remove_cvref_t<Rs>>::value && ...))
+constexpr auto apply(F &&fun, R &&r, Rs &&...rs) {
+  using value_type = std::remove_cvref_t<std::invoke_result_t<
+      F, decltype(std::forward<R>(r).ok_unchecked()),
+      decltype(std::forward<Rs>(rs).ok_unchecked())...>>;
+  using result_type = result<value_type, details::zip_error_t<R, Rs...>>;
+  if (details::all_ok(r, rs...)) {
+    return result_type(ok_tag,
+                       std::invoke(std::forward<F>(fun),
+                                   std::forward<R>(r).ok_unchecked(),
+                                   std::forward<Rs>(rs).ok_unchecked()...));
+  }
+  return details::first_err<result_type>(std::forward<R>(r),
+                                         std::forward<Rs>(rs)...);
+}
+
+} // namespace result
+
+#endif // RESULT_ZIP_HPP
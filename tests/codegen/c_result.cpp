@@ -0,0 +1,41 @@
+#include "result/c_result.hpp"
+
+// c_result<std::int64_t, std::int32_t> is 16 bytes, an INTEGER class
+// aggregate: the x86-64 SysV ABI returns it in rax:rdx and passes it in
+// two registers, as it does result<std::int64_t, std::int32_t>. Converting
+// between the two only moves registers; an out-parameter struct would be
+// stored through the pointer passed in rdi.
+
+using int64_result = result::result<std::int64_t, std::int32_t>;
+using c_int64_result = result::c_result<std::int64_t, std::int32_t>;
+
+// CODEGEN-FUNCTION: codegen_c_result_return
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: \(%rsp\)
+// CODEGEN-NOT: call
+extern "C" c_int64_result codegen_c_result_return(std::int64_t value) {
+  return result::to_c_result(int64_result(result::ok_tag, value));
+}
+
+// CODEGEN-FUNCTION: codegen_c_result_to_c
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: \(%rsp\)
+// CODEGEN-NOT: call
+extern "C" c_int64_result codegen_c_result_to_c(int64_result r) {
+  return result::to_c_result(r);
+}
+
+// CODEGEN-FUNCTION: codegen_c_result_from_c
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: \(%rsp\)
+// CODEGEN-NOT: call
+extern "C" int64_result codegen_c_result_from_c(c_int64_result r) {
+  return result::from_c_result(r);
+}
+
+// CODEGEN-FUNCTION: codegen_c_result_value_or
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: call
+extern "C" std::int64_t codegen_c_result_value_or(c_int64_result r) {
+  return r.is_ok() ? r.value.ok : -1;
+}
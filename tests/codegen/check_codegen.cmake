@@ -0,0 +1,48 @@
+# Compile SOURCE to assembly in OUTPUT and check the annotations of SOURCE:
+#
+#   // CODEGEN-FUNCTION: name   start checking the function `name`
+#   // CODEGEN-MATCH: regex     its body must match regex
+#   // CODEGEN-NOT: regex       its body must not match regex
+#
+# Annotated functions are declared extern "C" so their names are not mangled.
+execute_process(
+        COMMAND ${COMPILER} -std=c++20 -O2 -S -fno-asynchronous-unwind-tables
+                -I${INCLUDE_DIR} ${SOURCE} -o ${OUTPUT}
+        RESULT_VARIABLE status
+        ERROR_VARIABLE errors
+)
+if (NOT status EQUAL 0)
+    message(FATAL_ERROR "Failed to compile ${SOURCE}:\n${errors}")
+endif ()
+
+file(READ ${OUTPUT} assembly)
+file(STRINGS ${SOURCE} annotations REGEX "// CODEGEN-")
+
+set(failures 0)
+foreach (annotation ${annotations})
+    if (annotation MATCHES "// CODEGEN-FUNCTION: ([A-Za-z0-9_]+)")
+        set(function ${CMAKE_MATCH_1})
+        string(FIND "${assembly}" "\n${function}:" begin)
+        if (begin EQUAL -1)
+            message(FATAL_ERROR "${function} not found in ${OUTPUT}")
+        endif ()
+        string(SUBSTRING "${assembly}" ${begin} -1 body)
+        string(FIND "${body}" ".size\t${function}," end)
+        string(SUBSTRING "${body}" 0 ${end} body)
+    elseif (annotation MATCHES "// CODEGEN-MATCH: (.*)$")
+        if (NOT body MATCHES "${CMAKE_MATCH_1}")
+            message(SEND_ERROR "${function} doesn't match ${CMAKE_MATCH_1}:\n${body}")
+            math(EXPR failures "${failures} + 1")
+        endif ()
+    elseif (annotation MATCHES "// CODEGEN-NOT: (.*)$")
+        set(pattern "${CMAKE_MATCH_1}")
+        if (body MATCHES "${pattern}")
+            message(SEND_ERROR "${function} matches ${pattern}:\n${body}")
+            math(EXPR failures "${failures} + 1")
+        endif ()
+    endif ()
+endforeach ()
+
+if (failures GREATER 0)
+    message(FATAL_ERROR "${failures} codegen check(s) failed in ${SOURCE}")
+endif ()
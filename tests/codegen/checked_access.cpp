@@ -0,0 +1,38 @@
+// Release mode: the state read by an unchecked access is assumed.
+#define RESULT_CHECKED_ACCESS 0
+#include "result/result.hpp"
+
+// After ok_unchecked(), the result is known to be ok: the later checks of
+// its state compile to nothing, and the value is returned without a branch.
+
+// CODEGEN-FUNCTION: codegen_assumed_ok_is_ok
+// CODEGEN-NOT: test|cmp
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" int codegen_assumed_ok_is_ok(result::result<int, int> r) {
+  const int value = r.ok_unchecked();
+  return r.is_ok() ? value : -1;
+}
+
+// CODEGEN-FUNCTION: codegen_assumed_ok_unwrap
+// CODEGEN-NOT: call
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" int codegen_assumed_ok_unwrap(result::result<int, int> r) {
+  const int value = r.ok_unchecked();
+  return value + r.unwrap();
+}
+
+// CODEGEN-FUNCTION: codegen_assumed_err_map
+// CODEGEN-NOT: test|cmp
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" int codegen_assumed_err_map(result::result<int, int> r) {
+  const int error = r.err_unchecked();
+  return r.map([](int v) { return v * 3; }).unwrap_or_default() + error;
+}
+
+// Without a preceding access, the check stays.
+
+// CODEGEN-FUNCTION: codegen_checked_unwrap
+// CODEGEN-MATCH: terminate
+extern "C" int codegen_checked_unwrap(result::result<int, int> r) {
+  return r.unwrap();
+}
@@ -0,0 +1,12 @@
+#include "result/exception.hpp"
+
+// The throw of throw_if_err is out of line: the ok path is a test, a
+// branch to the cold call and a return.
+
+// CODEGEN-FUNCTION: codegen_throw_if_err
+// CODEGEN-NOT: __cxa_allocate_exception
+// CODEGEN-NOT: __cxa_throw
+extern "C" int
+codegen_throw_if_err(result::result<int, result::status> r) {
+  return result::throw_if_err(std::move(r));
+}
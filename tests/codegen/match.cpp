@@ -0,0 +1,55 @@
+// Release mode, as match() reads the payload through the unchecked
+// accessors.
+#define RESULT_CHECKED_ACCESS 0
+#include "result/result.hpp"
+
+enum class parse_error : int { empty = 1, overflow };
+
+int on_value(int);
+int on_error(parse_error);
+
+// The state is tested once, and each handler is a tail call.
+
+// CODEGEN-FUNCTION: codegen_match_calls
+// CODEGEN-MATCH: on_value
+// CODEGEN-MATCH: on_error
+// CODEGEN-NOT: (test|cmp).*(test|cmp)
+extern "C" int codegen_match_calls(result::result<int, parse_error> r) {
+  return r.match(on_value, on_error);
+}
+
+// Handlers without side effects are both evaluated and the state selects
+// one of the values, as for the hand-written conditional.
+
+// CODEGEN-FUNCTION: codegen_match_branchless
+// CODEGEN-MATCH: cmov
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" int codegen_match_branchless(result::result<int, parse_error> r) {
+  return r.match([](int v) { return v * 2; },
+                 [](parse_error e) { return -static_cast<int>(e); });
+}
+
+// CODEGEN-FUNCTION: codegen_visit_branchless
+// CODEGEN-MATCH: cmov
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" int codegen_visit_branchless(result::result<int, parse_error> r) {
+  return result::visit(result::overloaded{[](int v) { return v + 1; },
+                                          [](parse_error) { return 0; }},
+                       r);
+}
+
+// CODEGEN-FUNCTION: codegen_select
+// CODEGEN-MATCH: cmov
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" int codegen_select(result::result<int, parse_error> r, int if_ok,
+                              int if_err) {
+  return r.select(if_ok, if_err);
+}
+
+// CODEGEN-FUNCTION: codegen_select_pointer
+// CODEGEN-MATCH: cmov
+// CODEGEN-NOT: \tj[a-z]+\t
+extern "C" const char *
+codegen_select_pointer(const result::result<long, parse_error> &r) {
+  return r.select("ok", "err");
+}
@@ -0,0 +1,38 @@
+#include "result/status.hpp"
+
+// result<int, status> is 16 bytes and trivially copyable, the x86-64 SysV
+// ABI passes it in two registers and returns it in rax:rdx. A result
+// returned in memory would be stored through the pointer passed in rdi.
+
+// CODEGEN-FUNCTION: codegen_status_return_ok
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: \(%rsp\)
+// CODEGEN-NOT: call
+extern "C" result::result<int, result::status>
+codegen_status_return_ok(int value) {
+  return result::ok(value);
+}
+
+// CODEGEN-FUNCTION: codegen_status_return_err
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: \(%rsp\)
+// CODEGEN-NOT: call
+extern "C" result::result<int, result::status>
+codegen_status_return_err(int code) {
+  return result::err(result::status::from_errno(code));
+}
+
+// CODEGEN-FUNCTION: codegen_status_unwrap
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: call
+extern "C" int codegen_status_unwrap(result::result<int, result::status> r) {
+  return r.is_ok() ? r.ok_unchecked() : -1;
+}
+
+// CODEGEN-FUNCTION: codegen_status_map
+// CODEGEN-NOT: \(%rdi\)
+// CODEGEN-NOT: call
+extern "C" result::result<int, result::status>
+codegen_status_map(result::result<int, result::status> r) {
+  return r.map([](int v) { return v + 1; });
+}
@@ -0,0 +1,24 @@
+#include "result/result.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+// Access the payload a result doesn't hold, which must terminate the
+// program with RESULT_CHECKED_ACCESS=1.
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    return 2;
+  }
+  // CTest fails a test killed by a signal whatever its output: exit
+  // instead of aborting.
+  std::set_terminate([] { std::_Exit(EXIT_FAILURE); });
+  result::result<int, int> ok(result::ok_tag, 1);
+  result::result<int, int> err(result::err_tag, 2);
+  if (std::strcmp(argv[1], "ok_unchecked") == 0) {
+    std::cout << err.ok_unchecked() << std::endl;
+  } else if (std::strcmp(argv[1], "err_unchecked") == 0) {
+    std::cout << ok.err_unchecked() << std::endl;
+  }
+  return 0;
+}
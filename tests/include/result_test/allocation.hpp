@@ -0,0 +1,59 @@
+#ifndef RESULT_TEST_ALLOCATION_HPP
+#define RESULT_TEST_ALLOCATION_HPP
+
+#include <cstddef>
+
+namespace result_test {
+
+/// Number of calls to the replaceable global operator new and operator
+/// delete made by a thread, including the array, aligned and nothrow forms.
+struct allocation_counts {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes = 0;
+
+  friend bool operator==(const allocation_counts &,
+                         const allocation_counts &) = default;
+};
+
+/// Counts of the calling thread since it started.
+allocation_counts thread_allocation_counts() noexcept;
+
+/// Counts the allocations made by the calling thread during its lifetime.
+/// Scopes can be nested, each one sees the allocations of the inner ones.
+/// \code
+/// result_test::allocation_scope scope;
+/// auto r = make_result();
+/// const auto allocations = scope.allocations(); // before Catch allocates
+/// REQUIRE(allocations == 0);
+/// \endcode
+class allocation_scope {
+public:
+  allocation_scope() noexcept : m_start(thread_allocation_counts()) {}
+
+  allocation_scope(const allocation_scope &) = delete;
+  allocation_scope &operator=(const allocation_scope &) = delete;
+
+  allocation_counts counts() const noexcept {
+    const auto now = thread_allocation_counts();
+    return {now.allocations - m_start.allocations,
+            now.deallocations - m_start.deallocations,
+            now.bytes - m_start.bytes};
+  }
+
+  std::size_t allocations() const noexcept { return counts().allocations; }
+
+  std::size_t deallocations() const noexcept {
+    return counts().deallocations;
+  }
+
+  /// Start counting again from zero.
+  void reset() noexcept { m_start = thread_allocation_counts(); }
+
+private:
+  allocation_counts m_start;
+};
+
+} // namespace result_test
+
+#endif // RESULT_TEST_ALLOCATION_HPP
@@ -0,0 +1,44 @@
+/*
+ * Functions shared by the C translation unit src/c_result.c and the C++
+ * tests in src/c_result.cpp, to check that results cross the language
+ * boundary in both directions.
+ */
+#ifndef RESULT_TEST_C_FUNCTIONS_H
+#define RESULT_TEST_C_FUNCTIONS_H
+
+#include "result/c_result.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+RESULT_C_DECLARE(int64_result, int64_t, int32_t);
+
+typedef struct point {
+  int32_t x;
+  int32_t y;
+  double weight;
+} point;
+
+RESULT_C_DECLARE(point_result, point, int32_t);
+
+/* The layout of the types as seen by the C compiler. */
+typedef struct c_layout {
+  size_t size;
+  size_t alignment;
+  size_t value_offset;
+} c_layout;
+
+#define RESULT_TEST_DIVIDE_BY_ZERO 33
+
+/* Implemented in C. */
+RESULT_C_EXTERN c_layout c_int64_result_layout(void);
+RESULT_C_EXTERN c_layout c_point_result_layout(void);
+RESULT_C_EXTERN int64_result c_divide(int64_t a, int64_t b);
+RESULT_C_EXTERN int64_t c_value_or(int64_result r, int64_t fallback);
+RESULT_C_EXTERN point_result c_make_point(int32_t x, int32_t y);
+RESULT_C_EXTERN int64_result c_sum_parsed(const char *const *texts, size_t n);
+
+/* Implemented in C++, called by c_sum_parsed. */
+RESULT_C_EXTERN int64_result cpp_parse(const char *text);
+
+#endif /* RESULT_TEST_C_FUNCTIONS_H */
@@ -0,0 +1,78 @@
+#ifndef RESULT_TEST_FAILING_ALLOCATOR_HPP
+#define RESULT_TEST_FAILING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace result_test {
+
+/// Allocations left before a failing_allocator starts failing, shared by
+/// the copies of the allocator.
+struct allocation_budget {
+  /// Allocations that succeed before the next ones fail.
+  std::size_t remaining = std::numeric_limits<std::size_t>::max();
+  /// Allocations of more bytes than this fail.
+  std::size_t max_bytes = std::numeric_limits<std::size_t>::max();
+  std::size_t allocations = 0;
+  std::size_t failures = 0;
+
+  /// Let the next n allocations succeed, and fail the ones after.
+  void fail_after(std::size_t n) noexcept { remaining = n; }
+};
+
+/// Allocator failing deterministically once its budget is spent, or for
+/// allocations above budget.max_bytes: try_allocate() returns nullptr and
+/// allocate() throws std::bad_alloc.
+/// \code
+/// result_test::allocation_budget budget;
+/// result::try_vector<int, result_test::failing_allocator<int>> v(
+///     result_test::failing_allocator<int>(budget));
+/// budget.fail_after(1); // the second allocation fails
+/// \endcode
+template <typename T> class failing_allocator {
+public:
+  using value_type = T;
+
+  explicit failing_allocator(allocation_budget &budget) noexcept
+      : m_budget(&budget) {}
+
+  template <typename U>
+  failing_allocator(const failing_allocator<U> &other) noexcept
+      : m_budget(other.budget()) {}
+
+  T *try_allocate(std::size_t n) noexcept {
+    if (m_budget->remaining == 0 || n > m_budget->max_bytes / sizeof(T)) {
+      ++m_budget->failures;
+      return nullptr;
+    }
+    --m_budget->remaining;
+    ++m_budget->allocations;
+    return static_cast<T *>(::operator new(n * sizeof(T), std::nothrow));
+  }
+
+  T *allocate(std::size_t n) {
+    if (T *p = try_allocate(n)) {
+      return p;
+    }
+    throw std::bad_alloc();
+  }
+
+  void deallocate(T *p, std::size_t) noexcept { ::operator delete(p); }
+
+  allocation_budget *budget() const noexcept { return m_budget; }
+
+  template <typename U>
+  friend bool operator==(const failing_allocator &lhs,
+                         const failing_allocator<U> &rhs) noexcept {
+    return lhs.budget() == rhs.budget();
+  }
+
+private:
+  allocation_budget *m_budget;
+};
+
+} // namespace result_test
+
+#endif // RESULT_TEST_FAILING_ALLOCATOR_HPP
@@ -0,0 +1,108 @@
+#ifndef RESULT_TEST_TRACKED_HPP
+#define RESULT_TEST_TRACKED_HPP
+
+#include <compare>
+#include <type_traits>
+#include <utility>
+
+namespace result_test {
+
+/// Special member calls counted by tracked<T, Tag>.
+struct tracked_counts {
+  int value_constructions = 0;
+  int copy_constructions = 0;
+  int move_constructions = 0;
+  int copy_assignments = 0;
+  int move_assignments = 0;
+  int destructions = 0;
+
+  int copies() const noexcept { return copy_constructions + copy_assignments; }
+
+  int moves() const noexcept { return move_constructions + move_assignments; }
+
+  /// Objects constructed and not destroyed yet.
+  int alive() const noexcept {
+    return value_constructions + copy_constructions + move_constructions -
+           destructions;
+  }
+
+  friend bool operator==(const tracked_counts &,
+                         const tracked_counts &) = default;
+};
+
+/// Payload wrapping a T that counts its constructions, copies, moves and
+/// destructions. Each Tag has its own counters, so the ok and err payloads
+/// of a result can be told apart:
+/// \code
+/// using value = result_test::tracked<int, struct value_tag>;
+/// using error = result_test::tracked<int, struct error_tag>;
+/// \endcode
+/// Special members are noexcept exactly when those of T are.
+template <typename T, typename Tag = void> class tracked {
+public:
+  tracked() noexcept(std::is_nothrow_default_constructible_v<T>)
+    requires std::is_default_constructible_v<T>
+      : m_value() {
+    ++s_counts.value_constructions;
+  }
+
+  template <typename... Args>
+    requires(sizeof...(Args) > 0 && std::is_constructible_v<T, Args && ...>)
+  explicit tracked(Args &&...args) noexcept(
+      std::is_nothrow_constructible_v<T, Args &&...>)
+      : m_value(std::forward<Args>(args)...) {
+    ++s_counts.value_constructions;
+  }
+
+  tracked(const tracked &other) noexcept(
+      std::is_nothrow_copy_constructible_v<T>)
+      : m_value(other.m_value) {
+    ++s_counts.copy_constructions;
+  }
+
+  tracked(tracked &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      : m_value(std::move(other.m_value)) {
+    ++s_counts.move_constructions;
+  }
+
+  tracked &operator=(const tracked &rhs) noexcept(
+      std::is_nothrow_copy_assignable_v<T>) {
+    m_value = rhs.m_value;
+    ++s_counts.copy_assignments;
+    return *this;
+  }
+
+  tracked &operator=(tracked &&rhs) noexcept(
+      std::is_nothrow_move_assignable_v<T>) {
+    m_value = std::move(rhs.m_value);
+    ++s_counts.move_assignments;
+    return *this;
+  }
+
+  ~tracked() { ++s_counts.destructions; }
+
+  T &value() noexcept { return m_value; }
+
+  const T &value() const noexcept { return m_value; }
+
+  static tracked_counts counts() noexcept { return s_counts; }
+
+  static void reset() noexcept { s_counts = {}; }
+
+  friend bool operator==(const tracked &lhs, const tracked &rhs) {
+    return lhs.m_value == rhs.m_value;
+  }
+
+  friend auto operator<=>(const tracked &lhs, const tracked &rhs) {
+    return lhs.m_value <=> rhs.m_value;
+  }
+
+private:
+  static inline tracked_counts s_counts;
+
+  T m_value;
+};
+
+} // namespace result_test
+
+#endif // RESULT_TEST_TRACKED_HPP
@@ -0,0 +1,373 @@
+#include "result/collect.hpp"
+#include "result/interop.hpp"
+#include "result/result.hpp"
+#include "result_test/allocation.hpp"
+#include "result_test/tracked.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Exact copy, move and allocation counts of the public result operations
+// for every value category. A change in one of these counts changes the
+// cost of the operation and must be deliberate.
+
+namespace accounting_test {
+using value = result_test::tracked<int, struct value_tag>;
+using error = result_test::tracked<int, struct error_tag>;
+using tracked_result = result::result<value, error>;
+
+/// {value copies, value moves, error copies, error moves, allocations}
+using counts = std::array<int, 5>;
+
+/// Run f and count the copies, moves and heap allocations it made. Catch
+/// allocates while it evaluates assertions, so f must not assert.
+template <typename F> counts measure(F &&f) {
+  value::reset();
+  error::reset();
+  result_test::allocation_scope scope;
+  f();
+  const auto allocations = static_cast<int>(scope.allocations());
+  const auto v = value::counts();
+  const auto e = error::counts();
+  return {v.copies(), v.moves(), e.copies(), e.moves(), allocations};
+}
+
+tracked_result make_ok(int v) { return tracked_result(result::ok_tag, v); }
+
+tracked_result make_err(int e) { return tracked_result(result::err_tag, e); }
+} // namespace accounting_test
+
+using namespace accounting_test;
+
+TEST_CASE("construction counts", "[accounting]") {
+  SECTION("in place from ok_tag / err_tag") {
+    REQUIRE(measure([] {
+              tracked_result ok(result::ok_tag, 1);
+              tracked_result err(result::err_tag, 2);
+            }) == counts{0, 0, 0, 0, 0});
+  }
+  SECTION("make_ok / make_err") {
+    REQUIRE(measure([] {
+              auto ok = result::make_ok<value, error>(1);
+              auto err = result::make_err<value, error>(2);
+            }) == counts{0, 0, 0, 0, 0});
+  }
+  SECTION("ok_ref / err_ref move once") {
+    REQUIRE(measure([] {
+              tracked_result ok = result::ok_ref(value(1));
+              tracked_result err = result::err_ref(error(2));
+            }) == counts{0, 1, 0, 1, 0});
+  }
+  SECTION("ok() / err() wrappers move twice") {
+    REQUIRE(measure([] {
+              tracked_result ok = result::ok(value(1));
+              tracked_result err = result::err(error(2));
+            }) == counts{0, 2, 0, 2, 0});
+  }
+  SECTION("copy") {
+    const auto ok = make_ok(1);
+    const auto err = make_err(2);
+    REQUIRE(measure([&] {
+              tracked_result ok2 = ok;
+              tracked_result err2 = err;
+            }) == counts{1, 0, 1, 0, 0});
+  }
+  SECTION("move") {
+    auto ok = make_ok(1);
+    auto err = make_err(2);
+    REQUIRE(measure([&] {
+              tracked_result ok2 = std::move(ok);
+              tracked_result err2 = std::move(err);
+            }) == counts{0, 1, 0, 1, 0});
+  }
+}
+
+TEST_CASE("assignment counts", "[accounting]") {
+  auto ok = make_ok(1);
+  auto err = make_err(2);
+
+  SECTION("copy, same state assigns") {
+    auto target = make_ok(3);
+    REQUIRE(measure([&] { target = ok; }) == counts{1, 0, 0, 0, 0});
+    REQUIRE(value::counts().copy_assignments == 1);
+  }
+  SECTION("copy, other state constructs") {
+    auto target = make_err(3);
+    REQUIRE(measure([&] { target = ok; }) == counts{1, 0, 0, 0, 0});
+    REQUIRE(value::counts().copy_constructions == 1);
+    REQUIRE(error::counts().destructions == 1);
+  }
+  SECTION("move, same state assigns") {
+    auto target = make_err(3);
+    REQUIRE(measure([&] { target = std::move(err); }) ==
+            counts{0, 0, 0, 1, 0});
+    REQUIRE(error::counts().move_assignments == 1);
+  }
+  SECTION("move, other state constructs") {
+    auto target = make_err(3);
+    REQUIRE(measure([&] { target = std::move(ok); }) ==
+            counts{0, 1, 0, 0, 0});
+    REQUIRE(value::counts().move_constructions == 1);
+  }
+  SECTION("from ok() / err() wrappers") {
+    auto target = make_ok(3);
+    REQUIRE(measure([&] { target = result::ok(value(4)); }) ==
+            counts{0, 2, 0, 0, 0});
+    REQUIRE(measure([&] { target = result::err(error(5)); }) ==
+            counts{0, 0, 0, 2, 0});
+  }
+}
+
+TEST_CASE("accessor counts", "[accounting]") {
+  auto ok = make_ok(1);
+  auto err = make_err(2);
+
+  SECTION("lvalue accessors return references") {
+    REQUIRE(measure([&] {
+              static_cast<void>(ok.ok_unchecked());
+              static_cast<void>(std::as_const(ok).ok_unchecked());
+              static_cast<void>(err.err_unchecked());
+              static_cast<void>(ok.ok());
+              static_cast<void>(err.err());
+              static_cast<void>(ok.try_ok());
+              static_cast<void>(err.try_err());
+              static_cast<void>(ok == err);
+            }) == counts{0, 0, 0, 0, 0});
+  }
+  SECTION("ok() && / err() && move into the optional") {
+    REQUIRE(measure([&] {
+              auto o = std::move(ok).ok();
+              auto e = std::move(err).err();
+            }) == counts{0, 1, 0, 1, 0});
+  }
+  SECTION("unwrap / unwrap_err return references") {
+    REQUIRE(measure([&] {
+              static_cast<void>(ok.unwrap());
+              static_cast<void>(err.unwrap_err());
+            }) == counts{0, 0, 0, 0, 0});
+    REQUIRE(measure([&] { value taken = ok.unwrap(); }) ==
+            counts{0, 1, 0, 0, 0});
+  }
+  SECTION("expect / expect_err") {
+    REQUIRE(measure([&] {
+              value v = ok.expect("ok");
+              error e = err.expect_err("err");
+            }) == counts{0, 1, 0, 1, 0});
+  }
+  SECTION("unwrap_or moves the selected value once") {
+    REQUIRE(measure([&] { value v = ok.unwrap_or(value(7)); }) ==
+            counts{0, 1, 0, 0, 0});
+    REQUIRE(measure([&] { value v = err.unwrap_or(value(8)); }) ==
+            counts{0, 1, 0, 0, 0});
+  }
+  SECTION("unwrap_or_default") {
+    REQUIRE(measure([&] {
+              value v = ok.unwrap_or_default();
+              value d = err.unwrap_or_default();
+            }) == counts{0, 1, 0, 0, 0});
+  }
+}
+
+TEST_CASE("map counts", "[accounting]") {
+  auto ok = make_ok(1);
+  auto err = make_err(2);
+  const auto &cok = ok;
+  const auto &cerr = err;
+  auto inc = [](const value &v) { return v.value() + 1; };
+  auto take = [](value &&v) { return value(std::move(v)); };
+  auto einc = [](const error &e) { return e.value() + 1; };
+
+  SECTION("lvalue ok: fun reads the value") {
+    REQUIRE(measure([&] {
+              auto r = ok.map(inc);
+              auto r2 = cok.map(inc);
+            }) == counts{0, 0, 0, 0, 0});
+  }
+  SECTION("lvalue err: the error is copied") {
+    REQUIRE(measure([&] {
+              auto r = err.map(inc);
+              auto r2 = cerr.map(inc);
+            }) == counts{0, 0, 2, 0, 0});
+  }
+  SECTION("rvalue ok: fun receives an rvalue") {
+    // One move in take, one of its return value into the result.
+    REQUIRE(measure([&] { auto r = std::move(ok).map(take); }) ==
+            counts{0, 2, 0, 0, 0});
+  }
+  SECTION("rvalue err: the error is moved") {
+    REQUIRE(measure([&] { auto r = std::move(err).map(take); }) ==
+            counts{0, 0, 0, 1, 0});
+  }
+  SECTION("map_err") {
+    REQUIRE(measure([&] {
+              auto r = ok.map_err(einc);
+              auto r2 = err.map_err(einc);
+            }) == counts{1, 0, 0, 0, 0});
+    REQUIRE(measure([&] { auto r = std::move(ok).map_err(einc); }) ==
+            counts{0, 1, 0, 0, 0});
+  }
+  SECTION("map_or_else only calls one function") {
+    auto d = [](const error &e) { return e.value(); };
+    REQUIRE(measure([&] {
+              int a = ok.map_or_else(d, inc);
+              int b = std::move(err).map_or_else(d, inc);
+              static_cast<void>(a + b);
+            }) == counts{0, 0, 0, 0, 0});
+  }
+}
+
+TEST_CASE("and_then / or_else counts", "[accounting]") {
+  auto ok = make_ok(1);
+  auto err = make_err(2);
+  auto next = [](const value &v) { return make_ok(v.value() + 1); };
+  auto next_rv = [](value &&v) {
+    return tracked_result(result::ok_tag, std::move(v));
+  };
+  auto recover = [](const error &e) { return make_ok(e.value()); };
+  auto recover_rv = [](error &&e) {
+    return tracked_result(result::err_tag, std::move(e));
+  };
+
+  SECTION("lvalue and_then: the result of fun is returned directly") {
+    REQUIRE(measure([&] { auto r = ok.and_then(next); }) ==
+            counts{0, 0, 0, 0, 0});
+    REQUIRE(measure([&] { auto r = err.and_then(next); }) ==
+            counts{0, 0, 1, 0, 0});
+  }
+  SECTION("rvalue and_then") {
+    REQUIRE(measure([&] { auto r = std::move(ok).and_then(next_rv); }) ==
+            counts{0, 1, 0, 0, 0});
+    REQUIRE(measure([&] { auto r = std::move(err).and_then(next_rv); }) ==
+            counts{0, 0, 0, 1, 0});
+  }
+  SECTION("lvalue or_else") {
+    REQUIRE(measure([&] { auto r = err.or_else(recover); }) ==
+            counts{0, 0, 0, 0, 0});
+    REQUIRE(measure([&] { auto r = ok.or_else(recover); }) ==
+            counts{1, 0, 0, 0, 0});
+  }
+  SECTION("rvalue or_else") {
+    REQUIRE(measure([&] { auto r = std::move(err).or_else(recover_rv); }) ==
+            counts{0, 0, 0, 1, 0});
+    REQUIRE(measure([&] { auto r = std::move(ok).or_else(recover_rv); }) ==
+            counts{0, 1, 0, 0, 0});
+  }
+  SECTION("and_ / or_ take their argument by value") {
+    REQUIRE(measure([&] { auto r = std::move(ok).and_(make_ok(3)); }) ==
+            counts{0, 1, 0, 0, 0});
+    REQUIRE(measure([&] { auto r = std::move(err).or_(make_err(4)); }) ==
+            counts{0, 0, 0, 1, 0});
+  }
+  SECTION("inspect") {
+    int seen = 0;
+    REQUIRE(measure([&] {
+              ok.inspect([&seen](const value &v) { seen += v.value(); });
+              err.inspect_err([&seen](const error &e) { seen += e.value(); });
+            }) == counts{0, 0, 0, 0, 0});
+    REQUIRE(seen == 3);
+    REQUIRE(measure([&] {
+              auto r = std::move(ok).inspect([](const value &) {});
+            }) == counts{0, 1, 0, 0, 0});
+  }
+}
+
+TEST_CASE("swap counts", "[accounting]") {
+  auto a = make_ok(1);
+  auto b = make_ok(2);
+  auto c = make_err(3);
+
+  SECTION("same state") {
+    REQUIRE(measure([&] { swap(a, b); }) == counts{0, 3, 0, 0, 0});
+    REQUIRE(a.ok_unchecked().value() == 2);
+  }
+  SECTION("mixed states") {
+    REQUIRE(measure([&] { swap(a, c); }) == counts{0, 2, 0, 1, 0});
+    REQUIRE(a.err_unchecked().value() == 3);
+    REQUIRE(c.ok_unchecked().value() == 1);
+  }
+}
+
+TEST_CASE("conversion counts", "[accounting]") {
+  using optional_result = result::result<value, result::empty_tag_t>;
+
+  SECTION("to_optional / from_optional move once each") {
+    optional_result r(result::ok_tag, 1);
+    REQUIRE(measure([&] {
+              auto o = result::to_optional(std::move(r));
+              auto back = result::from_optional(std::move(o));
+            }) == counts{0, 2, 0, 0, 0});
+  }
+#if defined(__cpp_lib_expected)
+  SECTION("to_expected / from_expected move once each") {
+    auto r = make_err(2);
+    REQUIRE(measure([&] {
+              auto e = result::to_expected(std::move(r));
+              auto back = result::from_expected(std::move(e));
+            }) == counts{0, 0, 0, 2, 0});
+  }
+#endif
+}
+
+TEST_CASE("collect_all / validate counts", "[accounting]") {
+  std::vector<tracked_result> oks;
+  std::vector<tracked_result> errs;
+  for (int i = 0; i < 4; ++i) {
+    oks.push_back(make_ok(i));
+    errs.push_back(make_err(i));
+  }
+
+  SECTION("ok values are copied or moved once into one allocation") {
+    REQUIRE(measure([&] { auto r = result::collect_all(oks); }) ==
+            counts{4, 0, 0, 0, 1});
+    REQUIRE(measure([&] { auto r = result::collect_all(std::move(oks)); }) ==
+            counts{0, 4, 0, 0, 1});
+  }
+  SECTION("up to four errors don't allocate for the error list") {
+    // Each error is moved into the list, then the inline list is relocated
+    // into the returned result. The only allocation is the reserved vector
+    // of values.
+    REQUIRE(measure([&] { auto r = result::collect_all(std::move(errs)); }) ==
+            counts{0, 0, 0, 8, 1});
+  }
+  SECTION("validate") {
+    REQUIRE(measure([&] {
+              auto r = result::validate(make_ok(1), make_ok(2));
+            }) == counts{0, 2, 0, 0, 0});
+    REQUIRE(measure([&] {
+              auto r = result::validate(make_ok(1), make_err(2));
+            }) == counts{0, 0, 0, 2, 0});
+  }
+}
+
+TEST_CASE("payload allocations", "[accounting]") {
+  using string_result = result::result<std::string, int>;
+  string_result r(result::ok_tag, std::string(100, 'x'));
+
+  SECTION("moves don't allocate") {
+    REQUIRE(measure([&] {
+              string_result moved = std::move(r);
+              string_result back = std::move(moved).map(
+                  [](std::string &&s) { return std::move(s); });
+            })[4] == 0);
+  }
+  SECTION("a copy allocates once") {
+    REQUIRE(measure([&] { string_result copy = r; })[4] == 1);
+  }
+}
+
+TEST_CASE("no payload leaks", "[accounting]") {
+  measure([] {
+    auto a = make_ok(1);
+    auto b = make_err(2);
+    a = b;
+    b = make_ok(3);
+    swap(a, b);
+    auto c = std::move(a).and_then([](value &&v) {
+      return tracked_result(result::ok_tag, std::move(v));
+    });
+  });
+  REQUIRE(value::counts().alive() == 0);
+  REQUIRE(error::counts().alive() == 0);
+}
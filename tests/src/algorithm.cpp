@@ -0,0 +1,52 @@
+#include "result/algorithm.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+using result_type = result::result<std::string, int>;
+
+namespace {
+std::vector<result_type> make_results() {
+  std::vector<result_type> v;
+  for (int i = 0; i < 50; ++i) {
+    if (i % 3 == 0) {
+      v.emplace_back(result::err_tag, i);
+    } else {
+      v.emplace_back(result::ok_tag, std::to_string((i * 37) % 50));
+    }
+  }
+  return v;
+}
+} // namespace
+
+TEST_CASE("result::sort_results(first, last)", "[algorithm]") {
+  auto v = make_results();
+  auto expected = v;
+  std::sort(expected.begin(), expected.end());
+
+  auto mid = result::sort_results(v.begin(), v.end());
+  REQUIRE(std::is_sorted(v.begin(), v.end()));
+  REQUIRE(std::all_of(v.begin(), mid, [](const auto &r) { return r.is_err(); }));
+  REQUIRE(std::all_of(mid, v.end(), [](const auto &r) { return r.is_ok(); }));
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    REQUIRE(((v[i] <=> expected[i]) == 0));
+  }
+}
+
+TEST_CASE("result::sort_results(range, comp)", "[algorithm]") {
+  auto v = make_results();
+  auto mid = result::sort_results(v, std::greater<>{});
+  REQUIRE(std::is_sorted(mid, v.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.ok_unchecked() > rhs.ok_unchecked();
+  }));
+  REQUIRE(std::all_of(v.begin(), mid, [](const auto &r) { return r.is_err(); }));
+}
+
+TEST_CASE("std::sort of results through ADL", "[algorithm]") {
+  auto v = make_results();
+  using std::sort;
+  sort(v.begin(), v.end());
+  REQUIRE(std::is_sorted(v.begin(), v.end()));
+}
@@ -0,0 +1,140 @@
+#include "result/any_error.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <memory>
+#include <string>
+
+namespace any_error_test {
+struct small_error {
+  int code;
+};
+
+struct large_error {
+  std::array<char, 128> text{};
+  int code;
+};
+
+struct counted_error {
+  explicit counted_error(int &live) : live(&live) { ++live; }
+  counted_error(const counted_error &other) : live(other.live) { ++*live; }
+  ~counted_error() { --*live; }
+  int *live;
+};
+
+static_assert(result::any_error::stored_inline_v<small_error>);
+static_assert(result::any_error::stored_inline_v<std::string>);
+static_assert(!result::any_error::stored_inline_v<large_error>);
+static_assert(sizeof(result::any_error) <= 64);
+
+static_assert(result::details::type_name<small_error>() ==
+              "any_error_test::small_error");
+static_assert(result::details::type_hash<small_error>() !=
+              result::details::type_hash<large_error>());
+static_assert(result::details::has_unique_name<small_error>());
+static_assert(result::details::has_unique_name<std::string>());
+} // namespace any_error_test
+
+namespace {
+struct internal_error {
+  int code;
+};
+static_assert(!result::details::has_unique_name<internal_error>());
+} // namespace
+
+using namespace any_error_test;
+
+TEST_CASE("any_error stores small errors inline", "[any_error]") {
+  result::any_error e = small_error{7};
+  REQUIRE(e.has_value());
+  REQUIRE(e.stored_inline());
+  REQUIRE(e.is<small_error>());
+  REQUIRE_FALSE(e.is<large_error>());
+  REQUIRE(e.get_if<small_error>()->code == 7);
+  REQUIRE(e.get_if<large_error>() == nullptr);
+  REQUIRE(e.type_name() == "any_error_test::small_error");
+  REQUIRE(e.type_id() == result::details::type_hash<small_error>());
+}
+
+TEST_CASE("any_error spills large errors to the heap", "[any_error]") {
+  large_error big;
+  big.code = 3;
+  big.text[0] = 'x';
+  result::any_error e = big;
+  REQUIRE_FALSE(e.stored_inline());
+  REQUIRE(e.get_if<large_error>()->code == 3);
+
+  const large_error *before = e.get_if<large_error>();
+  result::any_error moved = std::move(e);
+  REQUIRE_FALSE(e.has_value());
+  REQUIRE(moved.get_if<large_error>() == before);
+
+  result::any_error copy = moved;
+  REQUIRE(copy.get_if<large_error>() != before);
+  REQUIRE(copy.get_if<large_error>()->text[0] == 'x');
+}
+
+TEST_CASE("any_error copies, moves and destroys", "[any_error]") {
+  int live = 0;
+  {
+    result::any_error e(std::in_place_type<counted_error>, live);
+    REQUIRE(live == 1);
+    result::any_error copy = e;
+    REQUIRE(live == 2);
+    result::any_error moved = std::move(copy);
+    REQUIRE(live == 2);
+    moved = small_error{1};
+    REQUIRE(live == 1);
+    moved = e;
+    REQUIRE(live == 2);
+    e.reset();
+    REQUIRE(live == 1);
+    e.emplace<std::string>("text");
+    REQUIRE(*e.get_if<std::string>() == "text");
+  }
+  REQUIRE(live == 0);
+}
+
+TEST_CASE("any_error doesn't confuse types with the same name",
+          "[any_error]") {
+  result::any_error e;
+  {
+    struct error {
+      int code;
+    };
+    e = error{1};
+    REQUIRE(e.is<error>());
+  }
+  {
+    // Another local class of this function: it can print the same name
+    // and has the same size.
+    struct error {
+      int code;
+    };
+    static_assert(!result::details::has_unique_name<error>());
+    REQUIRE_FALSE(e.is<error>());
+    REQUIRE(e.get_if<error>() == nullptr);
+  }
+  REQUIRE(result::any_error(internal_error{2}).is<internal_error>());
+}
+
+TEST_CASE("result<T, any_error>", "[any_error]") {
+  auto parse = [](int v) -> result::result<int, result::any_error> {
+    if (v < 0) {
+      return result::err(result::any_error(std::string("negative")));
+    }
+    if (v == 0) {
+      return result::err(result::any_error(small_error{0}));
+    }
+    return result::ok(v);
+  };
+
+  REQUIRE(parse(1).ok_unchecked() == 1);
+  auto r = parse(-1);
+  REQUIRE(r.is_err());
+  REQUIRE(*r.err_unchecked().get_if<std::string>() == "negative");
+
+  auto r2 = parse(0).map_err([](const result::any_error &e) {
+    return e.is<small_error>() ? 1 : 2;
+  });
+  REQUIRE(r2.err_unchecked() == 1);
+}
@@ -0,0 +1,50 @@
+#include "result_test/c_functions.h"
+
+#include <stdalign.h>
+#include <stddef.h>
+
+c_layout c_int64_result_layout(void) {
+  c_layout layout = {sizeof(int64_result), alignof(int64_result),
+                     offsetof(int64_result, value)};
+  return layout;
+}
+
+c_layout c_point_result_layout(void) {
+  c_layout layout = {sizeof(point_result), alignof(point_result),
+                     offsetof(point_result, value)};
+  return layout;
+}
+
+int64_result c_divide(int64_t a, int64_t b) {
+  if (b == 0) {
+    return RESULT_C_MAKE_ERR(int64_result, RESULT_TEST_DIVIDE_BY_ZERO);
+  }
+  return RESULT_C_MAKE_OK(int64_result, a / b);
+}
+
+int64_t c_value_or(int64_result r, int64_t fallback) {
+  return RESULT_C_IS_OK(r) ? r.value.ok : fallback;
+}
+
+point_result c_make_point(int32_t x, int32_t y) {
+  if (x < 0 || y < 0) {
+    return RESULT_C_MAKE_ERR(point_result, x < 0 ? x : y);
+  }
+  point p = {x, y, 0.5};
+  return RESULT_C_MAKE_OK(point_result, p);
+}
+
+/* The sum of the parsed texts, or the error of the first one that isn't a
+ * number. */
+int64_result c_sum_parsed(const char *const *texts, size_t n) {
+  int64_t sum = 0;
+  size_t i;
+  for (i = 0; i < n; ++i) {
+    const int64_result r = cpp_parse(texts[i]);
+    if (RESULT_C_IS_ERR(r)) {
+      return r;
+    }
+    sum += r.value.ok;
+  }
+  return RESULT_C_MAKE_OK(int64_result, sum);
+}
@@ -0,0 +1,81 @@
+#include "result/c_result.hpp"
+#include "result_test/c_functions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace c_result_test {
+using int_result = result::result<std::int64_t, std::int32_t>;
+
+static_assert(std::is_same_v<::int64_result,
+                             result::c_result<std::int64_t, std::int32_t>>);
+static_assert(std::is_trivial_v<::int64_result>);
+static_assert(std::is_standard_layout_v<::point_result>);
+static_assert(sizeof(::int64_result) == 16);
+
+constexpr auto round_trip(const int_result &r) {
+  return result::from_c_result(result::to_c_result(r));
+}
+
+static_assert(round_trip(int_result(result::ok_tag, -5)) ==
+              int_result(result::ok_tag, -5));
+static_assert(round_trip(int_result(result::err_tag, 3)) ==
+              int_result(result::err_tag, 3));
+} // namespace c_result_test
+
+// Called from C by c_sum_parsed.
+extern "C" int64_result cpp_parse(const char *text) {
+  std::int64_t value = 0;
+  const char *last = text + std::strlen(text);
+  const auto [end, ec] = std::from_chars(text, last, value);
+  if (ec != std::errc() || end != last) {
+    return result::to_c_result(c_result_test::int_result(
+        result::err_tag, static_cast<std::int32_t>(end - text)));
+  }
+  return result::to_c_result(
+      c_result_test::int_result(result::ok_tag, value));
+}
+
+using namespace c_result_test;
+
+TEST_CASE("c_result has the layout of the C struct", "[c_result]") {
+  const c_layout c_int64 = c_int64_result_layout();
+  REQUIRE(c_int64.size == sizeof(::int64_result));
+  REQUIRE(c_int64.alignment == alignof(::int64_result));
+  REQUIRE(c_int64.value_offset == offsetof(::int64_result, value));
+
+  const c_layout c_point = c_point_result_layout();
+  REQUIRE(c_point.size == sizeof(::point_result));
+  REQUIRE(c_point.alignment == alignof(::point_result));
+  REQUIRE(c_point.value_offset == offsetof(::point_result, value));
+}
+
+TEST_CASE("c_result returned by C functions", "[c_result]") {
+  REQUIRE(c_divide(7, 2) == int_result(result::ok_tag, 3));
+  REQUIRE(result::from_c_result(c_divide(7, 0)) ==
+          int_result(result::err_tag, RESULT_TEST_DIVIDE_BY_ZERO));
+
+  const auto p = c_make_point(1, 2);
+  REQUIRE(p.is_ok());
+  REQUIRE(p.value.ok.y == 2);
+  REQUIRE(p.value.ok.weight == 0.5);
+  REQUIRE(c_make_point(1, -4).value.err == -4);
+}
+
+TEST_CASE("c_result passed to C functions", "[c_result]") {
+  REQUIRE(c_value_or(result::to_c_result(int_result(result::ok_tag, 9)),
+                     0) == 9);
+  REQUIRE(c_value_or(result::to_c_result(int_result(result::err_tag, 1)),
+                     -1) == -1);
+}
+
+TEST_CASE("C calls back into C++", "[c_result]") {
+  const char *numbers[] = {"1", "20", "300"};
+  REQUIRE(c_sum_parsed(numbers, 3) == int_result(result::ok_tag, 321));
+
+  const char *with_error[] = {"1", "2x", "y"};
+  REQUIRE(c_sum_parsed(with_error, 3) == int_result(result::err_tag, 1));
+}
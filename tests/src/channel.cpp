@@ -0,0 +1,204 @@
+#include "result/channel.hpp"
+#include "result_test/tracked.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace channel_test {
+using int_result = result::result<int, std::string>;
+
+template <result::channel_mode Mode,
+          result::error_lane Lane = result::error_lane::shared>
+using int_channel = result::channel<int, std::string, Mode, Lane>;
+
+using element = result_test::tracked<std::string, struct element_tag>;
+
+int_result ok(int i) { return int_result(result::ok_tag, i); }
+int_result err(const char *e) { return int_result(result::err_tag, e); }
+
+template <typename Channel> std::vector<int_result> drain(Channel &ch) {
+  std::vector<int_result> out;
+  while (ch.try_pop_n(std::back_inserter(out), 3) != 0) {
+  }
+  return out;
+}
+
+// Push count oks numbered from first, in batches of batch.
+template <typename Channel>
+void produce(Channel &ch, int first, int count, std::size_t batch) {
+  std::vector<int_result> rs;
+  const int last = first + count;
+  for (int i = first; i < last;) {
+    rs.clear();
+    for (; i < last && rs.size() < batch; ++i) {
+      rs.push_back(ok(i));
+    }
+    std::span<int_result> pending(rs);
+    while (!pending.empty()) {
+      pending = pending.subspan(ch.try_push_n(pending));
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <result::channel_mode Mode> void one_thread() {
+  int_channel<Mode> ch(5);
+  REQUIRE(ch.capacity() == 8);
+  REQUIRE_FALSE(ch.try_pop());
+
+  SECTION("first in, first out") {
+    auto e = err("e");
+    REQUIRE(ch.try_push(ok(1)));
+    REQUIRE(ch.try_push(std::move(e)));
+    REQUIRE(ch.try_push(ok(2)));
+    REQUIRE(*ch.try_pop() == ok(1));
+    REQUIRE(drain(ch) == std::vector{err("e"), ok(2)});
+  }
+  SECTION("a full channel leaves the result as is") {
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(ch.try_push(ok(i)));
+    }
+    auto e = err("full");
+    REQUIRE_FALSE(ch.try_push(std::move(e)));
+    REQUIRE(e.err_unchecked() == "full");
+    REQUIRE(ch.try_pop()->ok_unchecked() == 0);
+    REQUIRE(ch.try_push(std::move(e)));
+    REQUIRE(drain(ch).back() == err("full"));
+  }
+  SECTION("batches wrap around the ring") {
+    std::vector<int_result> rs;
+    for (int i = 0; i < 6; ++i) {
+      rs.push_back(ok(i));
+    }
+    REQUIRE(ch.try_push_n(rs) == 6);
+    REQUIRE(ch.try_pop_n(std::back_inserter(rs), 4) == 4);
+    REQUIRE(ch.try_push_n(std::span(rs).subspan(6)) == 4);
+    REQUIRE(ch.try_push_n(rs) == 2);
+    const auto out = drain(ch);
+    REQUIRE(out.size() == 8);
+    REQUIRE(out[2] == ok(0));
+    REQUIRE(out[5] == ok(3));
+    REQUIRE(out[7] == ok(1));
+  }
+}
+} // namespace channel_test
+
+using namespace channel_test;
+
+TEST_CASE("channel in one thread", "[channel]") {
+  SECTION("spsc") { one_thread<result::channel_mode::spsc>(); }
+  SECTION("mpmc") { one_thread<result::channel_mode::mpmc>(); }
+}
+
+TEST_CASE("channel with a separate error lane", "[channel]") {
+  int_channel<result::channel_mode::spsc, result::error_lane::separate> ch(4,
+                                                                          2);
+  REQUIRE(ch.error_capacity() == 2);
+  std::vector<int_result> rs{ok(1), err("a"), ok(2), err("b"), err("c"),
+                             ok(3)};
+
+  SECTION("oks are popped first") {
+    REQUIRE(ch.try_push_n(rs) == 4);
+    REQUIRE(ch.try_push_n(std::span(rs).subspan(4)) == 0);
+    REQUIRE(*ch.try_pop() == ok(1));
+    REQUIRE(drain(ch) == std::vector{ok(2), err("a"), err("b")});
+  }
+  SECTION("draining each lane") {
+    REQUIRE(ch.try_push_n(std::span(rs).first(4)) == 4);
+    std::vector<int> values;
+    std::vector<std::string> errors;
+    REQUIRE(ch.try_pop_ok_n(std::back_inserter(values), 8) == 2);
+    REQUIRE(ch.try_pop_err_n(std::back_inserter(errors), 1) == 1);
+    REQUIRE(values == std::vector{1, 2});
+    REQUIRE(errors == std::vector<std::string>{"a"});
+    REQUIRE(*ch.try_pop() == err("b"));
+  }
+}
+
+TEST_CASE("channel destroys the results it holds", "[channel]") {
+  element::reset();
+  {
+    result::channel<element, int> ch(4);
+    std::vector<result::result<element, int>> rs;
+    rs.emplace_back(result::ok_tag, "a");
+    rs.emplace_back(result::ok_tag, "b");
+    rs.emplace_back(result::err_tag, 1);
+    REQUIRE(ch.try_push_n(rs) == 3);
+    REQUIRE(ch.try_pop()->ok_unchecked().value() == "a");
+    rs.clear();
+    REQUIRE(element::counts().alive() == 1);
+  }
+  REQUIRE(element::counts().alive() == 0);
+  REQUIRE(element::counts().copies() == 0);
+}
+
+TEST_CASE("spsc channel between two threads", "[channel]") {
+  constexpr int count = 100'000;
+  int_channel<result::channel_mode::spsc> ch(64);
+  std::jthread producer([&ch] { produce(ch, 0, count, 7); });
+
+  std::vector<int_result> received;
+  while (received.size() < count) {
+    if (ch.try_pop_n(std::back_inserter(received), 16) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  REQUIRE_FALSE(ch.try_pop());
+  std::size_t in_order = 0;
+  while (in_order < count &&
+         received[in_order] == ok(static_cast<int>(in_order))) {
+    ++in_order;
+  }
+  REQUIRE(in_order == count);
+}
+
+TEST_CASE("mpmc channel between many threads", "[channel]") {
+  constexpr int producers = 3;
+  constexpr int consumers = 3;
+  constexpr int count = 30'000;
+  int_channel<result::channel_mode::mpmc> ch(32);
+
+  std::vector<std::vector<int>> received(consumers);
+  std::atomic<int> popped = 0;
+  {
+    std::vector<std::jthread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back(
+          [&ch, p] { produce(ch, p * count, count, 1 + p * 5); });
+    }
+    for (int c = 0; c < consumers; ++c) {
+      threads.emplace_back([&ch, &popped, &out = received[c]] {
+        std::vector<int_result> batch;
+        while (popped.load() < producers * count) {
+          batch.clear();
+          popped += static_cast<int>(
+              ch.try_pop_n(std::back_inserter(batch), 8));
+          for (const auto &r : batch) {
+            out.push_back(r.ok_unchecked());
+          }
+          std::this_thread::yield();
+        }
+      });
+    }
+  }
+
+  // Every value exactly once, and in push order for each producer.
+  std::vector<int> seen(producers * count);
+  bool in_order = true;
+  for (const auto &out : received) {
+    std::vector<int> last(producers, -1);
+    for (int v : out) {
+      ++seen[static_cast<std::size_t>(v)];
+      in_order = in_order && v > last[static_cast<std::size_t>(v / count)];
+      last[static_cast<std::size_t>(v / count)] = v;
+    }
+  }
+  REQUIRE(in_order);
+  REQUIRE(std::count(seen.begin(), seen.end(), 1) == producers * count);
+}
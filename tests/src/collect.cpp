@@ -0,0 +1,154 @@
+#include "result/collect.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <ranges>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace collect_test {
+using int_result = result::result<int, std::string>;
+
+int_result parse(int i) {
+  if (i % 5 == 4) {
+    return int_result(result::err_tag, "bad " + std::to_string(i));
+  }
+  return int_result(result::ok_tag, i);
+}
+
+std::vector<int_result> make_results(std::size_t n, bool with_errors) {
+  std::vector<int_result> v;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(with_errors ? parse(static_cast<int>(i))
+                            : int_result(result::ok_tag, static_cast<int>(i)));
+  }
+  return v;
+}
+} // namespace collect_test
+
+using namespace collect_test;
+
+TEST_CASE("collect_all of ok results", "[collect]") {
+  const auto input = make_results(10, false);
+  auto r = result::collect_all(input);
+  static_assert(std::is_same_v<decltype(r),
+                               result::result<std::vector<int>,
+                                              result::error_list<std::string>>>);
+  REQUIRE(r.is_ok());
+  REQUIRE(r.ok_unchecked() == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  REQUIRE(input[9].ok_unchecked() == 9);
+}
+
+TEST_CASE("collect_all reports every error", "[collect]") {
+  SECTION("errors in index order") {
+    auto r = result::collect_all(make_results(15, true));
+    REQUIRE(r.is_err());
+    const auto &errors = r.err_unchecked();
+    REQUIRE(errors.size() == 3);
+    REQUIRE(errors.stored_inline());
+    REQUIRE(errors[0] == result::indexed_error<std::string>(4, "bad 4"));
+    REQUIRE(errors[1].index == 9);
+    REQUIRE(errors[2].error == "bad 14");
+  }
+  SECTION("more errors than the inline capacity") {
+    auto r = result::collect_all(make_results(100, true));
+    const auto &errors = r.err_unchecked();
+    REQUIRE(errors.size() == 20);
+    REQUIRE_FALSE(errors.stored_inline());
+    REQUIRE(errors.back().index == 99);
+  }
+  SECTION("input ranges and views") {
+    std::list<int_result> l;
+    l.push_back(parse(3));
+    l.push_back(parse(4));
+    auto r = result::collect_all(l);
+    REQUIRE(r.err_unchecked().front().index == 1);
+
+    auto v = result::collect_all(std::views::iota(0, 8) |
+                                 std::views::transform(parse));
+    REQUIRE(v.err_unchecked().size() == 1);
+  }
+  SECTION("empty range") {
+    auto r = result::collect_all(std::vector<int_result>());
+    REQUIRE(r.is_ok());
+    REQUIRE(r.ok_unchecked().empty());
+  }
+}
+
+TEST_CASE("collect_all moves from rvalue ranges", "[collect]") {
+  using string_result = result::result<std::string, int>;
+  const std::string text(100, 'x');
+  std::vector<string_result> input(3, string_result(result::ok_tag, text));
+
+  auto copied = result::collect_all(input);
+  REQUIRE(input[0].ok_unchecked() == text);
+
+  auto moved = result::collect_all(std::move(input));
+  REQUIRE(moved.ok_unchecked()[2] == text);
+  REQUIRE(input[0].ok_unchecked().empty());
+}
+
+TEST_CASE("collect_all copies through views of lvalues", "[collect]") {
+  using string_result = result::result<std::string, int>;
+  const std::string text(100, 'x');
+  std::vector<string_result> input(3, string_result(result::ok_tag, text));
+
+  auto r = result::collect_all(input | std::views::take(2));
+  REQUIRE(r.ok_unchecked() == std::vector<std::string>{text, text});
+  REQUIRE(input[0].ok_unchecked() == text);
+  REQUIRE(input[1].ok_unchecked() == text);
+
+  auto all = result::collect_all(std::views::all(input));
+  REQUIRE(all.ok_unchecked().size() == 3);
+  REQUIRE(input[2].ok_unchecked() == text);
+}
+
+TEST_CASE("collect_all_parallel", "[collect]") {
+  constexpr std::size_t n = 100'000;
+
+  SECTION("ok values keep their order") {
+    const auto input = make_results(n, false);
+    auto r = result::collect_all_parallel(input, 4);
+    REQUIRE(r.is_ok());
+    REQUIRE(r.ok_unchecked() == result::collect_all(input).ok_unchecked());
+    REQUIRE(r.ok_unchecked().size() == n);
+  }
+  SECTION("errors of all chunks are merged in index order") {
+    const auto input = make_results(n, true);
+    auto r = result::collect_all_parallel(input, 4);
+    REQUIRE(r.err_unchecked() == result::collect_all(input).err_unchecked());
+    REQUIRE(r.err_unchecked().size() == n / 5);
+  }
+  SECTION("small inputs use the calling thread") {
+    auto r = result::collect_all_parallel(make_results(10, true), 4);
+    REQUIRE(r.err_unchecked().size() == 2);
+  }
+}
+
+TEST_CASE("validate", "[collect]") {
+  using string_result = result::result<std::string, std::string>;
+
+  SECTION("all ok") {
+    auto r = result::validate(parse(1), string_result(result::ok_tag, "a"),
+                              parse(2));
+    static_assert(std::is_same_v<decltype(r)::value_type,
+                                 std::tuple<int, std::string, int>>);
+    REQUIRE(r.ok_unchecked() == std::tuple(1, std::string("a"), 2));
+  }
+  SECTION("every error with its argument position") {
+    auto r = result::validate(parse(4), string_result(result::ok_tag, "a"),
+                              parse(9));
+    const auto &errors = r.err_unchecked();
+    REQUIRE(errors.size() == 2);
+    REQUIRE(errors[0].index == 0);
+    REQUIRE(errors[1] == result::indexed_error<std::string>(2, "bad 9"));
+  }
+  SECTION("lvalues are copied") {
+    const auto a = parse(1);
+    auto b = parse(4);
+    auto r = result::validate(a, b);
+    REQUIRE(r.err_unchecked().front().error == "bad 4");
+    REQUIRE(b.err_unchecked() == "bad 4");
+  }
+}
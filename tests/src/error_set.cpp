@@ -0,0 +1,235 @@
+#include "result/error_set.hpp"
+#include "result/result.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace error_set_test {
+struct parse_error {
+  int line;
+  bool operator==(const parse_error &) const = default;
+};
+
+struct io_error {
+  std::string path;
+  bool operator==(const io_error &) const = default;
+};
+
+struct auth_error {
+  bool operator==(const auth_error &) const = default;
+};
+
+using parse_io = result::error_set<parse_error, io_error>;
+using all_errors = result::error_set<parse_error, io_error, auth_error>;
+
+static_assert(std::is_same_v<result::error_union_t<parse_error, parse_error>,
+                             parse_error>);
+static_assert(
+    std::is_same_v<result::error_union_t<parse_error, io_error>, parse_io>);
+static_assert(std::is_same_v<result::error_union_t<parse_io, parse_error>,
+                             parse_io>);
+static_assert(std::is_same_v<result::error_union_t<io_error, parse_io>,
+                             result::error_set<io_error, parse_error>>);
+static_assert(std::is_same_v<
+              result::error_union_t<parse_io,
+                                    result::error_set<auth_error, io_error>>,
+              all_errors>);
+
+static_assert(std::is_convertible_v<parse_error, parse_io>);
+static_assert(std::is_convertible_v<parse_io, all_errors>);
+static_assert(!std::is_convertible_v<all_errors, parse_io>);
+static_assert(!std::is_convertible_v<auth_error, parse_io>);
+
+// One discriminant byte next to the largest error type.
+static_assert(sizeof(result::error_set<std::uint8_t, std::int8_t>) == 2);
+static_assert(sizeof(result::error_set<std::int32_t, parse_error>) == 8);
+
+result::result<int, parse_error> parse(const std::string &s) {
+  if (s.empty()) {
+    return result::err(parse_error{1});
+  }
+  return result::ok(static_cast<int>(s.size()));
+}
+
+result::result<std::string, io_error> load(int n) {
+  if (n > 3) {
+    return result::err(io_error{"/tmp/" + std::to_string(n)});
+  }
+  return result::ok(std::string(static_cast<std::size_t>(n), 'x'));
+}
+
+result::result<std::string, parse_io> check(std::string s) {
+  if (s == "xx") {
+    return result::err(parse_io(parse_error{2}));
+  }
+  return result::ok(std::move(s));
+}
+
+result::result<bool, auth_error> authorize(const std::string &s) {
+  if (s.size() == 1) {
+    return result::err(auth_error{});
+  }
+  return result::ok(true);
+}
+// Copies and moves throw once fail is set.
+struct fragile_error {
+  explicit fragile_error(int v) : value(v) {}
+  fragile_error(const fragile_error &other) : value(other.value) {
+    if (fail) {
+      throw std::runtime_error("copy");
+    }
+  }
+  fragile_error(fragile_error &&other) : value(other.value) {
+    if (fail) {
+      throw std::runtime_error("move");
+    }
+  }
+  fragile_error &operator=(const fragile_error &) = default;
+  bool operator==(const fragile_error &) const = default;
+  static inline bool fail = false;
+  int value;
+};
+
+// A nothrow move, but a throwing copy.
+struct copy_fails_error {
+  copy_fails_error() = default;
+  copy_fails_error(const copy_fails_error &) {
+    throw std::runtime_error("copy");
+  }
+  copy_fails_error(copy_fails_error &&) noexcept = default;
+  copy_fails_error &operator=(const copy_fails_error &) = default;
+};
+} // namespace error_set_test
+
+using namespace error_set_test;
+
+TEST_CASE("error_set holds one of its error types", "[error_set]") {
+  parse_io e = parse_error{3};
+  REQUIRE(e.index() == 0);
+  REQUIRE(e.holds<parse_error>());
+  REQUIRE_FALSE(e.holds<io_error>());
+  REQUIRE(e.get<parse_error>().line == 3);
+  REQUIRE(e.get<0>().line == 3);
+  REQUIRE(e.get_if<io_error>() == nullptr);
+  REQUIRE(e == parse_error{3});
+
+  e = parse_io(io_error{"a"});
+  REQUIRE(e.holds<io_error>());
+  REQUIRE(e.get_if<io_error>()->path == "a");
+
+  parse_io copy = e;
+  REQUIRE(copy == e);
+  parse_io moved = std::move(copy);
+  REQUIRE(moved == io_error{"a"});
+
+  e = parse_io(std::in_place_type<io_error>, "b");
+  REQUIRE(e.get<io_error>().path == "b");
+  REQUIRE_FALSE(e == moved);
+}
+
+TEST_CASE("error_set keeps its error when an assignment throws",
+          "[error_set]") {
+  SECTION("throwing copy and move") {
+    using set = result::error_set<io_error, fragile_error>;
+    set e = io_error{"kept"};
+    const set other = fragile_error(1);
+    fragile_error::fail = true;
+    REQUIRE_THROWS_AS(e = other, std::runtime_error);
+    fragile_error::fail = false;
+    REQUIRE(e == io_error{"kept"});
+
+    e = other;
+    REQUIRE(e == fragile_error(1));
+  }
+  SECTION("throwing copy, nothrow move") {
+    using set = result::error_set<io_error, copy_fails_error>;
+    set e = io_error{"kept"};
+    const set other(std::in_place_type<copy_fails_error>);
+    REQUIRE_THROWS_AS(e = other, std::runtime_error);
+    REQUIRE(e == io_error{"kept"});
+  }
+}
+
+TEST_CASE("error_set widens from a subset", "[error_set]") {
+  parse_io narrow = io_error{"x"};
+  all_errors wide = narrow;
+  REQUIRE(wide.holds<io_error>());
+  REQUIRE(wide.get<io_error>().path == "x");
+
+  all_errors moved = std::move(narrow);
+  REQUIRE(moved == io_error{"x"});
+}
+
+TEST_CASE("error_set visit", "[error_set]") {
+  struct name {
+    std::string operator()(const parse_error &) const { return "parse"; }
+    std::string operator()(const io_error &e) const { return "io " + e.path; }
+    std::string operator()(const auth_error &) const { return "auth"; }
+  };
+
+  all_errors e = auth_error{};
+  REQUIRE(e.visit(name{}) == "auth");
+  e = all_errors(io_error{"p"});
+  REQUIRE(result::visit(name{}, e) == "io p");
+  REQUIRE(std::move(e).visit([](auto &&v) {
+    return std::is_rvalue_reference_v<decltype(v)>;
+  }));
+}
+
+TEST_CASE("error_set with more than 8 types", "[error_set]") {
+  using many = result::error_set<char, signed char, unsigned char, short,
+                                 unsigned short, int, unsigned, long,
+                                 unsigned long, long long, float, double>;
+  many e = 2.5;
+  REQUIRE(e.index() == 11);
+  REQUIRE(e.visit([](auto v) { return static_cast<double>(v); }) == 2.5);
+  e = many(7u);
+  REQUIRE(e.index() == 6);
+  REQUIRE(e.visit([](auto v) { return static_cast<double>(v); }) == 7.0);
+}
+
+TEST_CASE("and_then widens error types", "[error_set]") {
+  auto run = [](const std::string &s) {
+    return parse(s).and_then(load).and_then(check).and_then(authorize);
+  };
+  static_assert(std::is_same_v<decltype(run("")),
+                               result::result<bool, all_errors>>);
+
+  auto r = run("abc");
+  REQUIRE(r.is_ok());
+  REQUIRE(r.ok_unchecked());
+
+  r = run("");
+  REQUIRE(r.is_err());
+  REQUIRE(r.err_unchecked() == parse_error{1});
+
+  r = run("abcd");
+  REQUIRE(r.err_unchecked() == io_error{"/tmp/4"});
+
+  r = run("ab");
+  REQUIRE(r.err_unchecked() == parse_error{2});
+
+  r = run("x");
+  REQUIRE(r.err_unchecked() == auth_error{});
+}
+
+TEST_CASE("and_then keeps the error type when it matches", "[error_set]") {
+  result::result<int, parse_error> r = result::ok(1);
+  auto r2 = r.and_then([](int v) -> result::result<long, parse_error> {
+    return result::ok(static_cast<long>(v) + 1);
+  });
+  static_assert(std::is_same_v<decltype(r2), result::result<long, parse_error>>);
+  REQUIRE(r2.ok_unchecked() == 2);
+}
+
+TEST_CASE("hash error_set", "[error_set]") {
+  using set = result::error_set<int, long>;
+  std::hash<result::result<int, set>> hash;
+  const result::result<int, set> a(result::err_tag, set(1));
+  const result::result<int, set> b(result::err_tag, set(1L));
+  const result::result<int, set> c(result::err_tag, set(1));
+  REQUIRE(hash(a) == hash(c));
+  REQUIRE(hash(a) != hash(b));
+}
@@ -0,0 +1,171 @@
+#include "result/exception.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace exception_test {
+// Exception type of a third-party library.
+class parse_exception : public std::runtime_error {
+public:
+  explicit parse_exception(int line)
+      : std::runtime_error("parse error"), m_line(line) {}
+  int line() const noexcept { return m_line; }
+
+private:
+  int m_line;
+};
+
+struct parse_error {
+  int line;
+  bool operator==(const parse_error &) const = default;
+};
+
+int parse(int v) {
+  if (v < 0) {
+    throw parse_exception(-v);
+  }
+  if (v == 0) {
+    throw std::out_of_range("zero");
+  }
+  if (v == 1) {
+    throw std::logic_error("one");
+  }
+  return v * 2;
+}
+} // namespace exception_test
+
+template <> struct result::exception_traits<exception_test::parse_error> {
+  using exception_type = exception_test::parse_exception;
+
+  static exception_test::parse_error
+  convert(exception_test::parse_exception &e) noexcept {
+    return {e.line()};
+  }
+
+  [[noreturn]] static void raise(const exception_test::parse_error &e) {
+    throw exception_test::parse_exception(e.line);
+  }
+};
+
+namespace exception_test {
+// Exception type of a library whose errors can't always be converted.
+struct lib_error {
+  int code;
+};
+
+struct unconvertible_error {
+  int code;
+};
+} // namespace exception_test
+
+template <>
+struct result::exception_traits<exception_test::unconvertible_error> {
+  using exception_type = exception_test::lib_error;
+
+  static exception_test::unconvertible_error
+  convert(exception_test::lib_error &) {
+    throw std::runtime_error("conversion");
+  }
+};
+
+using namespace exception_test;
+
+TEST_CASE("catch_as a single exception type", "[exception]") {
+  auto r = result::catch_as<std::out_of_range>(parse, 4);
+  static_assert(
+      std::is_same_v<decltype(r), result::result<int, std::out_of_range>>);
+  REQUIRE(r.ok_unchecked() == 8);
+
+  r = result::catch_as<std::out_of_range>(parse, 0);
+  REQUIRE(r.is_err());
+  REQUIRE(std::string(r.err_unchecked().what()) == "zero");
+
+  REQUIRE_THROWS_AS(result::catch_as<std::out_of_range>(parse, 1),
+                    std::logic_error);
+}
+
+TEST_CASE("catch_as several exception types", "[exception]") {
+  using errors = result::error_set<parse_error, std::out_of_range>;
+  auto run = [](int v) {
+    return result::catch_as<parse_error, std::out_of_range>(parse, v);
+  };
+  static_assert(std::is_same_v<decltype(run(0)), result::result<int, errors>>);
+
+  REQUIRE(run(3).ok_unchecked() == 6);
+  REQUIRE(run(-5).err_unchecked() == parse_error{5});
+  REQUIRE(run(0).err_unchecked().holds<std::out_of_range>());
+}
+
+TEST_CASE("catch_as handlers are tried in order", "[exception]") {
+  // parse_exception derives from std::runtime_error.
+  auto r = result::catch_as<parse_error, std::runtime_error>(parse, -2);
+  REQUIRE(r.err_unchecked().holds<parse_error>());
+
+  auto r2 = result::catch_as<std::runtime_error, parse_error>(parse, -2);
+  REQUIRE(r2.err_unchecked().holds<std::runtime_error>());
+}
+
+TEST_CASE("catch_as propagates exceptions thrown by convert",
+          "[exception]") {
+  auto fail = [] {
+    throw lib_error{3};
+    return 0;
+  };
+  try {
+    auto r = result::catch_as<unconvertible_error, std::runtime_error>(fail);
+    FAIL("catch_as returned a " << (r.is_ok() ? "ok" : "err") << " result");
+  } catch (const std::runtime_error &e) {
+    REQUIRE(std::string(e.what()) == "conversion");
+  }
+  REQUIRE_THROWS_AS(result::catch_as<unconvertible_error>(fail),
+                    std::runtime_error);
+}
+
+TEST_CASE("catch_as void functions and error codes", "[exception]") {
+  auto fail = [] {
+    throw std::system_error(std::make_error_code(std::errc::timed_out));
+  };
+  auto r = result::catch_as<std::error_code>(fail);
+  static_assert(std::is_same_v<decltype(r),
+                               result::result<result::empty_tag_t,
+                                              std::error_code>>);
+  REQUIRE(r.err_unchecked() == std::errc::timed_out);
+
+  auto s = result::catch_as<result::status>([] {});
+  REQUIRE(s.is_ok());
+  s = result::catch_as<result::status>(fail);
+  REQUIRE(s.err_unchecked() == std::errc::timed_out);
+}
+
+TEST_CASE("throw_if_err", "[exception]") {
+  result::result<std::string, parse_error> r = result::ok(std::string("ok"));
+  REQUIRE(result::throw_if_err(r) == "ok");
+  std::string moved = result::throw_if_err(std::move(r));
+  REQUIRE(moved == "ok");
+
+  const result::result<int, parse_error> e = result::err(parse_error{7});
+  try {
+    result::throw_if_err(e);
+    FAIL("throw_if_err returned");
+  } catch (const parse_exception &ex) {
+    REQUIRE(ex.line() == 7);
+  }
+
+  result::result<int, result::status> s =
+      result::err(result::status(std::errc::io_error));
+  REQUIRE_THROWS_AS(result::throw_if_err(s), std::system_error);
+
+  result::result<int, result::error_set<parse_error, std::out_of_range>> set =
+      result::err(result::error_set<parse_error, std::out_of_range>(
+          std::out_of_range("range")));
+  REQUIRE_THROWS_AS(result::throw_if_err(set), std::out_of_range);
+}
+
+TEST_CASE("catch_as and throw_if_err round trip", "[exception]") {
+  auto r = result::catch_as<parse_error>(parse, -9);
+  auto again = result::catch_as<parse_error>(
+      [&r] { return result::throw_if_err(std::move(r)); });
+  REQUIRE(again.err_unchecked() == parse_error{9});
+}
@@ -0,0 +1,267 @@
+#include "result/fallible.hpp"
+#include "result_test/allocation.hpp"
+#include "result_test/failing_allocator.hpp"
+#include "result_test/tracked.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+
+namespace fallible_test {
+using element = result_test::tracked<std::string, struct element_tag>;
+
+template <typename T>
+using failing_vector = result::try_vector<T, result_test::failing_allocator<T>>;
+
+using failing_string =
+    result::basic_try_string<result_test::failing_allocator<char>>;
+
+// Throws from its constructor when built from a negative number.
+struct picky {
+  explicit picky(int v) : value(v) {
+    if (v < 0) {
+      throw std::invalid_argument("negative");
+    }
+  }
+
+  int value;
+};
+
+// Not the pointer niche, see alloc_error.
+static_assert(sizeof(result::result<int &, result::alloc_error>) ==
+              2 * sizeof(int *));
+static_assert(std::is_nothrow_move_constructible_v<result::try_vector<int>>);
+static_assert(!std::is_copy_constructible_v<result::try_vector<int>>);
+} // namespace fallible_test
+
+using namespace fallible_test;
+
+TEST_CASE("try_vector grows like a vector", "[fallible]") {
+  result::try_vector<int> v;
+  for (int i = 0; i < 5; ++i) {
+    const auto r = v.try_push_back(i);
+    REQUIRE(r.is_ok());
+    REQUIRE(&r.ok_unchecked() == &v.back());
+  }
+  REQUIRE(v.size() == 5);
+  REQUIRE(v.capacity() == 8);
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(v[i] == i);
+  }
+
+  SECTION("try_reserve allocates exactly") {
+    REQUIRE(v.try_reserve(20).is_ok());
+    REQUIRE(v.capacity() == 20);
+    REQUIRE(v.try_reserve(10).is_ok());
+    REQUIRE(v.capacity() == 20);
+  }
+  SECTION("try_resize") {
+    REQUIRE(&v.try_resize(7).ok_unchecked() == &v);
+    REQUIRE(v.size() == 7);
+    REQUIRE(v[6] == 0);
+    REQUIRE(v.try_resize(10, 9).is_ok());
+    REQUIRE(v[9] == 9);
+    REQUIRE(v.try_resize(2).is_ok());
+    REQUIRE(v.size() == 2);
+    REQUIRE(v.back() == 1);
+  }
+  SECTION("try_append") {
+    const int more[] = {5, 6, 7, 8};
+    REQUIRE(v.try_append(more).is_ok());
+    REQUIRE(v.size() == 9);
+    REQUIRE(v.back() == 8);
+  }
+  SECTION("unchecked appends within the capacity") {
+    REQUIRE(v.try_reserve(8).is_ok());
+    const int &added = v.emplace_back_unchecked(5);
+    REQUIRE(&added == &v.back());
+    const int more[] = {6, 7};
+    v.append_unchecked(more);
+    REQUIRE(v.size() == 8);
+    REQUIRE(v.capacity() == 8);
+    REQUIRE(v.back() == 7);
+  }
+  SECTION("try_clone") {
+    const auto copy = v.try_clone();
+    REQUIRE(copy.is_ok());
+    REQUIRE(copy.ok_unchecked() == v);
+    REQUIRE(copy.ok_unchecked().capacity() == 5);
+  }
+  SECTION("sizes above max_size()") {
+    REQUIRE(v.try_reserve(v.max_size() + 1).err_unchecked() ==
+            result::alloc_error::capacity_overflow);
+    REQUIRE(v.try_resize(v.max_size() + 1).err_unchecked() ==
+            result::alloc_error::capacity_overflow);
+    REQUIRE(v.size() == 5);
+  }
+}
+
+TEST_CASE("try_vector reports allocation failures", "[fallible]") {
+  result_test::allocation_budget budget;
+  failing_vector<element> v{result_test::failing_allocator<element>(budget)};
+  v.try_emplace_back("a");
+  v.try_emplace_back("b");
+  REQUIRE(v.capacity() == 2);
+  budget.fail_after(0);
+  element::reset();
+
+  SECTION("the vector is left unchanged") {
+    const auto r = v.try_emplace_back("c");
+    REQUIRE(r.err_unchecked() == result::alloc_error::out_of_memory);
+    REQUIRE(v.size() == 2);
+    REQUIRE(v.capacity() == 2);
+    REQUIRE(v.back().value() == "b");
+    REQUIRE(element::counts().alive() == 0);
+    REQUIRE(element::counts().moves() == 0);
+    REQUIRE(budget.failures == 2);
+  }
+  SECTION("try_reserve, try_resize and try_append") {
+    REQUIRE(v.try_reserve(3).err_unchecked() ==
+            result::alloc_error::out_of_memory);
+    REQUIRE(v.try_resize(3).err_unchecked() ==
+            result::alloc_error::out_of_memory);
+    REQUIRE(v.try_append(std::span<const element>(v.data(), 2))
+                .err_unchecked() == result::alloc_error::out_of_memory);
+    REQUIRE(v.try_clone().err_unchecked() ==
+            result::alloc_error::out_of_memory);
+    REQUIRE(v.size() == 2);
+    REQUIRE(element::counts().alive() == 0);
+  }
+  SECTION("elements that fit need no allocation") {
+    REQUIRE(v.try_resize(1).is_ok());
+    REQUIRE(v.try_emplace_back("c").is_ok());
+    REQUIRE(v.back().value() == "c");
+  }
+  SECTION("the vector works again once memory is available") {
+    REQUIRE(v.try_emplace_back("c").is_err());
+    budget.fail_after(1);
+    REQUIRE(v.try_emplace_back("c").is_ok());
+    REQUIRE(v.size() == 3);
+  }
+}
+
+TEST_CASE("try_vector falls back to the size needed", "[fallible]") {
+  result_test::allocation_budget budget;
+  failing_vector<int> v{result_test::failing_allocator<int>(budget)};
+  REQUIRE(v.try_resize(4).is_ok());
+  budget.max_bytes = 5 * sizeof(int);
+
+  REQUIRE(v.try_push_back(4).is_ok());
+  REQUIRE(v.capacity() == 5);
+  REQUIRE(budget.failures == 1);
+  REQUIRE(v.try_push_back(5).is_err());
+  REQUIRE(v.size() == 5);
+}
+
+TEST_CASE("try_vector appends its own elements", "[fallible]") {
+  result::try_vector<element> v;
+  v.try_emplace_back("a");
+  REQUIRE(v.capacity() == 1);
+
+  SECTION("try_push_back") {
+    REQUIRE(v.try_push_back(v.front()).is_ok());
+    REQUIRE(v[1].value() == "a");
+  }
+  SECTION("try_append") {
+    v.try_emplace_back("b");
+    REQUIRE(v.try_append(std::span<const element>(v.data(), 2)).is_ok());
+    REQUIRE(v.size() == 4);
+    REQUIRE(v[2].value() == "a");
+    REQUIRE(v[3].value() == "b");
+  }
+}
+
+TEST_CASE("try_vector with an allocator throwing std::bad_alloc",
+          "[fallible]") {
+  {
+    result::try_vector<int, std::pmr::polymorphic_allocator<int>> v(
+        std::pmr::null_memory_resource());
+    REQUIRE(v.try_push_back(1).err_unchecked() ==
+            result::alloc_error::out_of_memory);
+    REQUIRE(v.empty());
+  }
+
+  std::pmr::monotonic_buffer_resource arena;
+  result::try_vector<int, std::pmr::polymorphic_allocator<int>> v(&arena);
+  REQUIRE(v.try_push_back(1).is_ok());
+  REQUIRE(v.get_allocator().resource() == &arena);
+}
+
+TEST_CASE("try_vector propagates exceptions of the elements", "[fallible]") {
+  result_test::allocation_scope scope;
+  {
+    result::try_vector<picky> v;
+    v.try_emplace_back(1);
+    REQUIRE_THROWS_AS(v.try_emplace_back(-1), std::invalid_argument);
+    REQUIRE(v.size() == 1);
+    REQUIRE(v.capacity() == 1);
+    REQUIRE(v.try_emplace_back(2).is_ok());
+    REQUIRE(v.back().value == 2);
+  }
+  REQUIRE(scope.allocations() == scope.deallocations());
+}
+
+TEST_CASE("try_string", "[fallible]") {
+  result::try_string s;
+  REQUIRE(s.empty());
+  REQUIRE(std::string_view(s.c_str()).empty());
+
+  REQUIRE(&s.try_append("hello").ok_unchecked() == &s);
+  REQUIRE(s.try_push_back(' ').is_ok());
+  REQUIRE(s.try_append("world").is_ok());
+  REQUIRE(s == "hello world");
+  REQUIRE(std::string_view(s.c_str()) == "hello world");
+  REQUIRE(s.size() == 11);
+
+  SECTION("appending a part of itself") {
+    REQUIRE(s.try_append(s.view().substr(6)).is_ok());
+    REQUIRE(s == "hello worldworld");
+    REQUIRE(s.try_append(s).is_ok());
+    REQUIRE(s == "hello worldworldhello worldworld");
+  }
+  SECTION("try_reserve") {
+    REQUIRE(s.try_reserve(100).is_ok());
+    REQUIRE(s.capacity() == 100);
+    REQUIRE(s == "hello world");
+  }
+  SECTION("try_from") {
+    const auto copy = result::try_string::try_from(s);
+    REQUIRE(copy.ok_unchecked() == "hello world");
+  }
+  SECTION("clear") {
+    s.clear();
+    REQUIRE(s.empty());
+    REQUIRE(std::string_view(s.c_str()).empty());
+  }
+}
+
+TEST_CASE("try_string reserves only beyond its capacity", "[fallible]") {
+  result_test::allocation_budget budget;
+  failing_string s{result_test::failing_allocator<char>(budget)};
+  budget.fail_after(0);
+  REQUIRE(s.try_reserve(0).is_ok());
+  REQUIRE(s.capacity() == 0);
+
+  budget.fail_after(1);
+  REQUIRE(s.try_reserve(10).is_ok());
+  REQUIRE(s.capacity() == 10);
+  budget.fail_after(0);
+  REQUIRE(s.try_reserve(10).is_ok());
+  REQUIRE(s.try_reserve(11).err_unchecked() ==
+          result::alloc_error::out_of_memory);
+}
+
+TEST_CASE("try_string reports allocation failures", "[fallible]") {
+  result_test::allocation_budget budget;
+  failing_string s{result_test::failing_allocator<char>(budget)};
+  REQUIRE(s.try_append("abc").is_ok());
+  budget.fail_after(0);
+
+  REQUIRE(s.try_append(std::string(100, 'x')).err_unchecked() ==
+          result::alloc_error::out_of_memory);
+  REQUIRE(s == "abc");
+  REQUIRE(std::string_view(s.c_str()) == "abc");
+  REQUIRE(s.try_reserve(s.max_size() + 1).err_unchecked() ==
+          result::alloc_error::capacity_overflow);
+  REQUIRE(failing_string::try_from("abc", s.get_allocator()).is_err());
+}
@@ -0,0 +1,175 @@
+#include "result/interop.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace interop_test {
+struct move_counter {
+  static inline int copies = 0;
+  static inline int moves = 0;
+
+  static void reset() {
+    copies = 0;
+    moves = 0;
+  }
+
+  explicit move_counter(int v = 0) : value(v) {}
+  move_counter(const move_counter &other) : value(other.value) { ++copies; }
+  move_counter(move_counter &&other) noexcept : value(other.value) { ++moves; }
+  move_counter &operator=(const move_counter &) = default;
+  move_counter &operator=(move_counter &&) = default;
+
+  bool operator==(const move_counter &rhs) const {
+    return value == rhs.value;
+  }
+
+  int value;
+};
+
+constexpr int constexpr_round_trip() {
+  auto o = result::to_optional(result::from_optional(std::optional<int>(4)));
+  return *o;
+}
+
+static_assert(constexpr_round_trip() == 4);
+static_assert(noexcept(result::to_optional(
+    std::declval<result::result<int, result::empty_tag_t>>())));
+static_assert(!noexcept(result::to_optional(
+    std::declval<const result::result<std::string, result::empty_tag_t> &>())));
+} // namespace interop_test
+
+using namespace interop_test;
+using result::empty_tag_t;
+
+TEST_CASE("result to and from std::optional", "[interop]") {
+  using counted = result::result<move_counter, empty_tag_t>;
+  move_counter::reset();
+
+  SECTION("to_optional moves once") {
+    counted r(result::ok_tag, 1);
+    auto o = result::to_optional(std::move(r));
+    REQUIRE(o.has_value());
+    REQUIRE(o->value == 1);
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("to_optional of an lvalue copies once") {
+    const counted r(result::ok_tag, 2);
+    auto o = result::to_optional(r);
+    REQUIRE(o->value == 2);
+    REQUIRE(move_counter::moves == 0);
+    REQUIRE(move_counter::copies == 1);
+  }
+  SECTION("from_optional moves once") {
+    std::optional<move_counter> o(std::in_place, 3);
+    auto r = result::from_optional(std::move(o));
+    REQUIRE(r.ok_unchecked().value == 3);
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("std::nullopt is an err result") {
+    auto r = result::from_optional(std::optional<move_counter>());
+    REQUIRE(r.is_err());
+    REQUIRE_FALSE(result::to_optional(std::move(r)).has_value());
+  }
+  SECTION("from_optional with an error") {
+    auto r = result::from_optional(std::optional<int>(), std::string("none"));
+    static_assert(std::is_same_v<decltype(r), result::result<int, std::string>>);
+    REQUIRE(r.err_unchecked() == "none");
+    REQUIRE(result::from_optional(std::optional<int>(5), 0).ok_unchecked() ==
+            5);
+  }
+  SECTION("comparison") {
+    const counted ok(result::ok_tag, 4);
+    const counted err(result::err_tag);
+    REQUIRE(ok == std::optional<move_counter>(std::in_place, 4));
+    REQUIRE(ok != std::optional<move_counter>(std::in_place, 5));
+    REQUIRE(ok != std::optional<move_counter>());
+    REQUIRE(err == std::optional<move_counter>());
+    REQUIRE(move_counter::copies == 0);
+  }
+}
+
+#if defined(__cpp_lib_expected)
+TEST_CASE("result to and from std::expected", "[interop]") {
+  using counted = result::result<move_counter, move_counter>;
+  using expected = std::expected<move_counter, move_counter>;
+  move_counter::reset();
+
+  SECTION("to_expected moves an ok value once") {
+    counted r(result::ok_tag, 1);
+    expected e = result::to_expected(std::move(r));
+    REQUIRE(e->value == 1);
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("to_expected moves an err value once") {
+    counted r(result::err_tag, 2);
+    expected e = result::to_expected(std::move(r));
+    REQUIRE(e.error().value == 2);
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("from_expected moves once") {
+    expected e(std::in_place, 3);
+    counted r = result::from_expected(std::move(e));
+    REQUIRE(r.ok_unchecked().value == 3);
+    expected u(std::unexpect, 4);
+    counted r2 = result::from_expected(std::move(u));
+    REQUIRE(r2.err_unchecked().value == 4);
+    REQUIRE(move_counter::moves == 2);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("lvalues copy once") {
+    const expected e(std::in_place, 5);
+    counted r = result::from_expected(e);
+    expected back = result::to_expected(r);
+    REQUIRE(back->value == 5);
+    REQUIRE(move_counter::moves == 0);
+    REQUIRE(move_counter::copies == 2);
+  }
+  SECTION("expected<void, E>") {
+    std::expected<void, int> e;
+    auto r = result::from_expected(std::move(e));
+    static_assert(
+        std::is_same_v<decltype(r), result::result<empty_tag_t, int>>);
+    REQUIRE(r.is_ok());
+    auto back = result::to_expected(result::result<empty_tag_t, int>(
+        result::err_tag, 7));
+    REQUIRE(back.error() == 7);
+    REQUIRE(result::result<empty_tag_t, int>(result::err_tag, 7) == back);
+  }
+  SECTION("expected<void, E> lvalues") {
+    const std::expected<void, int> ok;
+    const std::expected<void, int> err(std::unexpect, 3);
+    const auto r_ok = result::from_expected(ok);
+    const auto r_err = result::from_expected(err);
+    static_assert(
+        std::is_same_v<decltype(r_ok), const result::result<empty_tag_t, int>>);
+    REQUIRE(r_ok.is_ok());
+    REQUIRE(r_err == result::err(3));
+
+    const auto back_ok = result::to_expected(r_ok);
+    const auto back_err = result::to_expected(r_err);
+    static_assert(
+        std::is_same_v<decltype(back_err), const std::expected<void, int>>);
+    REQUIRE(back_ok.has_value());
+    REQUIRE(back_err.error() == 3);
+  }
+  SECTION("comparison") {
+    const counted ok(result::ok_tag, 6);
+    const counted err(result::err_tag, 6);
+    REQUIRE(ok == expected(std::in_place, 6));
+    REQUIRE(ok != expected(std::unexpect, 6));
+    REQUIRE(err == expected(std::unexpect, 6));
+    REQUIRE(err != expected(std::unexpect, 7));
+    REQUIRE(move_counter::copies == 0);
+  }
+}
+
+static_assert([] {
+  std::expected<int, int> e(std::unexpect, 3);
+  return result::to_expected(result::from_expected(e)).error();
+}() == 3);
+#endif
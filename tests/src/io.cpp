@@ -0,0 +1,205 @@
+#include "result/io.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+using result::io_error;
+using result::io_op;
+
+std::string temp_path(const std::string &name) {
+  return (std::filesystem::temp_directory_path() /
+          ("result_io_" + name + ".txt"))
+      .string();
+}
+
+std::string write_file(const std::string &name, std::string_view contents) {
+  const auto path = temp_path(name);
+  std::ofstream(path, std::ios::binary)
+      .write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  return path;
+}
+
+std::string make_contents(std::size_t n) {
+  std::string s;
+  s.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    s.push_back(static_cast<char>('a' + i % 26));
+  }
+  return s;
+}
+
+std::string_view as_chars(std::span<const std::byte> bytes) {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+} // namespace
+
+TEST_CASE("io_error is trivially copyable", "[io]") {
+  STATIC_REQUIRE(std::is_trivially_copyable_v<io_error>);
+  REQUIRE(io_error{io_op::open, ENOENT}.code() ==
+          std::errc::no_such_file_or_directory);
+}
+
+TEST_CASE("map_file", "[io]") {
+  const auto contents = make_contents(100'000);
+  const auto path = write_file("map", contents);
+
+  SECTION("maps the contents") {
+    auto file = result::map_file(path.c_str());
+    REQUIRE(file.is_ok());
+    REQUIRE(file.ok_unchecked().size() == contents.size());
+    REQUIRE(file.ok_unchecked().view() == contents);
+    REQUIRE(as_chars(file.ok_unchecked().bytes()) == contents);
+    REQUIRE(file.ok_unchecked().advise(result::map_advice::random).is_ok());
+  }
+
+  SECTION("outlives the file") {
+    auto file = result::map_file(path.c_str(), result::map_advice::will_need);
+    REQUIRE(file.is_ok());
+    std::filesystem::remove(path);
+    REQUIRE(file.ok_unchecked().view() == contents);
+  }
+
+  SECTION("moves") {
+    auto file = result::map_file(path.c_str()).unwrap();
+    result::mapped_file moved(std::move(file));
+    REQUIRE(file.empty());
+    REQUIRE(moved.view() == contents);
+    file = std::move(moved);
+    REQUIRE(file.view() == contents);
+  }
+
+  SECTION("empty file") {
+    const auto empty_path = write_file("map_empty", "");
+    auto file = result::map_file(empty_path.c_str());
+    REQUIRE(file.is_ok());
+    REQUIRE(file.ok_unchecked().empty());
+    REQUIRE(file.ok_unchecked().view().empty());
+    REQUIRE(file.ok_unchecked().advise(result::map_advice::normal).is_ok());
+    std::filesystem::remove(empty_path);
+  }
+
+  SECTION("errors") {
+    REQUIRE(result::map_file(temp_path("missing").c_str()).err() ==
+            io_error{io_op::open, ENOENT});
+    const auto directory = std::filesystem::temp_directory_path().string();
+    REQUIRE(result::map_file(directory.c_str()).err().value().op ==
+            io_op::map);
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("read_all", "[io]") {
+  const auto contents = make_contents(300'000);
+  const auto path = write_file("read_all", contents);
+
+  SECTION("path") {
+    auto bytes = result::read_all(path.c_str());
+    static_assert(std::is_same_v<decltype(bytes),
+                                 result::io_result<result::byte_buffer>>);
+    REQUIRE(bytes.is_ok());
+    REQUIRE(as_chars(bytes.ok_unchecked()) == contents);
+  }
+
+  SECTION("from the file offset") {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+    REQUIRE(::lseek(fd, 1000, SEEK_SET) == 1000);
+    auto bytes = result::read_all(fd);
+    REQUIRE(bytes.is_ok());
+    REQUIRE(as_chars(bytes.ok_unchecked()) ==
+            std::string_view(contents).substr(1000));
+    REQUIRE(result::read_all(fd).unwrap().empty());
+    ::close(fd);
+  }
+
+  SECTION("pipe") {
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    std::thread writer([&] {
+      std::size_t done = 0;
+      while (done < contents.size()) {
+        const ssize_t n = ::write(fds[1], contents.data() + done,
+                                  contents.size() - done);
+        if (n < 0) {
+          break;
+        }
+        done += static_cast<std::size_t>(n);
+      }
+      ::close(fds[1]);
+    });
+    auto bytes = result::read_all(fds[0]);
+    writer.join();
+    ::close(fds[0]);
+    REQUIRE(bytes.is_ok());
+    REQUIRE(as_chars(bytes.ok_unchecked()) == contents);
+  }
+
+  SECTION("errors") {
+    REQUIRE(result::read_all(temp_path("missing").c_str()).err() ==
+            io_error{io_op::open, ENOENT});
+    REQUIRE(result::read_all(-1).err() == io_error{io_op::stat, EBADF});
+    const auto directory = std::filesystem::temp_directory_path().string();
+    REQUIRE(result::read_all(directory.c_str()).err() ==
+            io_error{io_op::read, EISDIR});
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("pread / pwrite", "[io]") {
+  const auto path = temp_path("positional");
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  REQUIRE(fd >= 0);
+  const std::string_view text = "hello, positional io";
+
+  REQUIRE(result::pwrite(fd, std::as_bytes(std::span(text)), 10).is_ok());
+  REQUIRE(::lseek(fd, 0, SEEK_CUR) == 0);
+
+  std::vector<std::byte> buffer(text.size());
+  REQUIRE(result::pread(fd, buffer, 10) == result::ok(text.size()));
+  REQUIRE(as_chars(buffer) == text);
+
+  SECTION("short read at the end of the file") {
+    REQUIRE(result::pread(fd, buffer, 20) == result::ok(text.size() - 10));
+    REQUIRE(as_chars(std::span(buffer).first(10)) == text.substr(10));
+    REQUIRE(result::pread(fd, buffer, 1000) == result::ok(std::size_t(0)));
+  }
+
+  SECTION("the gap reads as zeros") {
+    REQUIRE(result::pread(fd, buffer, 0) == result::ok(buffer.size()));
+    REQUIRE(buffer[0] == std::byte(0));
+    REQUIRE(buffer[9] == std::byte(0));
+    REQUIRE(buffer[10] == std::byte('h'));
+  }
+
+  SECTION("errors") {
+    REQUIRE(result::pread(-1, buffer, 0).err() ==
+            io_error{io_op::read, EBADF});
+    REQUIRE(result::pwrite(-1, buffer, 0).err() ==
+            io_error{io_op::write, EBADF});
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    REQUIRE(result::pwrite(fds[1], buffer, 0).err() ==
+            io_error{io_op::write, ESPIPE});
+    REQUIRE(result::pread(fds[0], buffer, 0).err() ==
+            io_error{io_op::read, ESPIPE});
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+
+  ::close(fd);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,149 @@
+#include "result/result.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace {
+enum class small_error : std::uint8_t { a, b };
+enum class int_error : std::int32_t { a, b };
+
+struct padded {
+  std::int64_t a;
+  std::int32_t b;
+};
+
+template <typename T, typename E, std::size_t Size, std::size_t Align>
+constexpr bool has_layout() {
+  return sizeof(result::result<T, E>) == Size &&
+         alignof(result::result<T, E>) == Align;
+}
+
+using result::empty_tag_t;
+} // namespace
+
+static_assert(sizeof(result::result_type) == 1);
+
+// sizeof / alignof of common instantiations.
+//
+//  T                E              sizeof                  alignof
+static_assert(has_layout<empty_tag_t,   empty_tag_t,   1,  1>());
+static_assert(has_layout<empty_tag_t,   small_error,   2,  1>());
+static_assert(has_layout<empty_tag_t,   int_error,     8,  4>());
+static_assert(has_layout<std::uint8_t,  small_error,   2,  1>());
+static_assert(has_layout<bool,          empty_tag_t,   2,  1>());
+static_assert(has_layout<std::int16_t,  small_error,   4,  2>());
+static_assert(has_layout<int,           int,           8,  4>());
+static_assert(has_layout<int,           empty_tag_t,   8,  4>());
+static_assert(has_layout<std::int64_t,  std::int32_t,  16, 8>());
+static_assert(has_layout<double,        empty_tag_t,   16, 8>());
+static_assert(has_layout<padded,        small_error,   24, 8>());
+static_assert(has_layout<int &,         empty_tag_t,   sizeof(void *),
+                         alignof(void *)>());
+static_assert(has_layout<const int &,   small_error,   sizeof(void *),
+                         alignof(void *)>());
+static_assert(has_layout<int &,         int,           2 * sizeof(void *),
+                         alignof(void *)>());
+static_assert(has_layout<std::string,   int,
+                         sizeof(std::string) + alignof(std::string),
+                         alignof(std::string)>());
+
+// Trivially copyable payloads give a trivially copyable result.
+static_assert(std::is_trivially_copyable_v<result::result<int, int>>);
+static_assert(std::is_trivially_copyable_v<result::result<int &, int>>);
+static_assert(
+    std::is_trivially_copyable_v<result::result<empty_tag_t, small_error>>);
+static_assert(!std::is_trivially_copyable_v<result::result<std::string, int>>);
+static_assert(!std::is_trivially_destructible_v<result::result<int, std::string>>);
+
+// Exception specifications follow the payloads. legacy_payload is the
+// common hand written type with a noexcept move constructor and a
+// potentially throwing move assignment: std::vector must still move it on
+// reallocation.
+namespace {
+struct legacy_payload {
+  legacy_payload() = default;
+  legacy_payload(const legacy_payload &) {}
+  legacy_payload(legacy_payload &&) noexcept {}
+  legacy_payload &operator=(const legacy_payload &) { return *this; }
+  legacy_payload &operator=(legacy_payload &&) { return *this; }
+};
+
+struct throwing_move {
+  throwing_move() = default;
+  throwing_move(const throwing_move &) = default;
+  throwing_move(throwing_move &&) noexcept(false) {}
+  throwing_move &operator=(const throwing_move &) = default;
+  throwing_move &operator=(throwing_move &&) noexcept(false) { return *this; }
+};
+
+template <typename T, typename E, bool CopyConstruct, bool MoveConstruct,
+          bool CopyAssign, bool MoveAssign>
+constexpr bool has_nothrow() {
+  using R = result::result<T, E>;
+  return std::is_nothrow_copy_constructible_v<R> == CopyConstruct &&
+         std::is_nothrow_move_constructible_v<R> == MoveConstruct &&
+         std::is_nothrow_copy_assignable_v<R> == CopyAssign &&
+         std::is_nothrow_move_assignable_v<R> == MoveAssign;
+}
+} // namespace
+
+//  T                E                copy   move   copy=  move=
+static_assert(has_nothrow<int,            int,             true,  true,  true,  true>());
+static_assert(has_nothrow<int &,          std::string,     false, true,  false, true>());
+static_assert(has_nothrow<std::string,    int,             false, true,  false, true>());
+static_assert(has_nothrow<int,            std::string,     false, true,  false, true>());
+static_assert(has_nothrow<legacy_payload, int,             false, true,  false, false>());
+static_assert(has_nothrow<int,            legacy_payload,  false, true,  false, false>());
+static_assert(has_nothrow<throwing_move,  int,             true,  false, true,  false>());
+static_assert(std::is_nothrow_move_constructible_v<
+              result::result<std::string, result::error_set<int, std::string>>>);
+static_assert(std::is_nothrow_swappable_v<result::result<std::string, int>>);
+static_assert(std::is_nothrow_swappable_v<result::result<throwing_move &, int>>);
+static_assert(!std::is_nothrow_swappable_v<result::result<throwing_move, int>>);
+
+// Assigning a wrapped payload only depends on the payload being assigned.
+static_assert(std::is_nothrow_assignable_v<result::result<int, legacy_payload>,
+                                           result::ok<int> &&>);
+static_assert(!std::is_nothrow_assignable_v<result::result<legacy_payload, int>,
+                                            result::ok<legacy_payload> &&>);
+static_assert(std::is_nothrow_assignable_v<result::result<int, std::string>,
+                                           result::err<std::string> &&>);
+static_assert(!std::is_nothrow_assignable_v<result::result<int, std::string>,
+                                            const result::err<std::string> &>);
+
+// Relocation follows the payloads as well.
+static_assert(result::is_trivially_relocatable_v<result::result<int, int>>);
+static_assert(result::is_trivially_relocatable_v<result::result<int &, int>>);
+static_assert(
+    !result::is_trivially_relocatable_v<result::result<std::string, int>>);
+static_assert(result::is_trivially_relocatable_v<
+              result::result<int, result::error_set<int, small_error>>>);
+static_assert(!result::is_trivially_relocatable_v<
+              result::result<int, result::error_set<int, std::string>>>);
+
+TEST_CASE("result<empty_tag_t, empty_tag_t> single byte layout", "[layout]") {
+  using status = result::result<empty_tag_t, empty_tag_t>;
+  status s0(result::ok_tag);
+  status s1(result::err_tag);
+  REQUIRE(s0.is_ok());
+  REQUIRE(s1.is_err());
+  REQUIRE(s0 != s1);
+  s0 = s1;
+  REQUIRE(s0.is_err());
+  s1 = result::ok();
+  REQUIRE(s1.is_ok());
+  swap(s0, s1);
+  REQUIRE(s0.is_ok());
+  REQUIRE(s1.is_err());
+}
+
+TEST_CASE("result<T, empty_tag_t> with an empty payload", "[layout]") {
+  using status = result::result<empty_tag_t, small_error>;
+  status s0(result::ok_tag);
+  status s1(result::err_tag, small_error::b);
+  REQUIRE(s0.is_ok());
+  REQUIRE(s1.err_unchecked() == small_error::b);
+  s0 = s1;
+  REQUIRE(s0.err_unchecked() == small_error::b);
+}
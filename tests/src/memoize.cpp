@@ -0,0 +1,278 @@
+#include "result/memoize.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace memoize_test {
+using lookup_result = result::result<std::string, int>;
+
+std::atomic<int> calls = 0;
+
+// "name" for the even keys, an error for the odd ones.
+lookup_result lookup(const int &key) {
+  ++calls;
+  if (key % 2 != 0) {
+    return lookup_result(result::err_tag, key);
+  }
+  return lookup_result(result::ok_tag, "name " + std::to_string(key));
+}
+
+const std::string names[] = {"zero", "one", "two"};
+
+// A reference to one of names, an error past its end.
+result::result<const std::string &, int> lookup_ref(const int &key) {
+  ++calls;
+  if (key < 0 || key >= 3) {
+    return result::result<const std::string &, int>(result::err_tag, key);
+  }
+  return result::result<const std::string &, int>(result::ok_tag, names[key]);
+}
+
+std::chrono::steady_clock::time_point fake_now;
+
+std::chrono::steady_clock::time_point now() noexcept { return fake_now; }
+
+result::memoize_options one_shard(std::size_t capacity,
+                                  std::size_t error_capacity = 0) {
+  result::memoize_options options;
+  options.capacity = capacity;
+  options.error_capacity = error_capacity;
+  options.error_ttl = std::chrono::seconds(10);
+  options.shards = 1;
+  options.now = &now;
+  return options;
+}
+// A key whose copies throw once fail_copies is set.
+std::atomic<bool> fail_copies = false;
+
+struct fragile_key {
+  explicit fragile_key(int v) : value(v) {}
+  fragile_key(const fragile_key &other) : value(other.value) {
+    if (fail_copies) {
+      throw std::runtime_error("copy");
+    }
+  }
+  fragile_key &operator=(const fragile_key &) = default;
+  friend bool operator==(const fragile_key &, const fragile_key &) = default;
+  int value;
+};
+
+void hash_append(result::hash_state &h, const fragile_key &key) noexcept {
+  h.append(static_cast<std::uint64_t>(key.value));
+}
+} // namespace memoize_test
+
+using namespace memoize_test;
+
+TEST_CASE("memoize caches ok values", "[memoize]") {
+  calls = 0;
+  result::memoize cached(&lookup, one_shard(2));
+  static_assert(std::is_same_v<decltype(cached)::key_type, std::tuple<int>>);
+
+  REQUIRE(cached(2).ok_unchecked() == "name 2");
+  REQUIRE(cached(2).ok_unchecked() == "name 2");
+  REQUIRE(calls == 1);
+
+  SECTION("the least recently used value is evicted") {
+    cached(4);
+    cached(2);
+    cached(6);
+    REQUIRE(cached.size() == 2);
+    cached(2);
+    REQUIRE(calls == 3);
+    cached(4);
+    REQUIRE(calls == 4);
+    REQUIRE(cached.stats() == result::memoize_stats{.hits = 3,
+                                                    .error_hits = 0,
+                                                    .misses = 4,
+                                                    .shared = 0,
+                                                    .evictions = 2});
+  }
+  SECTION("errors aren't cached by default") {
+    REQUIRE(cached(3).err_unchecked() == 3);
+    REQUIRE(cached(3).err_unchecked() == 3);
+    REQUIRE(calls == 3);
+    REQUIRE(cached.size() == 1);
+  }
+  SECTION("clear") {
+    cached.clear();
+    cached(2);
+    REQUIRE(calls == 2);
+  }
+}
+
+TEST_CASE("memoize stays within its capacities across shards", "[memoize]") {
+  for (const std::size_t capacity : {std::size_t(1), std::size_t(100)}) {
+    result::memoize_options options = one_shard(capacity, capacity);
+    options.shards = 16;
+    result::memoize cached(&lookup, options);
+    for (int key = 0; key < 2000; ++key) {
+      cached(key);
+    }
+    // Half of the keys are errors.
+    REQUIRE(cached.size() <= 2 * capacity);
+  }
+}
+
+TEST_CASE("memoize with small capacities caches every key", "[memoize]") {
+  calls = 0;
+  result::memoize_options options;
+  options.capacity = 2;
+  options.error_capacity = 2;
+  result::memoize cached(&lookup, options);
+  for (int key = 1; key < 64; key += 2) {
+    REQUIRE(cached(key).err_unchecked() == key);
+    REQUIRE(cached(key).err_unchecked() == key);
+  }
+  REQUIRE(cached.stats().error_hits == 32);
+  REQUIRE(cached.size() <= 2);
+}
+
+TEST_CASE("memoize caches references", "[memoize]") {
+  calls = 0;
+  result::memoize cached(&lookup_ref, one_shard(2));
+  REQUIRE(&cached(1).ok_unchecked() == &names[1]);
+  REQUIRE(&cached(1).ok_unchecked() == &names[1]);
+  REQUIRE(cached(5).err_unchecked() == 5);
+  REQUIRE(calls == 2);
+}
+
+TEST_CASE("memoize caches errors until they expire", "[memoize]") {
+  calls = 0;
+  fake_now = {};
+  result::memoize cached(&lookup, one_shard(4, 2));
+
+  REQUIRE(cached(1).err_unchecked() == 1);
+  fake_now += std::chrono::seconds(9);
+  REQUIRE(cached(1).err_unchecked() == 1);
+  REQUIRE(calls == 1);
+  REQUIRE(cached.stats().error_hits == 1);
+
+  SECTION("expiry") {
+    fake_now += std::chrono::seconds(1);
+    REQUIRE(cached(1).err_unchecked() == 1);
+    REQUIRE(calls == 2);
+  }
+  SECTION("the errors have their own bound") {
+    cached(3);
+    cached(5);
+    cached(1);
+    REQUIRE(calls == 4);
+    REQUIRE(cached.size() == 2);
+    cached(2);
+    REQUIRE(cached.size() == 3);
+  }
+}
+
+TEST_CASE("memoize with several arguments", "[memoize]") {
+  int calls_of_join = 0;
+  auto join = [&calls_of_join](const std::string &a, const int &b) {
+    ++calls_of_join;
+    return result::result<std::string, int>(result::ok_tag,
+                                            a + std::to_string(b));
+  };
+  result::memoize<decltype(join), std::string, int> cached(join);
+  REQUIRE(cached("a", 1).ok_unchecked() == "a1");
+  REQUIRE(cached("a", 2).ok_unchecked() == "a2");
+  REQUIRE(cached(std::string("a"), 1).ok_unchecked() == "a1");
+  REQUIRE(calls_of_join == 2);
+}
+
+TEST_CASE("memoize doesn't cache exceptions", "[memoize]") {
+  int attempts = 0;
+  auto flaky = [&attempts](const int &) -> result::result<int, int> {
+    if (++attempts == 1) {
+      throw std::runtime_error("unavailable");
+    }
+    return result::result<int, int>(result::ok_tag, 7);
+  };
+  result::memoize<decltype(flaky), int> cached(flaky);
+  REQUIRE_THROWS_AS(cached(0), std::runtime_error);
+  REQUIRE(cached(0).ok_unchecked() == 7);
+  REQUIRE(cached(0).ok_unchecked() == 7);
+  REQUIRE(attempts == 2);
+}
+
+TEST_CASE("concurrent misses call the function once", "[memoize]") {
+  constexpr int threads = 4;
+  std::atomic<bool> release = false;
+  std::atomic<int> slow_calls = 0;
+  auto slow = [&](const int &key) {
+    ++slow_calls;
+    while (!release) {
+      std::this_thread::yield();
+    }
+    return result::result<std::string, int>(result::ok_tag,
+                                            std::string(100, 'x') +
+                                                std::to_string(key));
+  };
+  result::memoize<decltype(slow), int> cached(slow);
+
+  std::vector<std::string> values(threads);
+  {
+    std::vector<std::jthread> callers;
+    for (int i = 0; i < threads; ++i) {
+      callers.emplace_back(
+          [&cached, &value = values[i]] { value = cached(5).ok_unchecked(); });
+    }
+    while (cached.stats().shared != threads - 1) {
+      std::this_thread::yield();
+    }
+    release = true;
+  }
+
+  REQUIRE(slow_calls == 1);
+  for (const auto &value : values) {
+    REQUIRE(value == values.front());
+  }
+  REQUIRE(cached.stats().misses == 1);
+}
+
+TEST_CASE("waiting calls wake up when caching a result throws",
+          "[memoize]") {
+  std::atomic<bool> release = false;
+  auto slow = [&release](const fragile_key &key) {
+    while (!release) {
+      std::this_thread::yield();
+    }
+    // Storing the key in the cache copies it.
+    fail_copies = true;
+    return result::result<int, int>(result::ok_tag, key.value);
+  };
+  result::memoize<decltype(slow), fragile_key> cached(slow);
+
+  bool caller_threw = false;
+  bool waiter_threw = false;
+  {
+    std::jthread caller([&] {
+      try {
+        cached(fragile_key(1));
+      } catch (const std::runtime_error &) {
+        caller_threw = true;
+      }
+    });
+    while (cached.stats().misses != 1) {
+      std::this_thread::yield();
+    }
+    std::jthread waiter([&] {
+      try {
+        cached(fragile_key(1));
+      } catch (const std::runtime_error &) {
+        waiter_threw = true;
+      }
+    });
+    while (cached.stats().shared != 1) {
+      std::this_thread::yield();
+    }
+    release = true;
+  }
+  fail_copies = false;
+
+  REQUIRE(caller_threw);
+  REQUIRE(waiter_threw);
+  REQUIRE(cached.size() == 0);
+}
@@ -0,0 +1,227 @@
+#include "result/parse.hpp"
+#include "result/pmr.hpp"
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+using result::parse_errc;
+using result::parse_error;
+
+template <typename T> result::parse_result<T> err(parse_errc kind,
+                                                  std::uint32_t position) {
+  return result::parse_result<T>(result::err_tag,
+                                 parse_error{kind, position});
+}
+
+template <typename T> result::parse_result<T> ok(T value) {
+  return result::parse_result<T>(result::ok_tag, value);
+}
+
+// The value std::from_chars parses from the whole text, if any.
+template <typename T> bool from_chars(std::string_view text, T &value) {
+  const auto [end, ec] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc() && end == text.data() + text.size();
+}
+} // namespace
+
+TEST_CASE("parse_error is small and trivially copyable", "[parse]") {
+  STATIC_REQUIRE(std::is_trivially_copyable_v<parse_error>);
+  STATIC_REQUIRE(sizeof(parse_error) == 8);
+  STATIC_REQUIRE(sizeof(result::parse_result<std::int64_t>) == 16);
+}
+
+TEST_CASE("parse<T> integers", "[parse]") {
+  REQUIRE(result::parse<int>("0") == ok(0));
+  REQUIRE(result::parse<int>("42") == ok(42));
+  REQUIRE(result::parse<int>("-42") == ok(-42));
+  REQUIRE(result::parse<int>("000123") == ok(123));
+  REQUIRE(result::parse<std::uint64_t>("1700000000000") ==
+          ok<std::uint64_t>(1700000000000));
+  REQUIRE(result::parse<std::uint64_t>("12345678901234567890") ==
+          ok<std::uint64_t>(12345678901234567890u));
+  REQUIRE(result::parse<std::int64_t>("00000000000000000000000000042") ==
+          ok<std::int64_t>(42));
+
+  SECTION("limits") {
+    REQUIRE(result::parse<std::int8_t>("127") == ok<std::int8_t>(127));
+    REQUIRE(result::parse<std::int8_t>("-128") == ok<std::int8_t>(-128));
+    REQUIRE(result::parse<std::int8_t>("128") ==
+            err<std::int8_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::int8_t>("-129") ==
+            err<std::int8_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::uint8_t>("255") == ok<std::uint8_t>(255));
+    REQUIRE(result::parse<std::uint8_t>("256") ==
+            err<std::uint8_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::int64_t>("-9223372036854775808") ==
+            ok(std::numeric_limits<std::int64_t>::min()));
+    REQUIRE(result::parse<std::int64_t>("9223372036854775808") ==
+            err<std::int64_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::uint64_t>("18446744073709551615") ==
+            ok(std::numeric_limits<std::uint64_t>::max()));
+    REQUIRE(result::parse<std::uint64_t>("18446744073709551616") ==
+            err<std::uint64_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::uint64_t>("99999999999999999999") ==
+            err<std::uint64_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::uint64_t>("09999999999999999999") ==
+            ok<std::uint64_t>(9999999999999999999u));
+    REQUIRE(result::parse<std::uint64_t>("18446744073709551615-") ==
+            err<std::uint64_t>(parse_errc::trailing_characters, 20));
+  }
+
+  SECTION("errors") {
+    REQUIRE(result::parse<int>("") == err<int>(parse_errc::empty, 0));
+    REQUIRE(result::parse<int>("-") ==
+            err<int>(parse_errc::invalid_character, 1));
+    REQUIRE(result::parse<int>("x1") ==
+            err<int>(parse_errc::invalid_character, 0));
+    REQUIRE(result::parse<int>("+1") ==
+            err<int>(parse_errc::invalid_character, 0));
+    REQUIRE(result::parse<int>(" 1") ==
+            err<int>(parse_errc::invalid_character, 0));
+    REQUIRE(result::parse<unsigned>("-1") ==
+            err<unsigned>(parse_errc::invalid_character, 0));
+    REQUIRE(result::parse<int>("12a") ==
+            err<int>(parse_errc::trailing_characters, 2));
+    REQUIRE(result::parse<std::int64_t>("-1234567890/") ==
+            err<std::int64_t>(parse_errc::trailing_characters, 11));
+    REQUIRE(result::parse<std::uint64_t>("123456789012345678901x") ==
+            err<std::uint64_t>(parse_errc::out_of_range, 0));
+    REQUIRE(result::parse<std::uint64_t>("000000000000000000000001x") ==
+            err<std::uint64_t>(parse_errc::trailing_characters, 24));
+  }
+
+  SECTION("does not read past the text") {
+    // Digits follow each prefix, and the address sanitizer checks that the
+    // reads stay within an exactly sized buffer.
+    const std::string_view digits = "123456789012345678";
+    for (std::size_t n = 1; n <= digits.size(); ++n) {
+      const std::vector<char> buffer(digits.begin(), digits.begin() + n);
+      const std::string_view text(buffer.data(), buffer.size());
+      std::uint64_t expected = 0;
+      REQUIRE(from_chars(text, expected));
+      REQUIRE(result::parse<std::uint64_t>(text) == ok(expected));
+      REQUIRE(result::parse<std::uint64_t>(digits.substr(0, n)) ==
+              ok(expected));
+    }
+  }
+
+  SECTION("base") {
+    REQUIRE(result::parse<int>("ff", 16) == ok(255));
+    REQUIRE(result::parse<int>("-101", 2) == ok(-5));
+    REQUIRE(result::parse<int>("99", 10) == ok(99));
+    REQUIRE(result::parse<int>("12", 2) ==
+            err<int>(parse_errc::trailing_characters, 1));
+    REQUIRE(result::parse<std::uint8_t>("100", 16) ==
+            err<std::uint8_t>(parse_errc::out_of_range, 0));
+  }
+}
+
+TEST_CASE("parse<T> agrees with std::from_chars on integers", "[parse]") {
+  std::mt19937_64 random(42);
+  std::vector<std::string> texts = {"0", "-0", "-", "", "1-", "9x9"};
+  for (int i = 0; i < 20000; ++i) {
+    const std::uint64_t word = random();
+    std::string text = std::to_string(word >> (word % 64));
+    if (word & 1) {
+      text.insert(0, "-");
+    }
+    if ((word & 0x30) == 0) {
+      text[random() % text.size()] = static_cast<char>(random() % 128);
+    }
+    texts.push_back(text);
+  }
+  for (const auto &text : texts) {
+    INFO(text);
+    std::int64_t expected_signed = 0;
+    if (from_chars(text, expected_signed)) {
+      REQUIRE(result::parse<std::int64_t>(text) == ok(expected_signed));
+    } else {
+      REQUIRE(result::parse<std::int64_t>(text).is_err());
+    }
+    std::uint32_t expected_unsigned = 0;
+    if (from_chars(text, expected_unsigned)) {
+      REQUIRE(result::parse<std::uint32_t>(text) == ok(expected_unsigned));
+    } else {
+      REQUIRE(result::parse<std::uint32_t>(text).is_err());
+    }
+  }
+}
+
+TEST_CASE("parse<T> floating point", "[parse]") {
+  REQUIRE(result::parse<double>("0.75") == ok(0.75));
+  REQUIRE(result::parse<double>("-12.5") == ok(-12.5));
+  REQUIRE(result::parse<double>(".5") == ok(0.5));
+  REQUIRE(result::parse<double>("3.") == ok(3.0));
+  REQUIRE(result::parse<double>("1e3") == ok(1000.0));
+  REQUIRE(result::parse<float>("0.1") == ok(0.1f));
+  REQUIRE(std::signbit(result::parse<double>("-0").unwrap()));
+  REQUIRE(std::isinf(result::parse<double>("inf").unwrap()));
+  REQUIRE(std::isnan(result::parse<double>("nan").unwrap()));
+
+  REQUIRE(result::parse<double>("") == err<double>(parse_errc::empty, 0));
+  REQUIRE(result::parse<double>(".") ==
+          err<double>(parse_errc::invalid_character, 0));
+  REQUIRE(result::parse<double>("-x") ==
+          err<double>(parse_errc::invalid_character, 1));
+  REQUIRE(result::parse<double>("1.5.") ==
+          err<double>(parse_errc::trailing_characters, 3));
+  REQUIRE(result::parse<double>("1e999") ==
+          err<double>(parse_errc::out_of_range, 0));
+}
+
+TEST_CASE("parse<T> agrees with std::from_chars on floating point",
+          "[parse]") {
+  std::mt19937_64 random(7);
+  std::vector<std::string> texts = {"9007199254740993",
+                                    "9007199254740992.5",
+                                    "0.1000000000000000055511151231257827",
+                                    "1234567890123456789.0",
+                                    "0.0000000000000000000001",
+                                    "123.456e-7",
+                                    "16777217",
+                                    "0.3"};
+  for (int i = 0; i < 20000; ++i) {
+    const std::uint64_t word = random();
+    std::string text = std::to_string(word >> (word % 64));
+    text.insert(random() % (text.size() + 1), ".");
+    if (word & 1) {
+      text.insert(0, "-");
+    }
+    texts.push_back(text);
+  }
+  for (const auto &text : texts) {
+    INFO(text);
+    double expected = 0;
+    REQUIRE(from_chars(text, expected));
+    const auto parsed = result::parse<double>(text);
+    REQUIRE(parsed.is_ok());
+    REQUIRE(std::bit_cast<std::uint64_t>(parsed.ok_unchecked()) ==
+            std::bit_cast<std::uint64_t>(expected));
+    float expected_float = 0;
+    REQUIRE(from_chars(text, expected_float));
+    const auto parsed_float = result::parse<float>(text);
+    REQUIRE(parsed_float.is_ok());
+    REQUIRE(std::bit_cast<std::uint32_t>(parsed_float.ok_unchecked()) ==
+            std::bit_cast<std::uint32_t>(expected_float));
+  }
+}
+
+TEST_CASE("parse_many", "[parse]") {
+  const std::vector<std::string_view> texts = {"1", "x", "-3", "", "40"};
+  result::pmr::result_vector<int, parse_error> out(texts.size());
+  REQUIRE(result::parse_many<int>(texts, out) == 2);
+  REQUIRE(out[0] == ok(1));
+  REQUIRE(out[1] == err<int>(parse_errc::invalid_character, 0));
+  REQUIRE(out[2] == ok(-3));
+  REQUIRE(out[3] == err<int>(parse_errc::empty, 0));
+  REQUIRE(out[4] == ok(40));
+}
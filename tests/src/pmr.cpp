@@ -0,0 +1,111 @@
+#include "result/pmr.hpp"
+#include "result_test/allocation.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace pmr_test {
+using alloc = std::pmr::polymorphic_allocator<>;
+using string_result = result::pmr::string_result<int>;
+using error_result = result::result<int, std::pmr::string>;
+
+static_assert(std::uses_allocator_v<string_result, alloc>);
+static_assert(std::uses_allocator_v<error_result, alloc>);
+static_assert(!std::uses_allocator_v<result::result<int, int>, alloc>);
+static_assert(
+    !std::uses_allocator_v<result::result<std::string, int>, alloc>);
+static_assert(
+    std::uses_allocator_v<result::pmr::vector_result<int, int>, alloc>);
+
+// Too long for the small string buffer.
+const std::string long_storage(200, 'x');
+const std::string_view long_text = long_storage;
+
+std::pmr::memory_resource *resource_of(const std::pmr::string &s) {
+  return s.get_allocator().resource();
+}
+
+// Arena on the stack that fails instead of falling back to the heap.
+struct arena {
+  alignas(std::max_align_t) std::array<std::byte, 16 * 1024> buffer;
+  std::pmr::monotonic_buffer_resource resource{
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+};
+} // namespace pmr_test
+
+using namespace pmr_test;
+
+TEST_CASE("allocator-extended constructors", "[pmr]") {
+  arena a;
+  const alloc al(&a.resource);
+
+  SECTION("ok and err payloads use the allocator") {
+    string_result ok(std::allocator_arg, al, result::ok_tag, long_text);
+    error_result err(std::allocator_arg, al, result::err_tag, long_text);
+    REQUIRE(resource_of(ok.ok_unchecked()) == &a.resource);
+    REQUIRE(resource_of(err.err_unchecked()) == &a.resource);
+  }
+  SECTION("payloads without allocator ignore it") {
+    result::result<int, std::pmr::string> r(std::allocator_arg, al,
+                                            result::ok_tag, 4);
+    REQUIRE(r.ok_unchecked() == 4);
+  }
+  SECTION("default construction") {
+    string_result r(std::allocator_arg, al);
+    REQUIRE(r.is_ok());
+    REQUIRE(resource_of(r.ok_unchecked()) == &a.resource);
+  }
+  SECTION("copy and move into another resource") {
+    const string_result heap(result::ok_tag, long_text);
+    string_result copy(std::allocator_arg, al, heap);
+    REQUIRE(copy.ok_unchecked() == long_text);
+    REQUIRE(resource_of(copy.ok_unchecked()) == &a.resource);
+
+    string_result moved(std::allocator_arg, al, std::move(copy));
+    REQUIRE(moved.ok_unchecked() == long_text);
+    REQUIRE(resource_of(moved.ok_unchecked()) == &a.resource);
+  }
+  SECTION("from ok() / err() wrappers") {
+    string_result ok(std::allocator_arg, al,
+                     result::ok(std::pmr::string(long_text)));
+    error_result err(std::allocator_arg, al,
+                     result::err(std::pmr::string(long_text)));
+    REQUIRE(resource_of(ok.ok_unchecked()) == &a.resource);
+    REQUIRE(resource_of(err.err_unchecked()) == &a.resource);
+  }
+  SECTION("make_ok / make_err") {
+    auto ok = result::pmr::make_ok<std::pmr::string, int>(&a.resource, 3,
+                                                          'y');
+    auto err = result::pmr::make_err<int, std::pmr::string>(&a.resource,
+                                                            long_text);
+    REQUIRE(ok.ok_unchecked() == "yyy");
+    REQUIRE(resource_of(err.err_unchecked()) == &a.resource);
+  }
+}
+
+TEST_CASE("pmr containers propagate their resource", "[pmr]") {
+  arena a;
+  result::pmr::result_vector<std::pmr::string, std::pmr::string> rows(
+      &a.resource);
+  const result::result<std::pmr::string, std::pmr::string> heap(
+      result::err_tag, long_text);
+
+  result_test::allocation_scope scope;
+  rows.reserve(4);
+  rows.emplace_back(result::ok_tag, long_text);
+  rows.emplace_back(result::err_tag, long_text);
+  rows.push_back(heap);
+  rows.push_back(rows.front());
+  const auto allocations = scope.allocations();
+
+  REQUIRE(allocations == 0);
+  for (const auto &row : rows) {
+    REQUIRE(resource_of(row.is_ok() ? row.ok_unchecked()
+                                    : row.err_unchecked()) == &a.resource);
+  }
+  REQUIRE(rows[3].ok_unchecked() == long_text);
+}
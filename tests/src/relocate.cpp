@@ -0,0 +1,126 @@
+#include "result/relocate.hpp"
+#include "result/result.hpp"
+#include "result_test/tracked.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace relocate_test {
+// Owns its value through a pointer, so its bytes can be moved around.
+class handle {
+public:
+  explicit handle(int v) : m_value(new int(v)) {}
+  handle(handle &&other) noexcept : m_value(other.m_value) {
+    other.m_value = nullptr;
+  }
+  ~handle() { delete m_value; }
+
+  int value() const { return *m_value; }
+
+private:
+  int *m_value;
+};
+
+using value = result_test::tracked<std::string, struct value_tag>;
+
+// Copyable, with a move constructor that may throw, and a copy constructor
+// that throws once copies_left copies are made.
+struct fragile {
+  static inline int copies_left = 0;
+
+  explicit fragile(std::string v) : value(std::move(v)) {}
+  fragile(const fragile &other) : value(other.value) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("copy");
+    }
+  }
+  fragile(fragile &&other) noexcept(false) : value(std::move(other.value)) {}
+
+  std::string value;
+};
+
+template <typename T> struct buffer {
+  explicit buffer(std::size_t n)
+      : data(static_cast<T *>(::operator new(n * sizeof(T)))) {}
+  ~buffer() { ::operator delete(data); }
+
+  T *data;
+};
+} // namespace relocate_test
+
+template <>
+struct result::is_trivially_relocatable<relocate_test::handle>
+    : std::true_type {};
+
+using namespace relocate_test;
+
+static_assert(result::is_trivially_relocatable_v<int>);
+static_assert(result::is_trivially_relocatable_v<handle>);
+static_assert(!result::is_trivially_relocatable_v<std::string>);
+static_assert(result::is_trivially_relocatable_v<result::result<handle, int>>);
+static_assert(
+    !result::is_trivially_relocatable_v<result::result<handle, std::string>>);
+
+TEST_CASE("relocate_n of trivially relocatable results", "[relocate]") {
+  using handle_result = result::result<handle, int>;
+  buffer<handle_result> from(3);
+  buffer<handle_result> to(3);
+  std::construct_at(from.data, result::ok_tag, 1);
+  std::construct_at(from.data + 1, result::err_tag, 2);
+  std::construct_at(from.data + 2, result::ok_tag, 3);
+
+  handle_result *last = result::relocate_n(from.data, 3, to.data);
+
+  REQUIRE(last == to.data + 3);
+  REQUIRE(to.data[0].ok_unchecked().value() == 1);
+  REQUIRE(to.data[1].err_unchecked() == 2);
+  REQUIRE(to.data[2].ok_unchecked().value() == 3);
+  std::destroy_n(to.data, 3);
+}
+
+TEST_CASE("relocate_n of other results", "[relocate]") {
+  using value_result = result::result<value, int>;
+  buffer<value_result> from(2);
+  buffer<value_result> to(2);
+  std::construct_at(from.data, result::ok_tag, "a");
+  std::construct_at(from.data + 1, result::err_tag, 2);
+  value::reset();
+
+  result::relocate_n(from.data, 2, to.data);
+
+  REQUIRE(to.data[0].ok_unchecked().value() == "a");
+  REQUIRE(to.data[1].err_unchecked() == 2);
+  REQUIRE(value::counts().moves() == 1);
+  REQUIRE(value::counts().copies() == 0);
+  REQUIRE(value::counts().destructions == 1);
+  std::destroy_n(to.data, 2);
+}
+
+TEST_CASE("relocate_n of nothing", "[relocate]") {
+  int *p = nullptr;
+  REQUIRE(result::relocate_n(p, 0, p) == nullptr);
+}
+
+TEST_CASE("relocate_n leaves the sources untouched if a copy throws",
+          "[relocate]") {
+  buffer<fragile> from(3);
+  buffer<fragile> to(3);
+  std::construct_at(from.data, "a long enough string not to be inline");
+  std::construct_at(from.data + 1, "b");
+  std::construct_at(from.data + 2, "c");
+
+  fragile::copies_left = 1;
+  REQUIRE_THROWS_AS(result::relocate_n(from.data, 3, to.data),
+                    std::runtime_error);
+  REQUIRE(from.data[0].value == "a long enough string not to be inline");
+  REQUIRE(from.data[1].value == "b");
+  REQUIRE(from.data[2].value == "c");
+
+  fragile::copies_left = 3;
+  result::relocate_n(from.data, 3, to.data);
+  REQUIRE(to.data[0].value == "a long enough string not to be inline");
+  REQUIRE(to.data[2].value == "c");
+  std::destroy_n(to.data, 3);
+}
@@ -1,7 +1,11 @@
 #include "result/result.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
 #include <compare>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using result_type1 = result::result<std::string, double>;
 using result_type2 = result::result<double, std::string>;
@@ -515,6 +519,44 @@ TEST_CASE("result<T, E> transformations", "[result<T, E>]") {
     REQUIRE(r2.or_else(fun) == result_type3(result::err(true)));
     REQUIRE(r3.or_else(fun) == result_type3(result::err(false)));
   }
+  SECTION("match") {
+    result_type1 r1(ok_type1("abc"));
+    result_type1 r2(err_type2(5.0));
+    auto on_ok = [](const std::string &x) { return x + "def"; };
+    auto on_err = [](double x) { return std::to_string(static_cast<int>(x)); };
+    REQUIRE(r1.match(on_ok, on_err) == "abcdef");
+    REQUIRE(r2.match(on_ok, on_err) == "5");
+
+    auto size = r1.match([](const std::string &x) { return x.size(); },
+                         [](double) { return 0; });
+    static_assert(std::is_same_v<decltype(size), std::size_t>);
+    REQUIRE(size == 3);
+
+    r1.match([](std::string &x) -> std::string & { return x; },
+             [](double &) -> std::string & {
+               static std::string none;
+               return none;
+             }) = "xyz";
+    REQUIRE(r1.ok_unchecked() == "xyz");
+  }
+  SECTION("visit") {
+    result_type1 r1(ok_type1("abc"));
+    const result_type1 r2(err_type2(5.0));
+    auto describe =
+        result::overloaded{[](const std::string &x) { return "ok " + x; },
+                           [](double) { return std::string("err"); }};
+    REQUIRE(result::visit(describe, r1) == "ok abc");
+    REQUIRE(result::visit(describe, r2) == "err");
+    REQUIRE(result::visit([](const auto &x) { return sizeof(x); }, r2) ==
+            sizeof(double));
+  }
+  SECTION("select") {
+    const result::result<int, int> r1(result::ok_tag, 1);
+    const result::result<int, int> r2(result::err_tag, 2);
+    REQUIRE(r1.select(10, 20) == 10);
+    REQUIRE(r2.select(10, 20) == 20);
+    REQUIRE(r2.select<std::string>("ok", "err") == "err");
+  }
 }
 
 TEST_CASE("std::hash<result<T, E>>", "[std::hash]") {
@@ -586,4 +628,430 @@ TEST_CASE("result<T, E> comparison", "[result<T, E>]") {
     REQUIRE_FALSE((c > 0));
     REQUIRE_FALSE((c < 0));
   }
-}
\ No newline at end of file
+}
+
+namespace hash_test {
+struct point {
+  int x;
+  int y;
+  bool operator==(const point &) const = default;
+};
+
+void hash_append(result::hash_state &h, const point &p) {
+  hash_append(h, p.x);
+  hash_append(h, p.y);
+}
+} // namespace hash_test
+
+TEST_CASE("std::hash<result<T, E>> mixing", "[std::hash]") {
+  using int_result = result::result<int, int>;
+  SECTION("ok and err with the same payload") {
+    int_result r0(result::ok_tag, 5);
+    int_result r1(result::err_tag, 5);
+    REQUIRE(std::hash<int_result>{}(r0) != std::hash<int_result>{}(r1));
+  }
+  SECTION("empty_tag_t payloads") {
+    using empty_result = result::result<result::empty_tag_t, result::empty_tag_t>;
+    empty_result r0(result::ok_tag);
+    empty_result r1(result::ok_tag);
+    empty_result r2(result::err_tag);
+    REQUIRE(std::hash<empty_result>{}(r0) == std::hash<empty_result>{}(r1));
+    REQUIRE(std::hash<empty_result>{}(r0) != std::hash<empty_result>{}(r2));
+  }
+  SECTION("low bits of aligned payloads") {
+    std::vector<int> buckets(64, 0);
+    for (int i = 0; i < 64; ++i) {
+      int_result r(result::ok_tag, i * 1024);
+      ++buckets[std::hash<int_result>{}(r) % 64];
+    }
+    REQUIRE(*std::max_element(buckets.begin(), buckets.end()) < 8);
+  }
+  SECTION("hash_append customization") {
+    using point_result = result::result<hash_test::point, std::string>;
+    point_result r0(result::ok_tag, hash_test::point{1, 2});
+    point_result r1(result::ok_tag, hash_test::point{1, 2});
+    point_result r2(result::ok_tag, hash_test::point{2, 1});
+    REQUIRE(std::hash<point_result>{}(r0) == std::hash<point_result>{}(r1));
+    REQUIRE(std::hash<point_result>{}(r0) != std::hash<point_result>{}(r2));
+  }
+}
+
+TEST_CASE("hash_many()", "[std::hash]") {
+  std::vector<result_type2> values;
+  for (int i = 0; i < 100; ++i) {
+    if (i % 2 == 0) {
+      values.emplace_back(result::ok_tag, i * 0.5);
+    } else {
+      values.emplace_back(result::err_tag, std::to_string(i));
+    }
+  }
+  std::vector<std::size_t> hashes(values.size());
+  result::hash_many(values, hashes);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    REQUIRE(hashes[i] == std::hash<result_type2>{}(values[i]));
+  }
+}
+
+TEST_CASE("swap(result<T, E>&, result<T, E>&)", "[result<T, E>]") {
+  SECTION("ok / ok") {
+    result_type1 r0(ok_type1("abc"));
+    result_type1 r1(ok_type1("def"));
+    swap(r0, r1);
+    REQUIRE(r0 == ok_type1("def"));
+    REQUIRE(r1 == ok_type1("abc"));
+  }
+  SECTION("err / err") {
+    result_type2 r0(err_type1("abc"));
+    result_type2 r1(err_type1("def"));
+    swap(r0, r1);
+    REQUIRE(r0 == err_type1("def"));
+    REQUIRE(r1 == err_type1("abc"));
+  }
+  SECTION("ok / err") {
+    result_type1 r0(ok_type1("abc"));
+    result_type1 r1(err_type2(5.0));
+    swap(r0, r1);
+    REQUIRE(r0 == err_type2(5.0));
+    REQUIRE(r1 == ok_type1("abc"));
+  }
+  SECTION("err / ok") {
+    result_type1 r0(err_type2(5.0));
+    result_type1 r1(ok_type1("abc"));
+    r0.swap(r1);
+    REQUIRE(r0 == ok_type1("abc"));
+    REQUIRE(r1 == err_type2(5.0));
+  }
+  SECTION("std::swap") {
+    result_type1 r0(err_type2(5.0));
+    result_type1 r1(ok_type1("abc"));
+    using std::swap;
+    swap(r0, r1);
+    REQUIRE(r0 == ok_type1("abc"));
+    REQUIRE(r1 == err_type2(5.0));
+  }
+}
+
+namespace swap_test {
+// Throws from the move constructor call that brings moves_left to 0.
+struct throwing_move {
+  static inline int moves_left = 0;
+
+  explicit throwing_move(int v) : value(v) {}
+  throwing_move(const throwing_move &) = default;
+  throwing_move(throwing_move &&other) : value(other.value) {
+    if (moves_left > 0 && --moves_left == 0) {
+      throw std::runtime_error("move");
+    }
+  }
+  throwing_move &operator=(const throwing_move &) = default;
+  throwing_move &operator=(throwing_move &&) = default;
+
+  int value;
+};
+} // namespace swap_test
+
+TEST_CASE("swap(result<T, E>&, result<T, E>&) with a throwing move",
+          "[result<T, E>]") {
+  using swap_test::throwing_move;
+  SECTION("moving the err value throws") {
+    result::result<std::string, throwing_move> r0(result::ok_tag, "abc");
+    result::result<std::string, throwing_move> r1(result::err_tag, 5);
+    throwing_move::moves_left = 1;
+    REQUIRE_THROWS_AS(swap(r0, r1), std::runtime_error);
+    REQUIRE(r0.is_ok());
+    REQUIRE(r0.ok_unchecked() == "abc");
+    REQUIRE(r1.is_err());
+    REQUIRE(r1.err_unchecked().value == 5);
+  }
+  SECTION("moving the ok value back throws") {
+    result::result<throwing_move, std::string> r0(result::err_tag, "abc");
+    result::result<throwing_move, std::string> r1(result::ok_tag, 5);
+    throwing_move::moves_left = 2;
+    REQUIRE_THROWS_AS(r0.swap(r1), std::runtime_error);
+    REQUIRE(r0.is_err());
+    REQUIRE(r0.err_unchecked() == "abc");
+    REQUIRE(r1.is_ok());
+    REQUIRE(r1.ok_unchecked().value == 5);
+  }
+  throwing_move::moves_left = 0;
+}
+
+namespace construction_test {
+struct move_counter {
+  static inline int copies = 0;
+  static inline int moves = 0;
+
+  static void reset() {
+    copies = 0;
+    moves = 0;
+  }
+
+  explicit move_counter(int v = 0) : value(v) {}
+  move_counter(int a, int b) : value(a + b) {}
+  move_counter(const move_counter &other) : value(other.value) { ++copies; }
+  move_counter(move_counter &&other) noexcept : value(other.value) { ++moves; }
+  move_counter &operator=(const move_counter &) = default;
+  move_counter &operator=(move_counter &&) = default;
+
+  int value;
+};
+
+using counted_result = result::result<move_counter, int>;
+using counted_err_result = result::result<int, move_counter>;
+
+counted_result return_ok_ref() {
+  return result::ok_ref(move_counter(1));
+}
+
+counted_err_result return_err_ref() {
+  return result::err_ref(move_counter(2));
+}
+
+counted_result return_ok() { return result::ok(move_counter(3)); }
+} // namespace construction_test
+
+TEST_CASE("result<T, E> construction move counts", "[result<T, E>]") {
+  using namespace construction_test;
+  move_counter::reset();
+  SECTION("make_ok constructs in place") {
+    auto r = result::make_ok<move_counter, int>(1, 2);
+    REQUIRE(r.ok_unchecked().value == 3);
+    REQUIRE(move_counter::moves == 0);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("make_err constructs in place") {
+    auto r = result::make_err<int, move_counter>(4);
+    REQUIRE(r.err_unchecked().value == 4);
+    REQUIRE(move_counter::moves == 0);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("make_ok from an rvalue moves once") {
+    move_counter m(5);
+    auto r = result::make_ok<move_counter, int>(std::move(m));
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("ok_ref moves once") {
+    auto r = return_ok_ref();
+    REQUIRE(r.ok_unchecked().value == 1);
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("err_ref moves once") {
+    auto r = return_err_ref();
+    REQUIRE(r.err_unchecked().value == 2);
+    REQUIRE(move_counter::moves == 1);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("ok_ref of an lvalue copies once") {
+    move_counter m(6);
+    counted_result r = result::ok_ref(m);
+    REQUIRE(r.ok_unchecked().value == 6);
+    REQUIRE(move_counter::moves == 0);
+    REQUIRE(move_counter::copies == 1);
+  }
+  SECTION("ok<T> moves into the wrapper and into the result") {
+    auto r = return_ok();
+    REQUIRE(r.ok_unchecked().value == 3);
+    REQUIRE(move_counter::moves == 2);
+    REQUIRE(move_counter::copies == 0);
+  }
+  SECTION("ok<T> lvalue conversion copies once") {
+    result::ok<move_counter> o(move_counter(7));
+    move_counter::reset();
+    counted_result r(o);
+    REQUIRE(move_counter::moves == 0);
+    REQUIRE(move_counter::copies == 1);
+  }
+}
+
+TEST_CASE("result<T, E> monadic operations per value category",
+          "[result<T, E>]") {
+  using namespace construction_test;
+  using err_counted = result::result<int, move_counter>;
+  const auto get_value = [](const move_counter &m) { return m.value; };
+  const auto by_value = [](move_counter m) { return m.value; };
+  const auto to_ok = [](const move_counter &m) {
+    return result::result<int, int>(result::ok_tag, m.value);
+  };
+  const auto to_err = [](const move_counter &m) {
+    return result::result<int, int>(result::err_tag, m.value);
+  };
+
+  SECTION("map on a const lvalue passes a reference") {
+    const counted_result r(result::ok_tag, 1);
+    move_counter::reset();
+    auto r2 = r.map(get_value);
+    REQUIRE(r2.ok_unchecked() == 1);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 0);
+  }
+  SECTION("map on an lvalue keeps the payload") {
+    counted_result r(result::ok_tag, 2);
+    move_counter::reset();
+    auto r2 = r.map([](move_counter &m) { return m.value++; });
+    REQUIRE(r2.ok_unchecked() == 2);
+    REQUIRE(r.ok_unchecked().value == 3);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 0);
+  }
+  SECTION("map on an rvalue moves the payload") {
+    counted_result r(result::ok_tag, 3);
+    move_counter::reset();
+    auto r2 = std::move(r).map(by_value);
+    REQUIRE(r2.ok_unchecked() == 3);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 1);
+  }
+  SECTION("map on an err lvalue copies the error once") {
+    const err_counted r(result::err_tag, 4);
+    move_counter::reset();
+    auto r2 = r.map([](int x) { return x * 2; });
+    REQUIRE(r2.err_unchecked().value == 4);
+    REQUIRE(move_counter::copies == 1);
+    REQUIRE(move_counter::moves == 0);
+  }
+  SECTION("map on an err rvalue moves the error once") {
+    err_counted r(result::err_tag, 5);
+    move_counter::reset();
+    auto r2 = std::move(r).map([](int x) { return x * 2; });
+    REQUIRE(r2.err_unchecked().value == 5);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 1);
+  }
+  SECTION("map_err per value category") {
+    const err_counted r(result::err_tag, 6);
+    move_counter::reset();
+    REQUIRE(r.map_err(get_value).err_unchecked() == 6);
+    REQUIRE(move_counter::copies == 0);
+    err_counted r2(result::err_tag, 7);
+    REQUIRE(std::move(r2).map_err(by_value).err_unchecked() == 7);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 1);
+  }
+  SECTION("map_or_else per value category") {
+    const counted_result r(result::ok_tag, 8);
+    move_counter::reset();
+    REQUIRE(r.map_or_else([](int) { return -1; }, get_value) == 8);
+    REQUIRE(move_counter::copies == 0);
+    counted_result r2(result::ok_tag, 9);
+    REQUIRE(std::move(r2).map_or_else([](int) { return -1; }, by_value) == 9);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 1);
+  }
+  SECTION("match per value category") {
+    const counted_result r(result::ok_tag, 14);
+    move_counter::reset();
+    REQUIRE(r.match(get_value, [](int) { return -1; }) == 14);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 0);
+    err_counted e(result::err_tag, 15);
+    REQUIRE(std::move(e).match([](int) { return -1; }, by_value) == 15);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 1);
+  }
+  SECTION("and_then / or_else on const lvalues") {
+    const counted_result r(result::ok_tag, 10);
+    const err_counted e(result::err_tag, 11);
+    move_counter::reset();
+    REQUIRE(r.and_then(to_ok).ok_unchecked() == 10);
+    REQUIRE(e.or_else(to_err).err_unchecked() == 11);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 0);
+  }
+  SECTION("inspect / inspect_err") {
+    counted_result r(result::ok_tag, 12);
+    const err_counted e(result::err_tag, 13);
+    int seen = 0;
+    move_counter::reset();
+    r.inspect([&seen](const move_counter &m) { seen += m.value; })
+        .inspect_err([&seen](int) { seen = -1; });
+    e.inspect([&seen](int) { seen = -1; })
+        .inspect_err([&seen](const move_counter &m) { seen += m.value; });
+    REQUIRE(seen == 25);
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 0);
+    auto r2 = std::move(r).inspect([](const move_counter &) {});
+    REQUIRE(move_counter::copies == 0);
+    REQUIRE(move_counter::moves == 1);
+  }
+}
+
+namespace reference_test {
+enum class lookup_error : std::uint8_t { not_found, invalid_key };
+
+struct big {
+  std::string name;
+  std::vector<int> values;
+};
+} // namespace reference_test
+
+TEST_CASE("result<T &, E>", "[result<T &, E>]") {
+  using namespace reference_test;
+  using ref_result = result::result<big &, std::string>;
+  using cref_result = result::result<const big &, lookup_error>;
+  using niche_result = result::result<big &, result::empty_tag_t>;
+
+  static_assert(sizeof(niche_result) == sizeof(void *));
+  static_assert(sizeof(cref_result) == sizeof(void *));
+  static_assert(sizeof(result::result<int &, lookup_error>) == sizeof(void *));
+
+  big a{"a", {1, 2}};
+  big b{"b", {3}};
+
+  SECTION("ok_unchecked returns the referenced object") {
+    ref_result r(result::ok_tag, a);
+    REQUIRE(r.is_ok());
+    REQUIRE(&r.ok_unchecked() == &a);
+    const ref_result &cr = r;
+    REQUIRE(&cr.ok_unchecked() == &a);
+    REQUIRE(&std::move(r).ok_unchecked() == &a);
+    r.ok_unchecked().name = "changed";
+    REQUIRE(a.name == "changed");
+  }
+  SECTION("assignment rebinds") {
+    ref_result r0(result::ok_tag, a);
+    ref_result r1(result::ok_tag, b);
+    r0 = r1;
+    REQUIRE(&r0.ok_unchecked() == &b);
+    REQUIRE(a.name == "a");
+    r0 = result::ok<big &>(a);
+    REQUIRE(&r0.ok_unchecked() == &a);
+    REQUIRE(b.name == "b");
+    r0 = result::err<std::string>("gone");
+    REQUIRE(r0.is_err());
+    REQUIRE(r0.err_unchecked() == "gone");
+    r0 = r1;
+    REQUIRE(&r0.ok_unchecked() == &b);
+  }
+  SECTION("pointer niche") {
+    niche_result r0(result::ok_tag, a);
+    niche_result r1(result::err_tag);
+    REQUIRE(r0.is_ok());
+    REQUIRE(r1.is_err());
+    REQUIRE(&r0.ok_unchecked() == &a);
+    swap(r0, r1);
+    REQUIRE(r0.is_err());
+    REQUIRE(&r1.ok_unchecked() == &a);
+
+    cref_result c0(result::err_tag, lookup_error::invalid_key);
+    cref_result c1(result::ok_tag, b);
+    REQUIRE(c0.is_err());
+    REQUIRE(c0.err_unchecked() == lookup_error::invalid_key);
+    REQUIRE(c1.ok_unchecked().name == "b");
+    c0 = c1;
+    REQUIRE(&c0.ok_unchecked() == &b);
+    c1 = result::err<lookup_error>(lookup_error::not_found);
+    REQUIRE(c1.err_unchecked() == lookup_error::not_found);
+  }
+  SECTION("monadic operations") {
+    cref_result r(result::ok_tag, a);
+    REQUIRE(r.map([](const big &x) { return x.values.size(); })
+                .ok_unchecked() == 2);
+    auto opt = std::move(r).ok();
+    REQUIRE(opt.has_value());
+    REQUIRE(&opt->get() == &a);
+    result::result<big &, int> converted = result::ok_ref(a);
+    REQUIRE(&converted.ok_unchecked() == &a);
+  }
+}
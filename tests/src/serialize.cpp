@@ -0,0 +1,182 @@
+#include "result/serialize.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+using result_type = result::result<std::int64_t, std::int32_t>;
+using packed_type = result::packed_result<std::int64_t, std::int32_t>;
+using writer_type = result::result_writer<std::int64_t, std::int32_t>;
+using array_type = result::mapped_result_array<std::int64_t, std::int32_t>;
+
+std::string temp_path(const std::string &name) {
+  return (std::filesystem::temp_directory_path() /
+          ("result_serialize_" + name + ".bin"))
+      .string();
+}
+
+std::vector<result_type> make_results(std::size_t n) {
+  std::vector<result_type> v;
+  v.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (i % 3 == 0) {
+      v.emplace_back(result::err_tag, static_cast<std::int32_t>(i));
+    } else {
+      v.emplace_back(result::ok_tag, static_cast<std::int64_t>(i) * 10);
+    }
+  }
+  return v;
+}
+} // namespace
+
+TEST_CASE("packed_result<T, E>::pack / unpack", "[packed_result]") {
+  result_type r0(result::ok_tag, 42);
+  result_type r1(result::err_tag, -7);
+  auto p0 = packed_type::pack(r0);
+  auto p1 = packed_type::pack(r1);
+  REQUIRE(p0.is_ok());
+  REQUIRE(p0.ok_unchecked() == 42);
+  REQUIRE(p1.is_err());
+  REQUIRE(p1.err_unchecked() == -7);
+  REQUIRE(p0.unpack() == r0);
+  REQUIRE(p1.unpack() == r1);
+}
+
+TEST_CASE("packed_result<T, E>::pack zeroes unused and padding bytes",
+          "[packed_result]") {
+  STATIC_REQUIRE(sizeof(packed_type) > sizeof(std::int64_t) + 1);
+  const auto bytes_of = [](const result_type &r) {
+    // Leave non zero bytes on the stack where pack may build its result.
+    volatile unsigned char dirty[256];
+    for (auto &b : dirty) {
+      b = 0xAA;
+    }
+    const auto p = packed_type::pack(r);
+    std::vector<unsigned char> bytes(sizeof(p));
+    std::memcpy(bytes.data(), &p, sizeof(p));
+    return bytes;
+  };
+  const auto ok_bytes = bytes_of(result_type(result::ok_tag, -1));
+  for (std::size_t i = sizeof(std::int64_t) + 1; i < ok_bytes.size(); ++i) {
+    REQUIRE(ok_bytes[i] == 0);
+  }
+  const auto err_bytes = bytes_of(result_type(result::err_tag, -1));
+  for (std::size_t i = sizeof(std::int32_t); i < err_bytes.size(); ++i) {
+    if (i != sizeof(std::int64_t)) {
+      REQUIRE(err_bytes[i] == 0);
+    }
+  }
+  REQUIRE(bytes_of(result_type(result::err_tag, 3)) ==
+          bytes_of(result_type(result::err_tag, 3)));
+}
+
+TEST_CASE("result_writer / mapped_result_array round trip",
+          "[mapped_result_array]") {
+  const auto path = temp_path("round_trip");
+  const auto input = make_results(1000);
+  {
+    auto w = writer_type::create(path.c_str(), 64);
+    REQUIRE(w.is_ok());
+    auto writer = std::move(w).unwrap();
+    REQUIRE(writer.write(input[0]).is_ok());
+    REQUIRE(writer.write(std::span(input).subspan(1)).is_ok());
+    REQUIRE(writer.size() == input.size());
+    REQUIRE(writer.close().is_ok());
+  }
+  auto m = array_type::open(path.c_str());
+  REQUIRE(m.is_ok());
+  auto array = std::move(m).unwrap();
+  REQUIRE(array.size() == input.size());
+  std::size_t i = 0;
+  for (const auto &p : array) {
+    REQUIRE(p.unpack() == input[i]);
+    ++i;
+  }
+  REQUIRE(array[3].is_err());
+  REQUIRE(array[3].err_unchecked() == 3);
+  REQUIRE(array[4].ok_unchecked() == 40);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("result_writer doesn't count records after a failed flush",
+          "[mapped_result_array]") {
+  const auto path = temp_path("failed_flush");
+  const auto input = make_results(1000);
+  {
+    auto writer = writer_type::create(path.c_str(), 64).unwrap();
+    // Make the second batch fail halfway with EFBIG.
+    rlimit old_limit{};
+    REQUIRE(::getrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    rlimit limit = old_limit;
+    limit.rlim_cur = sizeof(result::serialized_header) +
+                     96 * sizeof(writer_type::record_type);
+    const auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    REQUIRE(::setrlimit(RLIMIT_FSIZE, &limit) == 0);
+    const auto s = writer.write(std::span(input));
+    ::setrlimit(RLIMIT_FSIZE, &old_limit);
+    std::signal(SIGXFSZ, old_handler);
+
+    REQUIRE(s.is_err());
+    REQUIRE(s.err_unchecked().code == result::serialize_errc::write);
+    REQUIRE(s.err_unchecked().sys_errno == EFBIG);
+    REQUIRE(writer.size() == 64);
+    REQUIRE(writer.write(input[0]) == s);
+    REQUIRE(writer.flush() == s);
+    REQUIRE(writer.close() == s);
+  }
+  auto array = array_type::open(path.c_str());
+  REQUIRE(array.is_ok());
+  REQUIRE(array.ok_unchecked().size() == 0);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped_result_array header validation", "[mapped_result_array]") {
+  const auto path = temp_path("validation");
+  SECTION("missing file") {
+    std::filesystem::remove(path);
+    auto m = array_type::open(path.c_str());
+    REQUIRE(m.is_err());
+    REQUIRE(m.err_unchecked().code == result::serialize_errc::open);
+  }
+  SECTION("bad magic") {
+    std::ofstream(path, std::ios::binary) << std::string(128, 'x');
+    auto m = array_type::open(path.c_str());
+    REQUIRE(m.is_err());
+    REQUIRE(m.err_unchecked().code == result::serialize_errc::bad_magic);
+  }
+  SECTION("layout mismatch") {
+    {
+      auto writer =
+          result::result_writer<std::int32_t, std::int32_t>::create(
+              path.c_str())
+              .unwrap();
+      REQUIRE(writer.write(result::result<std::int32_t, std::int32_t>(
+                                   result::ok_tag, 1))
+                  .is_ok());
+    }
+    auto m = array_type::open(path.c_str());
+    REQUIRE(m.is_err());
+    REQUIRE(m.err_unchecked().code == result::serialize_errc::layout);
+  }
+  SECTION("truncated") {
+    {
+      const auto input = make_results(10);
+      auto writer = writer_type::create(path.c_str()).unwrap();
+      REQUIRE(writer.write(input).is_ok());
+    }
+    std::filesystem::resize_file(
+        path, sizeof(result::serialized_header) + 5 * sizeof(packed_type));
+    auto m = array_type::open(path.c_str());
+    REQUIRE(m.is_err());
+    REQUIRE(m.err_unchecked().code == result::serialize_errc::truncated);
+  }
+  std::filesystem::remove(path);
+}
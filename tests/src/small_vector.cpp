@@ -0,0 +1,116 @@
+#include "result/small_vector.hpp"
+#include "result_test/allocation.hpp"
+#include "result_test/tracked.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <utility>
+
+namespace small_vector_test {
+using element = result_test::tracked<std::string, struct element_tag>;
+using vector = result::small_vector<element, 2>;
+
+static_assert(std::is_nothrow_move_constructible_v<vector>);
+static_assert(!result::is_trivially_relocatable_v<vector>);
+} // namespace small_vector_test
+
+using namespace small_vector_test;
+
+TEST_CASE("small_vector stores its first elements inline", "[small_vector]") {
+  result_test::allocation_scope scope;
+  result::small_vector<int, 4> v;
+  for (int i = 0; i < 4; ++i) {
+    v.push_back(i);
+  }
+  const auto allocations = scope.allocations();
+
+  REQUIRE(allocations == 0);
+  REQUIRE(v.stored_inline());
+  REQUIRE(v.size() == 4);
+  REQUIRE(v.capacity() == 4);
+  REQUIRE(v.back() == 3);
+
+  v.push_back(4);
+  REQUIRE_FALSE(v.stored_inline());
+  REQUIRE(v.capacity() == 8);
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(v[i] == i);
+  }
+}
+
+TEST_CASE("small_vector growth relocates elements", "[small_vector]") {
+  vector v;
+  v.emplace_back("a");
+  v.emplace_back("b");
+  element::reset();
+
+  SECTION("growing moves each element once") {
+    v.emplace_back("c");
+    REQUIRE(element::counts().moves() == 2);
+    REQUIRE(element::counts().copies() == 0);
+    REQUIRE(element::counts().alive() == 1);
+  }
+  SECTION("an element of the vector can be appended to it") {
+    v.push_back(v.front());
+    REQUIRE(v.size() == 3);
+    REQUIRE(v[2].value() == "a");
+  }
+}
+
+TEST_CASE("small_vector copy and move", "[small_vector]") {
+  vector inline_v;
+  inline_v.emplace_back("a");
+  vector heap_v;
+  for (const char *s : {"a", "b", "c"}) {
+    heap_v.emplace_back(s);
+  }
+
+  SECTION("copy") {
+    vector a = inline_v;
+    vector b = heap_v;
+    REQUIRE(a == inline_v);
+    REQUIRE(b == heap_v);
+    a = heap_v;
+    REQUIRE(a == heap_v);
+    b = inline_v;
+    REQUIRE(b == inline_v);
+  }
+  SECTION("move of a heap buffer doesn't touch the elements") {
+    element::reset();
+    vector moved = std::move(heap_v);
+    REQUIRE(element::counts().moves() == 0);
+    REQUIRE(moved.size() == 3);
+    REQUIRE(heap_v.empty());
+    REQUIRE(heap_v.stored_inline());
+  }
+  SECTION("move of inline elements relocates them") {
+    element::reset();
+    vector moved = std::move(inline_v);
+    REQUIRE(element::counts().moves() == 1);
+    REQUIRE(element::counts().alive() == 0);
+    REQUIRE(moved.front().value() == "a");
+    REQUIRE(inline_v.empty());
+  }
+  SECTION("move assignment") {
+    heap_v = std::move(inline_v);
+    REQUIRE(heap_v.size() == 1);
+    REQUIRE(heap_v.stored_inline());
+  }
+}
+
+TEST_CASE("small_vector pop_back, clear and reserve", "[small_vector]") {
+  element::reset();
+  {
+    vector v;
+    v.reserve(8);
+    REQUIRE_FALSE(v.stored_inline());
+    v.emplace_back("a");
+    v.emplace_back("b");
+    v.pop_back();
+    REQUIRE(v.size() == 1);
+    v.clear();
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() == 8);
+    v.emplace_back("c");
+  }
+  REQUIRE(element::counts().alive() == 0);
+}
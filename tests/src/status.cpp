@@ -0,0 +1,136 @@
+#include "result/status.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace status_test {
+class custom_category final : public std::error_category {
+public:
+  const char *name() const noexcept override { return "custom"; }
+  std::string message(int code) const override {
+    return "custom " + std::to_string(code);
+  }
+};
+
+const custom_category &custom() {
+  static const custom_category category;
+  return category;
+}
+
+static_assert(sizeof(result::status) == 16);
+static_assert(std::is_trivially_copyable_v<result::status>);
+
+// Small trivially copyable values share the 16 bytes of the status.
+static_assert(sizeof(result::result<int, result::status>) == 16);
+static_assert(sizeof(result::result<void *, result::status>) == 16);
+static_assert(
+    sizeof(result::result<result::empty_tag_t, result::status>) == 16);
+static_assert(
+    std::is_trivially_copyable_v<result::result<int, result::status>>);
+
+constexpr result::status invalid = std::errc::invalid_argument;
+static_assert(invalid.code() == EINVAL);
+static_assert(&invalid.domain() == &result::generic_domain);
+static_assert(invalid == result::status::from_errno(EINVAL));
+static_assert(invalid == std::errc::invalid_argument);
+} // namespace status_test
+
+using namespace status_test;
+
+TEST_CASE("status from errno and std::errc", "[status]") {
+  errno = ENOENT;
+  const auto s = result::status::last_errno();
+  REQUIRE(s.code() == ENOENT);
+  REQUIRE(s == std::errc::no_such_file_or_directory);
+  REQUIRE(s.domain().name() == "generic");
+  REQUIRE(s.message() == std::generic_category().message(ENOENT));
+  REQUIRE(s.to_error_code() == std::errc::no_such_file_or_directory);
+  REQUIRE_FALSE(s == result::status(ENOENT, result::system_domain));
+}
+
+TEST_CASE("status from std::error_code", "[status]") {
+  const result::status generic = std::make_error_code(std::errc::timed_out);
+  REQUIRE(&generic.domain() == &result::generic_domain);
+  REQUIRE(generic == std::errc::timed_out);
+
+  const result::status system =
+      std::error_code(EACCES, std::system_category());
+  REQUIRE(&system.domain() == &result::system_domain);
+  REQUIRE(system.to_error_code() ==
+          std::error_code(EACCES, std::system_category()));
+
+  const std::error_code code(42, custom());
+  const result::status converted = code;
+  REQUIRE(converted.code() == 42);
+  REQUIRE(converted.message() == "custom 42");
+  REQUIRE(converted.to_error_code() == code);
+  REQUIRE(&result::status(std::error_code(7, custom())).domain() ==
+          &converted.domain());
+}
+
+TEST_CASE("status from more categories than static domains", "[status]") {
+  // Domains stay bound to their category, which must outlive them.
+  static const std::array<custom_category, 40> categories;
+  std::vector<const result::status_domain *> domains;
+  for (int i = 0; i < 40; ++i) {
+    const result::status s = std::error_code(i, categories[i]);
+    REQUIRE(s.to_error_code() == std::error_code(i, categories[i]));
+    domains.push_back(&s.domain());
+  }
+  for (int i = 0; i < 40; ++i) {
+    const result::status s = std::error_code(1, categories[i]);
+    REQUIRE(&s.domain() == domains[i]);
+    REQUIRE(s.message() == "custom 1");
+    for (int j = 0; j < i; ++j) {
+      REQUIRE(domains[j] != domains[i]);
+    }
+  }
+}
+
+TEST_CASE("result<T, status>", "[status]") {
+  using int_result = result::result<int, result::status>;
+  int_result r = result::ok(5);
+  REQUIRE(r.is_ok());
+  REQUIRE(r.ok_unchecked() == 5);
+
+  r = result::err(result::status(std::errc::io_error));
+  REQUIRE(r.is_err());
+  REQUIRE(r.err_unchecked() == std::errc::io_error);
+
+  int_result zero(result::ok_tag, 0);
+  REQUIRE(zero.is_ok());
+  REQUIRE(zero.ok_unchecked() == 0);
+
+  swap(r, zero);
+  REQUIRE(r.is_ok());
+  REQUIRE(zero.is_err());
+
+  const auto doubled = r.map([](int v) { return v * 2; });
+  REQUIRE(doubled.ok_unchecked() == 0);
+}
+
+TEST_CASE("map_err to status", "[status]") {
+  result::result<int, std::error_code> r(
+      result::err_tag, std::make_error_code(std::errc::broken_pipe));
+  const result::result<int, result::status> s = r.map_err(result::to_status);
+  REQUIRE(s.err_unchecked() == std::errc::broken_pipe);
+
+  constexpr auto busy = std::errc::device_or_resource_busy;
+  result::result<int, std::errc> e(result::err_tag, busy);
+  REQUIRE(e.map_err(result::to_status).err_unchecked() == busy);
+}
+
+TEST_CASE("hash status", "[status]") {
+  using int_result = result::result<int, result::status>;
+  constexpr auto busy = std::errc::device_or_resource_busy;
+  std::hash<int_result> hash;
+  const int_result a(result::err_tag, busy);
+  const int_result b(result::err_tag, EBUSY, result::system_domain);
+  const int_result c(result::err_tag, busy);
+  REQUIRE(hash(a) == hash(c));
+  REQUIRE(hash(a) != hash(b));
+}
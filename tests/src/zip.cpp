@@ -0,0 +1,109 @@
+#include "result/zip.hpp"
+#include "result_test/tracked.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace zip_test {
+using value = result_test::tracked<std::string, struct value_tag>;
+using value_result = result::result<value, int>;
+
+enum class parse_error { empty };
+enum class range_error { negative };
+
+value_result ok(const char *s) { return value_result(result::ok_tag, s); }
+
+constexpr auto constexpr_zip() {
+  return result::zip(result::result<int, int>(result::ok_tag, 1),
+                     result::result<char, int>(result::ok_tag, 'a'));
+}
+
+static_assert(constexpr_zip().ok_unchecked() == std::tuple(1, 'a'));
+static_assert(
+    std::is_same_v<decltype(result::zip(
+                       std::declval<result::result<int, parse_error>>(),
+                       std::declval<result::result<int, range_error>>(),
+                       std::declval<result::result<int, parse_error>>())),
+                   result::result<std::tuple<int, int, int>,
+                                  result::error_set<parse_error, range_error>>>);
+} // namespace zip_test
+
+using namespace zip_test;
+
+TEST_CASE("zip", "[zip]") {
+  SECTION("moves each rvalue once") {
+    auto a = ok("a");
+    auto b = ok("b");
+    auto c = ok("c");
+    value::reset();
+    auto r = result::zip(std::move(a), std::move(b), std::move(c));
+    REQUIRE(value::counts().moves() == 3);
+    REQUIRE(value::counts().copies() == 0);
+    REQUIRE(std::get<2>(r.ok_unchecked()).value() == "c");
+  }
+  SECTION("copies each lvalue once") {
+    const auto a = ok("a");
+    auto b = ok("b");
+    value::reset();
+    auto r = result::zip(a, b);
+    REQUIRE(value::counts().copies() == 2);
+    REQUIRE(value::counts().moves() == 0);
+    REQUIRE(b.ok_unchecked().value() == "b");
+  }
+  SECTION("returns the first error without touching the values") {
+    value::reset();
+    auto r = result::zip(ok("a"), value_result(result::err_tag, 2),
+                         value_result(result::err_tag, 3));
+    REQUIRE(r.err_unchecked() == 2);
+    REQUIRE(value::counts().moves() == 0);
+    REQUIRE(value::counts().copies() == 0);
+  }
+  SECTION("reference payloads") {
+    int x = 1;
+    auto r = result::zip(result::result<int &, int>(result::ok_tag, x),
+                         result::result<int, int>(result::ok_tag, 2));
+    std::get<0>(r.ok_unchecked()) = 5;
+    REQUIRE(x == 5);
+  }
+  SECTION("different error types widen") {
+    auto r = result::zip(result::result<int, parse_error>(result::ok_tag, 1),
+                         result::result<int, range_error>(
+                             result::err_tag, range_error::negative));
+    REQUIRE(r.err_unchecked().holds<range_error>());
+  }
+}
+
+TEST_CASE("apply", "[zip]") {
+  SECTION("passes the values straight to fun") {
+    auto a = ok("a");
+    auto b = ok("b");
+    value::reset();
+    auto r = result::apply(
+        [](const value &x, const value &y) { return x.value() + y.value(); },
+        a, b);
+    REQUIRE(r.ok_unchecked() == "ab");
+    REQUIRE(value::counts().moves() == 0);
+    REQUIRE(value::counts().copies() == 0);
+  }
+  SECTION("parameters taken by value cost one move") {
+    value::reset();
+    auto r = result::apply(
+        [](value x, value y) { return x.value().size() + y.value().size(); },
+        ok("a"), ok("bc"));
+    REQUIRE(r.ok_unchecked() == 3);
+    REQUIRE(value::counts().moves() == 2);
+    REQUIRE(value::counts().copies() == 0);
+  }
+  SECTION("doesn't call fun on error") {
+    bool called = false;
+    auto r = result::apply(
+        [&called](const value &, const value &) {
+          called = true;
+          return 0;
+        },
+        value_result(result::err_tag, 4), ok("b"));
+    REQUIRE_FALSE(called);
+    REQUIRE(r.err_unchecked() == 4);
+  }
+}
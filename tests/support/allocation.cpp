@@ -0,0 +1,114 @@
+#include "result_test/allocation.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Replacements of the global allocation functions that count every call
+// per thread. Only the test executables link this file.
+
+namespace {
+thread_local result_test::allocation_counts counts;
+
+void *allocate(std::size_t size) {
+  ++counts.allocations;
+  counts.bytes += size;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocate(std::size_t size, std::align_val_t align) {
+  ++counts.allocations;
+  counts.bytes += size;
+  const auto a = static_cast<std::size_t>(align);
+  // aligned_alloc requires the size to be a multiple of the alignment.
+  return std::aligned_alloc(a, (size + a - 1) / a * a);
+}
+
+void deallocate(void *ptr) noexcept {
+  if (ptr != nullptr) {
+    ++counts.deallocations;
+    std::free(ptr);
+  }
+}
+} // namespace
+
+namespace result_test {
+allocation_counts thread_allocation_counts() noexcept { return counts; }
+} // namespace result_test
+
+void *operator new(std::size_t size) {
+  if (void *ptr = allocate(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  if (void *ptr = allocate(size, align)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return operator new(size, align);
+}
+
+void *operator new(std::size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return allocate(size, align);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return allocate(size, align);
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr, std::size_t) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}